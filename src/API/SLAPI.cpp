@@ -370,6 +370,18 @@ std::vector<unsigned int> SURELOG::SLcollectAll(
   return fC->sl_collect_all(parent, vtypes, vstops, first);
 }
 
+std::vector<std::vector<unsigned int>> SURELOG::SLcollectAllBatch(
+    FileContent* fC, std::vector<unsigned int> parents,
+    std::vector<unsigned int> types, std::vector<unsigned int> stopPoints,
+    bool first) {
+  if (!fC) return {};
+  std::vector<VObjectType> vtypes;
+  for (auto type : types) vtypes.push_back((VObjectType)type);
+  std::vector<VObjectType> vstops;
+  for (auto type : stopPoints) vstops.push_back((VObjectType)type);
+  return fC->sl_collect_all(parents, vtypes, vstops, first);
+}
+
 unsigned int SURELOG::SLgetnModuleDefinition(Design* design) {
   if (!design) return 0;
   return design->getModuleDefinitions().size();
@@ -40,6 +40,7 @@ class DesignComponent;
 class ErrorContainer;
 
 typedef std::vector<unsigned int> UIntVector;
+typedef std::vector<std::vector<unsigned int>> UIntVectorVector;
 
 /* Error DB API  */
 void SLsetWaiver(const char* messageId, const char* fileName = 0,
@@ -133,6 +134,11 @@ UIntVector SLcollectAll(FileContent* fC, NodeId parent, UIntVector types,
                         UIntVector stopPoints, bool first);
 // Recursively search for all items of types
 // and stops at types stopPoints
+
+UIntVectorVector SLcollectAllBatch(FileContent* fC, UIntVector parents,
+                                   UIntVector types, UIntVector stopPoints,
+                                   bool first);
+// Same search for several parents, one result per parent
 /* Design API */
 unsigned int SLgetnModuleDefinition(Design* design);
 
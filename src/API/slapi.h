@@ -92,6 +92,10 @@ std::vector<std::string> slapi_scripts = {
 "    return slapi.SLcollectAll(*args)\n"
 "SLcollectAll = slapi.SLcollectAll\n"
 "\n"
+"def SLcollectAllBatch(fC, parents, types, stopPoints, first):\n"
+"    return slapi.SLcollectAllBatch(fC, parents, types, stopPoints, first)\n"
+"SLcollectAllBatch = slapi.SLcollectAllBatch\n"
+"\n"
 "def SLgetnModuleDefinition(design):\n"
 "    return slapi.SLgetnModuleDefinition(design)\n"
 "SLgetnModuleDefinition = slapi.SLgetnModuleDefinition\n"
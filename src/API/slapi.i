@@ -5,6 +5,7 @@
 %include "std_vector.i"
 
 %template (UIntVector) std::vector<unsigned int>;
+%template (UIntVectorVector) std::vector<std::vector<unsigned int>>;
         
 %include "SLAPI.h"
 
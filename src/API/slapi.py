@@ -365,6 +365,10 @@ def SLcollectAll(*args):
     return _slapi.SLcollectAll(*args)
 SLcollectAll = _slapi.SLcollectAll
 
+def SLcollectAllBatch(fC, parents, types, stopPoints, first):
+    return _slapi.SLcollectAllBatch(fC, parents, types, stopPoints, first)
+SLcollectAllBatch = _slapi.SLcollectAllBatch
+
 def SLgetnModuleDefinition(design):
     return _slapi.SLgetnModuleDefinition(design)
 SLgetnModuleDefinition = _slapi.SLgetnModuleDefinition
@@ -26,11 +26,15 @@
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <iostream>
+#include <unordered_map>
 #include "SourceCompile/SymbolTable.h"
 #include "ErrorReporting/ErrorContainer.h"
 #include "Design/FileContent.h"
 #include "Cache/Cache.h"
 #include "CommandLine/CommandLineParser.h"
+#include "Library/Library.h"
+#include "Package/Precompiled.h"
+#include "Utils/StringUtils.h"
 #include "flatbuffers/util.h"
 
 using namespace SURELOG;
@@ -39,6 +43,23 @@ std::string ExecTimeStamp = std::string(__DATE__) + "-" + __TIME__;
 
 std::string Cache::getExecutableTimeStamp() { return ExecTimeStamp; }
 
+std::string Cache::getCacheDirName(CommandLineParser* clp,
+                                   SymbolTable* symbols, Library* lib,
+                                   std::string svFileName,
+                                   bool& isPrecompiled) {
+  Precompiled* prec = Precompiled::getSingleton();
+  SymbolId cacheDirId = clp->getCacheDir();
+  std::string root = svFileName;
+  root = StringUtils::getRootFileName(root);
+  if (prec->isFilePrecompiled(root)) {
+    cacheDirId = clp->getPrecompiledDir();
+    isPrecompiled = true;
+  }
+  std::string cacheDirName = symbols->getSymbol(cacheDirId);
+  std::string libName = lib->getName() + "/";
+  return cacheDirName + libName;
+}
+
 time_t Cache::get_mtime(const char* path) {
   struct stat statbuf;
   if (stat(path, &statbuf) == -1) {
@@ -124,10 +145,8 @@ bool Cache::saveFlatbuffers(flatbuffers::FlatBufferBuilder& builder,
   return status;
 }
 
-std::pair<flatbuffers::Offset<
-              flatbuffers::Vector<flatbuffers::Offset<SURELOG::CACHE::Error>>>,
-          flatbuffers::Offset<
-              flatbuffers::Vector<flatbuffers::Offset<flatbuffers::String>>>>
+flatbuffers::Offset<
+    flatbuffers::Vector<flatbuffers::Offset<SURELOG::CACHE::Error>>>
 Cache::cacheErrors(flatbuffers::FlatBufferBuilder& builder,
                    SymbolTable& canonicalSymbols,
                    ErrorContainer* errorContainer, SymbolTable* symbols,
@@ -165,15 +184,14 @@ Cache::cacheErrors(flatbuffers::FlatBufferBuilder& builder,
     }
   }
 
-  /* Cache all the symbols */
-  for (auto itr = symbols->getSymbols().begin();
-       itr != symbols->getSymbols().end(); itr++) {
-    canonicalSymbols.registerSymbol(*itr);
-  }
+  return builder.CreateVector(error_vec);
+}
 
-  auto symbolVec = builder.CreateVectorOfStrings(canonicalSymbols.getSymbols());
-  auto errvec = builder.CreateVector(error_vec);
-  return std::make_pair(errvec, symbolVec);
+flatbuffers::Offset<
+    flatbuffers::Vector<flatbuffers::Offset<flatbuffers::String>>>
+Cache::cacheSymbols(flatbuffers::FlatBufferBuilder& builder,
+                    SymbolTable& canonicalSymbols) {
+  return builder.CreateVectorOfStrings(canonicalSymbols.getSymbols());
 }
 
 void Cache::restoreErrors(
@@ -205,104 +223,190 @@ void Cache::restoreErrors(
   }
 }
 
-std::vector<CACHE::VObject> 
-        Cache::cacheVObjects(FileContent* fcontent, SymbolTable& canonicalSymbols, 
-               SymbolTable& fileTable, SymbolId fileId) {
-  
-   /* Cache the design objects */
-  // std::vector<flatbuffers::Offset<PARSECACHE::VObject>> object_vec;
-  std::vector<CACHE::VObject> object_vec;
-  if (!fcontent)
-    return object_vec;
-  for (size_t i = 0; i < fcontent->getVObjects().size(); i++) {
-    VObject& object = fcontent->getVObjects()[i];
-
-    // Lets compress this struct into 20 and 16 bits fields:
-    //  object_vec.push_back(PARSECACHE::CreateVObject(builder,
-    //                                              canonicalSymbols.getId(m_parse->getCompileSourceFile()->getSymbolTable()->getSymbol(object.m_name)),
-    //                                              object.m_uniqueId,
-    //                                              object.m_type,
-    //                                              object.m_line,
-    //                                              object.m_parent,
-    //                                               object.m_definition,
-    //                                               object.m_child,
-    //                                               object.m_sibling));
-
-    uint64_t field1 = 0;
-    uint64_t field2 = 0;
-    uint64_t field3 = 0;
-    SymbolId name = canonicalSymbols.getId(fileTable.getSymbol(object.m_name));
-    field1 |= (name);  // 20 Bits => Filled 20 Bits (Of 64)
-    field1 |= (((unsigned long)object.m_type)
-               << (20));  // 12 Bits => Filled 32 Bits (Of 64)
-    // UNUSED: field1 |= (((unsigned long) object.m_line)   << (20 + 12)); // 16
-    // Bits => Filled 48 Bits (Of 64)
-    field1 |=
-        ((uint64_t)object.m_parent
-         << (20 + 12 + 16));  // 16 Bits => Filled 64 Bits (Of 64) , Word Full
-    field2 |= (object.m_parent >> (16));  //  4 Bits => Filled  4 Bits (Of 64)
-    field2 |=
-        (object.m_definition << (4));  // 20 Bits => Filled 24 Bits (Of 64)
-    field2 |= (((uint64_t)object.m_child)
-               << (4 + 20));  // 20 Bits => Filled 44 Bits (Of 64)
-    field2 |=
-        (((uint64_t)object.m_sibling)
-         << (4 + 20 + 20));  // 20 Bits => Filled 64 Bits (Of 64) , Word Full
-    field3 |= object.m_fileId;
-    field3 |= (((uint64_t)object.m_line) << (32));
-    SURELOG::CACHE::VObject vostruct(field1, field2, field3);
-    object_vec.push_back(vostruct);
+static void encodeVarint(std::vector<uint8_t>& buf, uint64_t value) {
+  while (value >= 0x80) {
+    buf.push_back((uint8_t)(value | 0x80));
+    value >>= 7;
+  }
+  buf.push_back((uint8_t)value);
+}
+
+static uint64_t decodeVarint(const uint8_t*& ptr, const uint8_t* end) {
+  uint64_t value = 0;
+  unsigned int shift = 0;
+  while (ptr < end) {
+    uint8_t byte = *ptr++;
+    value |= ((uint64_t)(byte & 0x7F)) << shift;
+    if (!(byte & 0x80)) break;
+    shift += 7;
+  }
+  return value;
+}
+
+static uint64_t zigzag(int64_t value) {
+  return (((uint64_t)value) << 1) ^ ((uint64_t)(value >> 63));
+}
+
+static int64_t unzigzag(uint64_t value) {
+  return ((int64_t)(value >> 1)) ^ -((int64_t)(value & 1));
+}
+
+static void encodeLink(std::vector<uint8_t>& buf, NodeId link, size_t index) {
+  if (link == 0)
+    encodeVarint(buf, 0);
+  else
+    encodeVarint(buf, zigzag((int64_t)link - (int64_t)index) + 1);
+}
+
+static NodeId decodeLink(const uint8_t*& ptr, const uint8_t* end,
+                         size_t index) {
+  uint64_t value = decodeVarint(ptr, end);
+  if (value == 0) return 0;
+  return (NodeId)((int64_t)index + unzigzag(value - 1));
+}
+
+flatbuffers::Offset<CACHE::VObjectColumns> Cache::cacheCompactVObjects(
+    flatbuffers::FlatBufferBuilder& builder, FileContent* fcontent,
+    SymbolTable& canonicalSymbols, SymbolTable& fileTable, SymbolId fileId) {
+  std::vector<uint8_t> names, fileIds, types, lines, parents, definitions,
+      childs, siblings;
+  unsigned int count = 0;
+  if (fcontent) {
+    std::vector<VObject>& objects = fcontent->getVObjects();
+    count = objects.size();
+    // Translate each distinct file symbol only once
+    std::unordered_map<SymbolId, SymbolId> canonicalIds;
+    auto canonicalId = [&](SymbolId id) -> SymbolId {
+      std::unordered_map<SymbolId, SymbolId>::iterator itr =
+          canonicalIds.find(id);
+      if (itr != canonicalIds.end()) return (*itr).second;
+      SymbolId canonical =
+          canonicalSymbols.registerSymbol(fileTable.getSymbol(id));
+      canonicalIds.insert(std::make_pair(id, canonical));
+      return canonical;
+    };
+    SymbolId prevFileId = 0;
+    unsigned int prevLine = 0;
+    for (size_t i = 0; i < objects.size(); i++) {
+      VObject& object = objects[i];
+      encodeVarint(names, canonicalId(object.m_name));
+      SymbolId objFileId = canonicalId(fcontent->getFileId(i));
+      encodeVarint(fileIds, zigzag((int64_t)objFileId - (int64_t)prevFileId));
+      prevFileId = objFileId;
+      encodeVarint(types, object.m_type);
+      encodeVarint(lines, zigzag((int64_t)object.m_line - (int64_t)prevLine));
+      prevLine = object.m_line;
+      encodeLink(parents, object.m_parent, i);
+      encodeVarint(definitions, object.m_definition);
+      encodeLink(childs, object.m_child, i);
+      encodeLink(siblings, object.m_sibling, i);
+    }
+  }
+  return CACHE::CreateVObjectColumns(
+      builder, count, builder.CreateVector(names),
+      builder.CreateVector(fileIds), builder.CreateVector(types),
+      builder.CreateVector(lines), builder.CreateVector(parents),
+      builder.CreateVector(definitions), builder.CreateVector(childs),
+      builder.CreateVector(siblings));
+}
+
+/* Reads one varint, false when the column ends inside it or it overflows */
+static bool readVarint(const uint8_t*& ptr, const uint8_t* end,
+                       uint64_t& value) {
+  value = 0;
+  for (unsigned int shift = 0; shift < 64; shift += 7) {
+    if (ptr == end) return false;
+    uint8_t byte = *ptr++;
+    value |= ((uint64_t)(byte & 0x7F)) << shift;
+    if (!(byte & 0x80)) return true;
   }
-  // std::cout << "SAVE: " << cacheFileName << " "
-  //          << fileTable.getSymbol(fileId)
-  //          << " NB: " <<   fcontent->getVObjects().size()
-  //         << std::endl;
+  return false;
+}
 
-  return object_vec;
+/* The column holds exactly count varints, links are checked against the
+   node count */
+static bool checkColumn(const flatbuffers::Vector<uint8_t>* column,
+                        unsigned int count, bool links) {
+  if (column == NULL) return false;
+  const uint8_t* ptr = column->data();
+  const uint8_t* end = ptr + column->size();
+  for (unsigned int i = 0; i < count; i++) {
+    uint64_t value;
+    if (!readVarint(ptr, end, value)) return false;
+    if (links && value) {
+      int64_t link = (int64_t)i + unzigzag(value - 1);
+      if (link < 0 || link >= (int64_t)count) return false;
+    }
+  }
+  return ptr == end;
 }
-  
-void Cache::restoreVObjects(const flatbuffers::Vector<const SURELOG::CACHE::VObject *> * objects,
-        SymbolTable& canonicalSymbols, 
-        SymbolTable& fileTable, 
-        SymbolId fileId, 
-        FileContent* fileContent) {
-   /* Restore design objects */
-  for (unsigned int i = 0; i < objects->Length(); i++) {
-    auto objectc = objects->Get(i);
-
-    // VObject object
-    // (m_parse->getCompileSourceFile()->getSymbolTable()->registerSymbol(canonicalSymbols.getSymbol(objectc->m_name())),
-    //                (VObjectType) objectc->m_type(), objectc->m_uniqueId(),
-    //                objectc->m_line(), objectc->m_parent(),
-    //                objectc->m_definition(),
-    //               objectc->m_child(),  objectc->m_sibling());
-
-    unsigned long field1 = objectc->m_field1();
-    unsigned long field2 = objectc->m_field2();
-    unsigned long field3 = objectc->m_field3();
-    // Decode compression done when saving cache (see below)
-    SymbolId name = (field1 & 0x00000000000FFFFF);
-    unsigned short type = (field1 & 0x00000000FFF00000) >> (20);
-    // UNUSED: unsigned int   line  = (field1 & 0x0000FFFF00000000) >> (20 +
-    // 12);
-    NodeId parent = (field1 & 0xFFFF000000000000) >> (20 + 12 + 16);
-    parent |= (field2 & 0x000000000000000F) << (16);
-    NodeId definition = (field2 & 0x0000000000FFFFF0) >> (4);
-    NodeId child = (field2 & 0x00000FFFFF000000) >> (4 + 20);
-    NodeId sibling = (field2 & 0xFFFFF00000000000) >> (4 + 20 + 20);
-    SymbolId fileId = (field3 & 0x00000000FFFFFFFF);
-    unsigned int line = (field3 & 0xFFFFFFFF00000000) >> (32);
-    VObject object(
-        fileTable.registerSymbol(
-            canonicalSymbols.getSymbol(name)),
-        fileTable.registerSymbol(
-            canonicalSymbols.getSymbol(fileId)),
-        (VObjectType)type, line, parent, definition, child, sibling);
-
-    fileContent->getVObjects().push_back(object);
+
+bool Cache::checkCompactVObjects(const CACHE::VObjectColumns* objects) {
+  if (objects == NULL) return false;
+  unsigned int count = objects->m_count();
+  return checkColumn(objects->m_names(), count, false) &&
+         checkColumn(objects->m_fileIds(), count, false) &&
+         checkColumn(objects->m_types(), count, false) &&
+         checkColumn(objects->m_lines(), count, false) &&
+         checkColumn(objects->m_parents(), count, true) &&
+         checkColumn(objects->m_definitions(), count, false) &&
+         checkColumn(objects->m_childs(), count, true) &&
+         checkColumn(objects->m_siblings(), count, true);
+}
+
+void Cache::restoreCompactVObjects(const CACHE::VObjectColumns* objects,
+                                   SymbolTable& canonicalSymbols,
+                                   SymbolTable& fileTable, SymbolId fileId,
+                                   FileContent* fileContent) {
+  unsigned int count = objects->m_count();
+  std::vector<VObject>& vobjects = fileContent->getVObjects();
+  vobjects.reserve(vobjects.size() + count);
+  // Register each distinct cache symbol only once
+  std::vector<SymbolId> fileIds(canonicalSymbols.size(),
+                                canonicalSymbols.getBadId());
+  std::vector<bool> translated(fileIds.size(), false);
+  auto fileSymbolId = [&](SymbolId id) -> SymbolId {
+    if (id >= fileIds.size()) return fileTable.getBadId();
+    if (!translated[id]) {
+      fileIds[id] = fileTable.registerSymbol(canonicalSymbols.getSymbol(id));
+      translated[id] = true;
+    }
+    return fileIds[id];
+  };
+  const uint8_t* names = objects->m_names()->data();
+  const uint8_t* namesEnd = names + objects->m_names()->size();
+  const uint8_t* files = objects->m_fileIds()->data();
+  const uint8_t* filesEnd = files + objects->m_fileIds()->size();
+  const uint8_t* types = objects->m_types()->data();
+  const uint8_t* typesEnd = types + objects->m_types()->size();
+  const uint8_t* lines = objects->m_lines()->data();
+  const uint8_t* linesEnd = lines + objects->m_lines()->size();
+  const uint8_t* parents = objects->m_parents()->data();
+  const uint8_t* parentsEnd = parents + objects->m_parents()->size();
+  const uint8_t* definitions = objects->m_definitions()->data();
+  const uint8_t* definitionsEnd =
+      definitions + objects->m_definitions()->size();
+  const uint8_t* childs = objects->m_childs()->data();
+  const uint8_t* childsEnd = childs + objects->m_childs()->size();
+  const uint8_t* siblings = objects->m_siblings()->data();
+  const uint8_t* siblingsEnd = siblings + objects->m_siblings()->size();
+  int64_t objFileId = 0;
+  int64_t line = 0;
+  for (size_t i = 0; i < count; i++) {
+    SymbolId name = decodeVarint(names, namesEnd);
+    objFileId += unzigzag(decodeVarint(files, filesEnd));
+    unsigned short type = decodeVarint(types, typesEnd);
+    line += unzigzag(decodeVarint(lines, linesEnd));
+    NodeId parent = decodeLink(parents, parentsEnd, i);
+    NodeId definition = decodeVarint(definitions, definitionsEnd);
+    NodeId child = decodeLink(childs, childsEnd, i);
+    NodeId sibling = decodeLink(siblings, siblingsEnd, i);
+    vobjects.push_back(VObject(
+        fileContent->getNameId(fileSymbolId(name)),
+        fileContent->getFileIndex(fileSymbolId(objFileId)),
+        (VObjectType)type, line, parent, definition, child, sibling));
   }
 }
-  
 
 Cache::Cache() {}
 
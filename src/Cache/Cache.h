@@ -30,11 +30,21 @@
 
 namespace SURELOG {
 
+class CommandLineParser;
+class Library;
+
 class Cache {
  public:
 
   Cache();
 
+  /* Cache directory of a source file (<cache dir>/<library>/), precompiled
+     packages are looked up in the precompiled directory */
+  static std::string getCacheDirName(CommandLineParser* clp,
+                                     SymbolTable* symbols, Library* lib,
+                                     std::string svFileName,
+                                     bool& isPrecompiled);
+
   Cache(const Cache& orig);
 
   virtual ~Cache();
@@ -56,14 +66,19 @@ class Cache {
       flatbuffers::FlatBufferBuilder& builder, std::string schemaVersion,
       std::string origFileName);
   
-  std::pair<flatbuffers::Offset<flatbuffers::Vector<
-            flatbuffers::Offset<SURELOG::CACHE::Error>>>,
-            flatbuffers::Offset<
-            flatbuffers::Vector<flatbuffers::Offset<flatbuffers::String>>>>
+  flatbuffers::Offset<
+      flatbuffers::Vector<flatbuffers::Offset<SURELOG::CACHE::Error>>>
   cacheErrors(flatbuffers::FlatBufferBuilder& builder,
               SymbolTable& canonicalSymbols, ErrorContainer* errorContainer,
               SymbolTable* symbols, SymbolId subjectId);
 
+  /* Only the symbols registered in the canonical table are cached, to be
+     called once everything else is cached */
+  flatbuffers::Offset<
+      flatbuffers::Vector<flatbuffers::Offset<flatbuffers::String>>>
+  cacheSymbols(flatbuffers::FlatBufferBuilder& builder,
+               SymbolTable& canonicalSymbols);
+
   void restoreErrors(
       const flatbuffers::Vector<flatbuffers::Offset<SURELOG::CACHE::Error>>*
           errorsBuf,
@@ -72,16 +87,18 @@ class Cache {
       SymbolTable& canonicalSymbols, ErrorContainer* errorContainer,
       SymbolTable* symbols);
   
-  std::vector<CACHE::VObject> 
-        cacheVObjects(FileContent* fcontent, SymbolTable& canonicalSymbols, 
-               SymbolTable& fileTable, SymbolId fileId);
-  
- void restoreVObjects(const flatbuffers::Vector<const SURELOG::CACHE::VObject*>* 
-        objects,
-        SymbolTable& canonicalSymbols, 
-        SymbolTable& fileTable, 
-        SymbolId fileId, 
-        FileContent* fileContent);
+  flatbuffers::Offset<SURELOG::CACHE::VObjectColumns> cacheCompactVObjects(
+      flatbuffers::FlatBufferBuilder& builder, FileContent* fcontent,
+      SymbolTable& canonicalSymbols, SymbolTable& fileTable, SymbolId fileId);
+
+  /* Checks the columns decode to m_count objects linked within the
+     file, before anything is restored from a possibly corrupt cache */
+  bool checkCompactVObjects(const SURELOG::CACHE::VObjectColumns* objects);
+
+  void restoreCompactVObjects(const SURELOG::CACHE::VObjectColumns* objects,
+                              SymbolTable& canonicalSymbols,
+                              SymbolTable& fileTable, SymbolId fileId,
+                              FileContent* fileContent);
   
 };
 
@@ -0,0 +1,77 @@
+/*
+ Copyright 2026 The Surelog contributors
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+/*
+ * File:   CachePrefetcher.cpp
+ *
+ * Created on October 19, 2026
+ */
+#include <fstream>
+#include "Cache/CachePrefetcher.h"
+
+using namespace SURELOG;
+
+CachePrefetcher::CachePrefetcher(unsigned int window)
+    : m_window(window), m_started(0), m_stop(false), m_thread(NULL) {}
+
+CachePrefetcher::~CachePrefetcher() { stop(); }
+
+void CachePrefetcher::start() {
+  if (m_window == 0 || m_jobs.empty() || m_thread) return;
+  m_thread = new std::thread([this] { run_(); });
+}
+
+void CachePrefetcher::jobStarted() {
+  if (m_thread == NULL) return;
+  std::unique_lock<std::mutex> lock(m_mutex);
+  m_started++;
+  lock.unlock();
+  m_condition.notify_one();
+}
+
+void CachePrefetcher::stop() {
+  if (m_thread == NULL) return;
+  std::unique_lock<std::mutex> lock(m_mutex);
+  m_stop = true;
+  lock.unlock();
+  m_condition.notify_one();
+  m_thread->join();
+  delete m_thread;
+  m_thread = NULL;
+}
+
+void CachePrefetcher::prefetchFile_(const std::string& fileName) {
+  std::ifstream ifs(fileName, std::ios::in | std::ios::binary);
+  if (!ifs.good()) return;
+  char buffer[64 * 1024];
+  while (ifs.read(buffer, sizeof(buffer)) || ifs.gcount()) {
+  }
+}
+
+void CachePrefetcher::run_() {
+  for (unsigned int i = 0; i < m_jobs.size(); i++) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    // Wait for the workers to catch up with the readahead window
+    m_condition.wait(lock, [&] { return m_stop || (i < m_started + m_window); });
+    if (m_stop) return;
+    // Jobs already picked up by a worker are not worth reading anymore
+    if (i < m_started) continue;
+    lock.unlock();
+    for (unsigned int j = 0; j < m_jobs[i].size(); j++) {
+      prefetchFile_(m_jobs[i][j]);
+    }
+  }
+}
@@ -0,0 +1,69 @@
+/*
+ Copyright 2026 The Surelog contributors
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+/*
+ * File:   CachePrefetcher.h
+ *
+ * Created on October 19, 2026
+ */
+
+#ifndef CACHEPREFETCHER_H
+#define CACHEPREFETCHER_H
+
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace SURELOG {
+
+/* Reads the source and cache files of the upcoming compile jobs on a
+   background thread, so the disk latency overlaps with the processing of the
+   earlier jobs. The files are only read (to warm the OS file cache), the
+   cache validation itself is still done by the job that restores it.
+   At most "window" jobs are read ahead of the last started job. */
+class CachePrefetcher {
+ public:
+  CachePrefetcher(unsigned int window);
+  virtual ~CachePrefetcher();
+
+  /* Jobs are added in the order they are going to be consumed */
+  void addJob(const std::vector<std::string>& fileNames) {
+    m_jobs.push_back(fileNames);
+  }
+  void start();
+  /* Called by the workers each time a job starts, moves the window */
+  void jobStarted();
+  void stop();
+
+ private:
+  CachePrefetcher(const CachePrefetcher& orig);
+  void run_();
+  void prefetchFile_(const std::string& fileName);
+
+  unsigned int m_window;
+  std::vector<std::vector<std::string>> m_jobs;
+  unsigned int m_started;
+  bool m_stop;
+  std::mutex m_mutex;
+  std::condition_variable m_condition;
+  std::thread* m_thread;
+};
+
+};  // namespace SURELOG
+
+#endif /* CACHEPREFETCHER_H */
@@ -46,37 +46,78 @@ PPCache::PPCache(const PPCache& orig) {}
 
 PPCache::~PPCache() {}
 
-static std::string FlbSchemaVersion = "1.0";
-
-std::string PPCache::getCacheFileName_(std::string svFileName) {
-  Precompiled* prec = Precompiled::getSingleton();
-  SymbolId cacheDirId =
-      m_pp->getCompileSourceFile()->getCommandLineParser()->getCacheDir();
+static std::string FlbSchemaVersion = "1.3";
 
+std::string PPCache::getCacheFileName_(std::string svFileName,
+                                      unsigned int variant) {
   if (svFileName == "") svFileName = m_pp->getFileName(LINE1);
-  std::string root = svFileName;
-  root = StringUtils::getRootFileName(root);
-  if (prec->isFilePrecompiled(root)) {
-    std::string packageRepDir = m_pp->getSymbol(m_pp->getCompileSourceFile()
-                                                    ->getCommandLineParser()
-                                                    ->getPrecompiledDir());
-    cacheDirId = m_pp->getCompileSourceFile()
-                     ->getCommandLineParser()
-                     ->getSymbolTable()
-                     ->registerSymbol(packageRepDir);
-    m_isPrecompiled = true;
-  }
-
-  std::string cacheDirName = m_pp->getSymbol(cacheDirId);
-
-  Library* lib = m_pp->getLibrary();
-  std::string libName = lib->getName() + "/";
+  std::string cacheDirName = getCacheDirName(
+      m_pp->getCompileSourceFile()->getCommandLineParser(),
+      m_pp->getCompileSourceFile()->getSymbolTable(), m_pp->getLibrary(),
+      svFileName, m_isPrecompiled);
   svFileName = StringUtils::getRootFileName(svFileName);
-  std::string cacheFileName = cacheDirName + libName + svFileName + ".slpp";
-  FileUtils::mkDir(std::string(cacheDirName + libName).c_str());
+  std::string variantExt;
+  if (variant) variantExt = "." + std::to_string(variant);
+  std::string cacheFileName = cacheDirName + svFileName + variantExt + ".slpp";
+  FileUtils::mkDir(cacheDirName.c_str());
   return cacheFileName;
 }
 
+std::string PPCache::findCacheVariant_(std::string svFileName) {
+  for (unsigned int variant = 0; variant < MaxVariants; variant++) {
+    std::string cacheFileName = getCacheFileName_(svFileName, variant);
+    if (checkCacheIsValid_(cacheFileName)) return cacheFileName;
+    // Precompiled packages only come in one flavor
+    if (m_isPrecompiled) break;
+  }
+  return "";
+}
+
+std::string PPCache::selectSaveVariant_() {
+  // Reuse the variant built with the same relevant defines, else a free
+  // slot, else evict the oldest variant
+  std::string oldestFileName;
+  time_t oldestTime = 0;
+  for (unsigned int variant = 0; variant < MaxVariants; variant++) {
+    std::string cacheFileName = getCacheFileName_("", variant);
+    if (m_isPrecompiled) return cacheFileName;
+    uint8_t* buffer_pointer = openFlatBuffers(cacheFileName);
+    if (buffer_pointer == NULL) return cacheFileName;
+    bool sameDefines = false;
+    if (MACROCACHE::PPCacheBufferHasIdentifier(buffer_pointer)) {
+      sameDefines = checkDefines_(MACROCACHE::GetPPCache(buffer_pointer));
+    }
+    delete[] buffer_pointer;
+    if (sameDefines) return cacheFileName;
+    time_t mtime = get_mtime(cacheFileName.c_str());
+    if (oldestFileName == "" || mtime < oldestTime) {
+      oldestFileName = cacheFileName;
+      oldestTime = mtime;
+    }
+  }
+  return oldestFileName;
+}
+
+std::string PPCache::getDefineKey_(const std::string& macroName) {
+  const std::map<SymbolId, std::string>& defines =
+      m_pp->getCompileSourceFile()->getCommandLineParser()->getDefineList();
+  std::map<SymbolId, std::string>::const_iterator itr =
+      defines.find(m_pp->getId(macroName));
+  if (itr == defines.end()) return macroName;
+  return macroName + "=" + (*itr).second;
+}
+
+bool PPCache::checkDefines_(const MACROCACHE::PPCache* ppcache) {
+  auto relevantDefines = ppcache->m_relevant_defines();
+  if (relevantDefines == NULL) return false;
+  for (unsigned int i = 0; i < relevantDefines->Length(); i++) {
+    const std::string define = relevantDefines->Get(i)->c_str();
+    std::string macroName = define.substr(0, define.find('='));
+    if (getDefineKey_(macroName) != define) return false;
+  }
+  return true;
+}
+
 template <class T>
 static bool compareVectors(std::vector<T> a, std::vector<T> b) {
   std::sort(a.begin(), a.end());
@@ -84,33 +125,35 @@ static bool compareVectors(std::vector<T> a, std::vector<T> b) {
   return (a == b);
 }
 
-bool PPCache::restore_(std::string cacheFileName) {
-  uint8_t* buffer_pointer = openFlatBuffers(cacheFileName);
-  if (buffer_pointer == NULL) return false;
-
-  const MACROCACHE::PPCache* ppcache = MACROCACHE::GetPPCache(buffer_pointer);
+PPCache::DecodedCache::DecodedCache(uint8_t* buffer, time_t timeStamp,
+                                    off_t fileSize)
+    : m_buffer(buffer), m_timeStamp(timeStamp), m_fileSize(fileSize) {
+  const MACROCACHE::PPCache* ppcache = MACROCACHE::GetPPCache(m_buffer);
 
   const flatbuffers::Vector<flatbuffers::Offset<MACROCACHE::Macro>>* macros =
       ppcache->m_macros();
   for (unsigned int i = 0; i < macros->Length(); i++) {
     const MACROCACHE::Macro* macro = macros->Get(i);
-    std::vector<std::string> args;
-    std::vector<std::string> tokens;
+    DecodedMacro decoded;
+    decoded.m_name = macro->m_name()->c_str();
+    decoded.m_line = macro->m_line();
+    decoded.m_column = macro->m_column();
     for (unsigned int j = 0; j < macro->m_arguments()->Length(); j++) {
-      args.push_back(macro->m_arguments()->Get(j)->c_str());
+      decoded.m_arguments.push_back(macro->m_arguments()->Get(j)->c_str());
     }
     for (unsigned int j = 0; j < macro->m_tokens()->Length(); j++) {
-      tokens.push_back(macro->m_tokens()->Get(j)->c_str());
+      decoded.m_tokens.push_back(macro->m_tokens()->Get(j)->c_str());
     }
-    m_pp->recordMacro(macro->m_name()->c_str(), macro->m_line(),
-                      macro->m_column(), args, tokens);
+    m_macros.push_back(decoded);
   }
-  SymbolTable canonicalSymbols;
-  restoreErrors(ppcache->m_errors(), ppcache->m_symbols(), canonicalSymbols,
-                m_pp->getCompileSourceFile()->getErrorContainer(),
-                m_pp->getCompileSourceFile()->getSymbolTable());
 
-  /* Restore `timescale directives */
+  auto relevantDefines = ppcache->m_relevant_defines();
+  if (relevantDefines)
+    for (unsigned int i = 0; i < relevantDefines->Length(); i++) {
+      const std::string define = relevantDefines->Get(i)->c_str();
+      m_testedMacros.push_back(define.substr(0, define.find('=')));
+    }
+
   const flatbuffers::Vector<flatbuffers::Offset<CACHE::TimeInfo>>* timeinfos =
       ppcache->m_timeInfo();
   for (unsigned int i = 0; i < timeinfos->Length(); i++) {
@@ -123,42 +166,158 @@ bool PPCache::restore_(std::string cacheFileName) {
     timeInfo.m_timeUnitValue = fbtimeinfo->m_timeUnitValue();
     timeInfo.m_timePrecision = (TimeInfo::Unit)fbtimeinfo->m_timePrecision();
     timeInfo.m_timePrecisionValue = fbtimeinfo->m_timePrecisionValue();
-    m_pp->getCompilationUnit()->recordTimeInfo(timeInfo);
+    m_timeInfos.push_back(timeInfo);
   }
 
-  /* Restore file line info */
   const flatbuffers::Vector<flatbuffers::Offset < MACROCACHE::LineTranslationInfo>>*lineinfos =
           ppcache->m_lineTranslationVec();
   for (unsigned int i = 0; i < lineinfos->Length(); i++) {
     const MACROCACHE::LineTranslationInfo* lineinfo = lineinfos->Get(i);
-    std::string pretendFileName = lineinfo->m_pretendFile()->c_str();
-    PreprocessFile::LineTranslationInfo lineFileInfo(
-            m_pp->getCompileSourceFile()->getSymbolTable()->registerSymbol(pretendFileName),
-            lineinfo->m_originalLine(),
-            lineinfo->m_pretendLine());
-    m_pp->addLineTranslationInfo(lineFileInfo);
+    DecodedLineInfo decoded;
+    decoded.m_pretendFile = lineinfo->m_pretendFile()->c_str();
+    decoded.m_originalLine = lineinfo->m_originalLine();
+    decoded.m_pretendLine = lineinfo->m_pretendLine();
+    m_lineInfos.push_back(decoded);
   }
-  /* Restore include file info */
+
   const flatbuffers::Vector<flatbuffers::Offset < MACROCACHE::IncludeFileInfo>>*incinfos =
           ppcache->m_includeFileInfo();
   for (unsigned int i = 0; i < incinfos->Length(); i++) {
     const MACROCACHE::IncludeFileInfo* incinfo = incinfos->Get(i);
-    std::string sectionFileName = incinfo->m_sectionFile()->c_str();
-    IncludeFileInfo inf (incinfo->m_sectionStartLine(),
-        m_pp->getCompileSourceFile()->getSymbolTable()->registerSymbol(sectionFileName),
-        incinfo->m_originalLine(),
-        incinfo->m_type());
-    m_pp->getIncludeFileInfo().push_back(inf);
+    DecodedIncludeInfo decoded;
+    decoded.m_sectionStartLine = incinfo->m_sectionStartLine();
+    decoded.m_sectionFile = incinfo->m_sectionFile()->c_str();
+    decoded.m_originalLine = incinfo->m_originalLine();
+    decoded.m_type = incinfo->m_type();
+    m_includeInfos.push_back(decoded);
   }
-    
+
   auto includes = ppcache->m_includes();
   if (includes)
     for (unsigned int i = 0; i < includes->Length(); i++) {
-      auto include = includes->Get(i);
-      restore_(getCacheFileName_(include->c_str()));
+      m_includes.push_back(includes->Get(i)->c_str());
     }
+
   if (ppcache->m_body() && ppcache->m_body()->c_str()) {
-    m_pp->append(ppcache->m_body()->c_str());
+    m_body = ppcache->m_body()->c_str();
+  }
+}
+
+PPCache::DecodedCacheStore PPCache::m_includeCaches;
+std::mutex PPCache::m_includeCachesMutex;
+
+PPCache::DecodedCacheStore::~DecodedCacheStore() {
+  for (auto& entry : m_caches) delete entry.second;
+  for (DecodedCache* decoded : m_retired) delete decoded;
+}
+
+const PPCache::DecodedCache* PPCache::getIncludeCache_(
+    const std::string& cacheFileName) {
+  struct stat statbuf;
+  if (stat(cacheFileName.c_str(), &statbuf) == -1) return NULL;
+  time_t timeStamp = statbuf.st_mtime;
+  off_t fileSize = statbuf.st_size;
+  m_includeCachesMutex.lock();
+  std::map<std::string, DecodedCache*>::iterator itr =
+      m_includeCaches.m_caches.find(cacheFileName);
+  if (itr != m_includeCaches.m_caches.end()) {
+    DecodedCache* decoded = (*itr).second;
+    if (decoded->m_timeStamp == timeStamp && decoded->m_fileSize == fileSize) {
+      m_includeCachesMutex.unlock();
+      return decoded;
+    }
+    // The cache file was rewritten during this run
+    m_includeCaches.m_retired.push_back(decoded);
+    m_includeCaches.m_caches.erase(itr);
+  }
+  m_includeCachesMutex.unlock();
+
+  uint8_t* buffer_pointer = openFlatBuffers(cacheFileName);
+  if (buffer_pointer == NULL) return NULL;
+  if (!checkCompactVObjects(
+          MACROCACHE::GetPPCache(buffer_pointer)->m_compact_objects())) {
+    delete[] buffer_pointer;
+    return NULL;
+  }
+  DecodedCache* decoded =
+      new DecodedCache(buffer_pointer, timeStamp, fileSize);
+
+  m_includeCachesMutex.lock();
+  std::pair<std::map<std::string, DecodedCache*>::iterator, bool> inserted =
+      m_includeCaches.m_caches.insert(std::make_pair(cacheFileName, decoded));
+  if (!inserted.second) {
+    // Another thread decoded it first
+    delete decoded;
+    decoded = (*inserted.first).second;
+  }
+  m_includeCachesMutex.unlock();
+  return decoded;
+}
+
+bool PPCache::restore_(std::string cacheFileName, bool isInclude) {
+  if (isInclude) {
+    const DecodedCache* decoded = getIncludeCache_(cacheFileName);
+    if (decoded == NULL) return false;
+    return restoreDecoded_(decoded);
+  }
+  uint8_t* buffer_pointer = openFlatBuffers(cacheFileName);
+  if (buffer_pointer == NULL) return false;
+  /* A corrupt cache is a miss, the file gets preprocessed */
+  if (!checkCompactVObjects(
+          MACROCACHE::GetPPCache(buffer_pointer)->m_compact_objects())) {
+    delete[] buffer_pointer;
+    return false;
+  }
+  DecodedCache decoded(buffer_pointer, 0, 0);
+  return restoreDecoded_(&decoded);
+}
+
+bool PPCache::restoreDecoded_(const DecodedCache* decoded) {
+  const MACROCACHE::PPCache* ppcache =
+      MACROCACHE::GetPPCache(decoded->m_buffer);
+
+  for (const DecodedMacro& macro : decoded->m_macros) {
+    m_pp->recordMacro(macro.m_name, macro.m_line, macro.m_column,
+                      macro.m_arguments, macro.m_tokens);
+  }
+
+  /* Carry the tested defines over to the includers */
+  for (const std::string& macroName : decoded->m_testedMacros) {
+    m_pp->recordTestedMacro(macroName);
+  }
+
+  SymbolTable canonicalSymbols;
+  restoreErrors(ppcache->m_errors(), ppcache->m_symbols(), canonicalSymbols,
+                m_pp->getCompileSourceFile()->getErrorContainer(),
+                m_pp->getCompileSourceFile()->getSymbolTable());
+
+  /* Restore `timescale directives */
+  for (TimeInfo timeInfo : decoded->m_timeInfos) {
+    m_pp->getCompilationUnit()->recordTimeInfo(timeInfo);
+  }
+
+  /* Restore file line info */
+  for (const DecodedLineInfo& lineinfo : decoded->m_lineInfos) {
+    PreprocessFile::LineTranslationInfo lineFileInfo(
+            m_pp->getCompileSourceFile()->getSymbolTable()->registerSymbol(lineinfo.m_pretendFile),
+            lineinfo.m_originalLine,
+            lineinfo.m_pretendLine);
+    m_pp->addLineTranslationInfo(lineFileInfo);
+  }
+  /* Restore include file info */
+  for (const DecodedIncludeInfo& incinfo : decoded->m_includeInfos) {
+    IncludeFileInfo inf (incinfo.m_sectionStartLine,
+        m_pp->getCompileSourceFile()->getSymbolTable()->registerSymbol(incinfo.m_sectionFile),
+        incinfo.m_originalLine,
+        incinfo.m_type);
+    m_pp->getIncludeFileInfo().push_back(inf);
+  }
+
+  for (const std::string& include : decoded->m_includes) {
+    restore_(findCacheVariant_(include), true);
+  }
+  if (decoded->m_body.size()) {
+    m_pp->append(decoded->m_body);
   }
 
   FileContent* fileContent = m_pp->getFileContent();
@@ -172,18 +331,26 @@ bool PPCache::restore_(std::string cacheFileName) {
                                               m_pp->getFileId(0), fileContent);
   }
   
-  auto objects = ppcache->m_objects();
-  restoreVObjects(objects,
-        canonicalSymbols, 
-        *m_pp->getCompileSourceFile()->getSymbolTable(), 
-        m_pp->getFileId(0), 
-        fileContent); 
+  restoreCompactVObjects(ppcache->m_compact_objects(), canonicalSymbols,
+                         *m_pp->getCompileSourceFile()->getSymbolTable(),
+                         m_pp->getFileId(0), fileContent);
   
-  delete[] buffer_pointer;
   return true;
 }
 
 bool PPCache::checkCacheIsValid_(std::string cacheFileName) {
+  /* Include caches already decoded in this run were validated then */
+  struct stat statbuf;
+  if (stat(cacheFileName.c_str(), &statbuf) == -1) return false;
+  m_includeCachesMutex.lock();
+  std::map<std::string, DecodedCache*>::iterator itr =
+      m_includeCaches.m_caches.find(cacheFileName);
+  bool decoded = (itr != m_includeCaches.m_caches.end()) &&
+                 ((*itr).second->m_timeStamp == statbuf.st_mtime) &&
+                 ((*itr).second->m_fileSize == statbuf.st_size);
+  m_includeCachesMutex.unlock();
+  if (decoded) return true;
+
   uint8_t* buffer_pointer = openFlatBuffers(cacheFileName);
   if (buffer_pointer == NULL) {
     delete[] buffer_pointer;
@@ -227,23 +394,8 @@ bool PPCache::checkCacheIsValid_(std::string cacheFileName) {
       return false;
     }
 
-    /* Cache the defines on the command line */
-    auto defineList =
-        m_pp->getCompileSourceFile()->getCommandLineParser()->getDefineList();
-    std::vector<std::string> define_vec;
-    for (auto definePair : defineList) {
-      std::string spath =
-          m_pp->getSymbol(definePair.first) + "=" + definePair.second;
-      define_vec.push_back(spath);
-    }
-    
-    std::vector<std::string> cache_define_vec;
-    for (unsigned int i = 0; i < ppcache->m_cmd_define_options()->Length();
-         i++) {
-      const std::string path = ppcache->m_cmd_define_options()->Get(i)->c_str();
-      cache_define_vec.push_back(path);
-    }
-    if (!compareVectors(define_vec, cache_define_vec)) {
+    /* Only the command line defines the file actually tested matter */
+    if (!checkDefines_(ppcache)) {
       delete[] buffer_pointer;
       return false;
     }
@@ -253,7 +405,7 @@ bool PPCache::checkCacheIsValid_(std::string cacheFileName) {
     if (includes)
       for (unsigned int i = 0; i < includes->Length(); i++) {
         auto include = includes->Get(i);
-        if (!checkCacheIsValid_(getCacheFileName_(include->c_str()))) {
+        if (findCacheVariant_(include->c_str()) == "") {
           delete[] buffer_pointer;
           return false;
         }
@@ -269,8 +421,8 @@ bool PPCache::restore() {
       m_pp->getCompileSourceFile()->getCommandLineParser()->cacheAllowed();
   if (!cacheAllowed) return false;
   if (m_pp->isMacroBody()) return false;
-  std::string cacheFileName = getCacheFileName_();
-  if (!checkCacheIsValid_(cacheFileName)) {
+  std::string cacheFileName = findCacheVariant_();
+  if (cacheFileName == "") {
     return false;
   }
 
@@ -283,9 +435,9 @@ bool PPCache::save() {
   if (!cacheAllowed) return false;
   std::string svFileName = m_pp->getFileName(LINE1);
   std::string origFileName = svFileName;
-  std::string cacheFileName = getCacheFileName_();
 
   if (m_pp->isMacroBody()) return false;
+  std::string cacheFileName = selectSaveVariant_();
 
   flatbuffers::FlatBufferBuilder builder(1024);
   /* Create header section */
@@ -329,7 +481,7 @@ bool PPCache::save() {
       m_pp->getCompileSourceFile()->getErrorContainer();
   SymbolId subjectFileId = m_pp->getFileId(LINE1);
   SymbolTable canonicalSymbols;
-  auto errorSymbolPair = cacheErrors(
+  auto errorCache = cacheErrors(
       builder, canonicalSymbols, errorContainer,
       m_pp->getCompileSourceFile()->getSymbolTable(), subjectFileId);
 
@@ -354,6 +506,13 @@ bool PPCache::save() {
   }
   auto defines = builder.CreateVectorOfStrings(define_vec);
 
+  /* Cache the subset of defines the file tested, it keys the variant */
+  std::vector<std::string> relevant_define_vec;
+  for (auto& macroName : m_pp->getTestedMacros()) {
+    relevant_define_vec.push_back(getDefineKey_(macroName));
+  }
+  auto relevantDefines = builder.CreateVectorOfStrings(relevant_define_vec);
+
   /* Cache the `timescale directives */
   auto timeinfoList = m_pp->getCompilationUnit()->getTimeInfo();
   std::vector<flatbuffers::Offset<CACHE::TimeInfo>> timeinfo_vec;
@@ -361,7 +520,7 @@ bool PPCache::save() {
     if (info.m_fileId != m_pp->getFileId(0)) continue;
     auto timeInfo = CACHE::CreateTimeInfo(
         builder, info.m_type,
-        canonicalSymbols.getId(
+        canonicalSymbols.registerSymbol(
             m_pp->getCompileSourceFile()->getSymbolTable()->getSymbol(
                 info.m_fileId)),
         info.m_line, info.m_timeUnit, info.m_timeUnitValue,
@@ -403,17 +562,17 @@ bool PPCache::save() {
   auto incinfoFBList = builder.CreateVector(lineinfo_vec);
   
   /* Cache the design objects */
-   FileContent* fcontent = m_pp->getFileContent();
-  std::vector<CACHE::VObject> object_vec = cacheVObjects(fcontent, canonicalSymbols, 
-          *m_pp->getCompileSourceFile()->getSymbolTable(), 
-          m_pp->getFileId(0));
-   auto objectList = builder.CreateVectorOfStructs(object_vec);
+  FileContent* fcontent = m_pp->getFileContent();
+  auto compactObjects = cacheCompactVObjects(
+      builder, fcontent, canonicalSymbols,
+      *m_pp->getCompileSourceFile()->getSymbolTable(), m_pp->getFileId(0));
+  auto symbolCache = cacheSymbols(builder, canonicalSymbols);
   
   /* Create Flatbuffers */
   auto ppcache = MACROCACHE::CreatePPCache(
-      builder, header, macroList, includeList, body, errorSymbolPair.first,
-      errorSymbolPair.second, incPaths, defines, timeinfoFBList, lineinfoFBList,
-      incinfoFBList, objectList);
+      builder, header, macroList, includeList, body, errorCache, symbolCache,
+      incPaths, defines, timeinfoFBList, lineinfoFBList,
+      incinfoFBList, relevantDefines, compactObjects);
   FinishPPCacheBuffer(builder, ppcache);
 
   /* Save Flatbuffer */
@@ -27,7 +27,12 @@
 #include "flatbuffers/flatbuffers.h"
 #include "Cache/preproc_generated.h"
 #include <cstdio>  // For printing and file access.
+#include <ctime>
+#include <sys/types.h>
+#include <map>
+#include <mutex>
 #include "Cache/Cache.h"
+#include "Design/TimeInfo.h"
 
 namespace SURELOG {
 
@@ -39,12 +44,72 @@ class PPCache : Cache {
   bool save();
   ~PPCache() override;
 
+  /* Number of define-set variants kept side by side for one source file */
+  static const unsigned int MaxVariants = 8;
+
  private:
   PreprocessFile* m_pp;
-  std::string getCacheFileName_(std::string fileName = "");
-  bool restore_(std::string cacheFileName);
+  std::string getCacheFileName_(std::string fileName = "",
+                                unsigned int variant = 0);
+  std::string findCacheVariant_(std::string fileName = "");
+  std::string selectSaveVariant_();
+  std::string getDefineKey_(const std::string& macroName);
+  bool checkDefines_(const MACROCACHE::PPCache* ppcache);
+  bool restore_(std::string cacheFileName, bool isInclude = false);
   bool checkCacheIsValid_(std::string cacheFileName);
   bool m_isPrecompiled;
+
+  /* Decoded content of a cache file, include caches are decoded once per
+     process and shared by all the includers */
+  class DecodedMacro {
+   public:
+    std::string m_name;
+    unsigned int m_line;
+    unsigned short int m_column;
+    std::vector<std::string> m_arguments;
+    std::vector<std::string> m_tokens;
+  };
+  class DecodedLineInfo {
+   public:
+    std::string m_pretendFile;
+    unsigned int m_originalLine;
+    unsigned int m_pretendLine;
+  };
+  class DecodedIncludeInfo {
+   public:
+    unsigned int m_sectionStartLine;
+    std::string m_sectionFile;
+    unsigned int m_originalLine;
+    unsigned int m_type;
+  };
+  class DecodedCache {
+   public:
+    DecodedCache(uint8_t* buffer, time_t timeStamp, off_t fileSize);
+    ~DecodedCache() { delete[] m_buffer; }
+    uint8_t* m_buffer;  // Kept for the per-includer errors and objects
+    time_t m_timeStamp;
+    off_t m_fileSize;  // The mtime alone misses rewrites within a second
+    std::vector<DecodedMacro> m_macros;
+    std::vector<std::string> m_testedMacros;
+    std::vector<TimeInfo> m_timeInfos;
+    std::vector<DecodedLineInfo> m_lineInfos;
+    std::vector<DecodedIncludeInfo> m_includeInfos;
+    std::vector<std::string> m_includes;
+    std::string m_body;
+  };
+  const DecodedCache* getIncludeCache_(const std::string& cacheFileName);
+  bool restoreDecoded_(const DecodedCache* decoded);
+  /* Owns the decoded caches, a cache file rewritten during the run gets a
+     new entry while the replaced one is retired: includers might still
+     point to it */
+  class DecodedCacheStore {
+   public:
+    ~DecodedCacheStore();
+    std::map<std::string, DecodedCache*> m_caches;
+    std::vector<DecodedCache*> m_retired;
+  };
+  static DecodedCacheStore m_includeCaches;
+  static std::mutex m_includeCachesMutex;
 };
 
 };  // namespace SURELOG
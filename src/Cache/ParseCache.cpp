@@ -53,33 +53,17 @@ ParseCache::ParseCache(const ParseCache& orig) {}
 
 ParseCache::~ParseCache() {}
 
-static std::string FlbSchemaVersion = "1.0";
+static std::string FlbSchemaVersion = "1.3";
 
 std::string ParseCache::getCacheFileName_(std::string svFileName) {
-  Precompiled* prec = Precompiled::getSingleton();
-  SymbolId cacheDirId =
-      m_parse->getCompileSourceFile()->getCommandLineParser()->getCacheDir();
   if (svFileName == "") svFileName = m_parse->getPpFileName();
-  std::string root = svFileName;
-  root = StringUtils::getRootFileName(root);
-  if (prec->isFilePrecompiled(root)) {
-    std::string packageRepDir =
-        m_parse->getSymbol(m_parse->getCompileSourceFile()
-                               ->getCommandLineParser()
-                               ->getPrecompiledDir());
-    cacheDirId = m_parse->getCompileSourceFile()
-                     ->getCommandLineParser()
-                     ->getSymbolTable()
-                     ->registerSymbol(packageRepDir);
-    m_isPrecompiled = true;
-  }
-
-  std::string cacheDirName = m_parse->getSymbol(cacheDirId);
-  Library* lib = m_parse->getLibrary();
-  std::string libName = lib->getName() + "/";
+  std::string cacheDirName = getCacheDirName(
+      m_parse->getCompileSourceFile()->getCommandLineParser(),
+      m_parse->getCompileSourceFile()->getSymbolTable(),
+      m_parse->getLibrary(), svFileName, m_isPrecompiled);
   svFileName = StringUtils::getRootFileName(svFileName);
-  std::string cacheFileName = cacheDirName + libName + svFileName + ".slpa";
-  FileUtils::mkDir(std::string(cacheDirName + libName).c_str());
+  std::string cacheFileName = cacheDirName + svFileName + ".slpa";
+  FileUtils::mkDir(cacheDirName.c_str());
   return cacheFileName;
 }
 
@@ -90,6 +74,11 @@ bool ParseCache::restore_(std::string cacheFileName) {
   /* Restore Errors */
   const PARSECACHE::ParseCache* ppcache =
       PARSECACHE::GetParseCache(buffer_pointer);
+  /* A corrupt cache is a miss, the file gets parsed */
+  if (!checkCompactVObjects(ppcache->m_compact_objects())) {
+    delete[] buffer_pointer;
+    return false;
+  }
   SymbolTable canonicalSymbols;
   restoreErrors(ppcache->m_errors(), ppcache->m_symbols(), canonicalSymbols,
                 m_parse->getCompileSourceFile()->getErrorContainer(),
@@ -130,13 +119,17 @@ bool ParseCache::restore_(std::string cacheFileName) {
   }
 
   /* Restore design objects */
-  auto objects = ppcache->m_objects();
-  restoreVObjects(objects,
-        canonicalSymbols, 
-        *m_parse->getCompileSourceFile()->getSymbolTable(), 
-        m_parse->getFileId(0), 
-        fileContent);
-  
+  restoreCompactVObjects(ppcache->m_compact_objects(), canonicalSymbols,
+                         *m_parse->getCompileSourceFile()->getSymbolTable(),
+                         m_parse->getFileId(0), fileContent);
+
+  if (ppcache->m_packageScopes()) {
+    for (unsigned int i = 0; i < ppcache->m_packageScopes()->Length(); i++)
+      fileContent->addPackageScope(
+          m_parse->getCompileSourceFile()->getSymbolTable()->registerSymbol(
+              canonicalSymbols.getSymbol(ppcache->m_packageScopes()->Get(i))));
+  }
+
   delete[] buffer_pointer;
   return true;
 }
@@ -191,6 +184,11 @@ bool ParseCache::save() {
   std::string origFileName = svFileName;
 
   std::string cacheFileName = getCacheFileName_();
+  // The precompiled directory is read-only outside of -createcache
+  if (m_isPrecompiled && !m_parse->getCompileSourceFile()
+                              ->getCommandLineParser()
+                              ->createCache())
+    return true;
 
   flatbuffers::FlatBufferBuilder builder(1024);
   /* Create header section */
@@ -204,7 +202,7 @@ bool ParseCache::save() {
       m_parse->getCompileSourceFile()->getSymbolTable()->registerSymbol(
           subjectFile);
   SymbolTable canonicalSymbols;
-  auto errorSymbolPair = cacheErrors(
+  auto errorCache = cacheErrors(
       builder, canonicalSymbols, errorContainer,
       m_parse->getCompileSourceFile()->getSymbolTable(), subjectFileId);
 
@@ -216,17 +214,17 @@ bool ParseCache::save() {
     TimeInfo& info = elem.m_timeInfo;
     auto timeInfo = CACHE::CreateTimeInfo(
         builder, info.m_type,
-        canonicalSymbols.getId(
+        canonicalSymbols.registerSymbol(
             m_parse->getCompileSourceFile()->getSymbolTable()->getSymbol(
                 info.m_fileId)),
         info.m_line, info.m_timeUnit, info.m_timeUnitValue,
         info.m_timePrecision, info.m_timePrecisionValue);
     element_vec.push_back(PARSECACHE::CreateDesignElement(
         builder,
-        canonicalSymbols.getId(
+        canonicalSymbols.registerSymbol(
             m_parse->getCompileSourceFile()->getSymbolTable()->getSymbol(
                 elem.m_name)),
-        canonicalSymbols.getId(
+        canonicalSymbols.registerSymbol(
             m_parse->getCompileSourceFile()->getSymbolTable()->getSymbol(
                 elem.m_fileId)),
         elem.m_type, elem.m_uniqueId, elem.m_line, timeInfo, elem.m_parent,
@@ -235,15 +233,21 @@ bool ParseCache::save() {
   auto elementList = builder.CreateVector(element_vec);
 
   /* Cache the design objects */
-  std::vector<CACHE::VObject> object_vec = cacheVObjects(fcontent, canonicalSymbols, 
-          *m_parse->getCompileSourceFile()->getSymbolTable(), 
-          m_parse->getFileId(0));
-   auto objectList = builder.CreateVectorOfStructs(object_vec);
+  auto compactObjects = cacheCompactVObjects(
+      builder, fcontent, canonicalSymbols,
+      *m_parse->getCompileSourceFile()->getSymbolTable(),
+      m_parse->getFileId(0));
+  std::vector<uint64_t> packageScopes;
+  for (SymbolId name : fcontent->getPackageScopes())
+    packageScopes.push_back(canonicalSymbols.registerSymbol(
+        m_parse->getCompileSourceFile()->getSymbolTable()->getSymbol(name)));
+  auto packageScopeList = builder.CreateVector(packageScopes);
+  auto symbolCache = cacheSymbols(builder, canonicalSymbols);
 
   /* Create Flatbuffers */
   auto ppcache = PARSECACHE::CreateParseCache(
-      builder, header, errorSymbolPair.first, errorSymbolPair.second,
-      elementList, objectList);
+      builder, header, errorCache, symbolCache, elementList,
+      compactObjects, packageScopeList);
   FinishParseCacheBuffer(builder, ppcache);
 
   /* Save Flatbuffer */
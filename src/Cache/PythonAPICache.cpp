@@ -162,14 +162,14 @@ bool PythonAPICache::save() {
       m_listener->getCompileSourceFile()->getErrorContainer();
   SymbolId subjectFileId = m_listener->getParseFile()->getFileId(LINE1);
   SymbolTable canonicalSymbols;
-  auto errorSymbolPair = cacheErrors(
+  auto errorCache = cacheErrors(
       builder, canonicalSymbols, errorContainer,
       m_listener->getCompileSourceFile()->getSymbolTable(), subjectFileId);
+  auto symbolCache = cacheSymbols(builder, canonicalSymbols);
 
   /* Create Flatbuffers */
   auto ppcache = PYTHONAPICACHE::CreatePythonAPICache(
-      builder, header, scriptFile, errorSymbolPair.first,
-      errorSymbolPair.second);
+      builder, header, scriptFile, errorCache, symbolCache);
   FinishPythonAPICacheBuffer(builder, ppcache);
 
   /* Save Flatbuffer */
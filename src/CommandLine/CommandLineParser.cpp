@@ -39,6 +39,7 @@
 
 #include "Utils/StringUtils.h"
 #include "Utils/FileUtils.h"
+#include "Package/Precompiled.h"
 
 #include "antlr4-runtime.h"
 using namespace antlr4;
@@ -107,6 +108,10 @@ const std::vector<std::string> helpText = {
     "  -nocomp               Turns off Compilation & Elaboration",
     "  -noelab               Turns off Elaboration",
     "  -top/--top-module <module> Top level module for elaboration (multiple cmds ok)",
+    "  -lazyelab             Elaborates the instance tree on demand, as it is",
+    "                        walked through the API",
+    "  -elabpath <path>      Lazy elaboration of the given hierarchical path",
+    "                        only, like top.u_core.u_lsu (multiple cmds ok)",
     "  -batch <batch.txt>    Runs all the tests specified in the file in batch mode",
     "                        Tests are expressed as one full command line per line.",
     "  -pythonlistener       Enables the Parser Python Listener",
@@ -147,6 +152,17 @@ const std::vector<std::string> helpText = {
     "  -cache <dir>          Specifies the cache directory, default is "
     "slpp_all/cache or slpp_unit/cache",
     "  -createcache          Create cache for precompiled packages",
+    "  -precompiled <package> <file>",
+    "                        Declares a package as precompiled, its caches are",
+    "                        read from the precompiled directory and never",
+    "                        rewritten (unless -createcache is used)",
+    "  -precompiledmanifest <file> File of \"<package> <file>\" lines declaring",
+    "                        precompiled packages",
+    "  -precompileddir <dir> Specifies the precompiled package directory, "
+    "default is pkg/ next to the executable",
+    "  -prefetch <nb>        Number of files read ahead of the compile jobs,",
+    "                        at least 1, default 16",
+    "  -noprefetch           Turns off the cache prefetch",
     "  -filterdirectives     Filters out simple directives like",
     "                        `default_nettype in pre-processor's output",
     "  -filterprotected      Filters out protected regions in pre-processor's "
@@ -260,6 +276,7 @@ CommandLineParser::CommandLineParser(ErrorContainer* errors,
       m_diff_comp_mode(diff_comp_mode),
       m_help(false),
       m_cacheAllowed(true),
+      m_prefetchWindow(16),
       m_nbMaxTreads(0),
       m_nbMaxProcesses(0),
       m_fullCompileDir(0),
@@ -286,7 +303,8 @@ CommandLineParser::CommandLineParser(ErrorContainer* errors,
       m_ppOutputFileLocation(false),
       m_logFileSpecified(false),
       m_sverilog(false),
-      m_dumpUhdm(false) {
+      m_dumpUhdm(false),
+      m_lazyElaboration(false) {
   m_errors->regiterCmdLine(this);
   m_logFileId = m_symbolTable->registerSymbol(defaultLogFileName);
   m_compileUnitDirectory = m_symbolTable->registerSymbol("slpp_unit/");
@@ -657,6 +675,12 @@ int CommandLineParser::parseCommandLine(int argc, const char** argv) {
     } else if ((all_arguments[i] == "--top-module") || (all_arguments[i] == "-top")) {
       i++;
       m_topLevelModules.push_back(all_arguments[i]);
+    } else if (all_arguments[i] == "-lazyelab") {
+      m_lazyElaboration = true;
+    } else if (all_arguments[i] == "-elabpath") {
+      i++;
+      m_lazyElaboration = true;
+      m_elabPaths.push_back(all_arguments[i]);
     } else if (all_arguments[i] == "-createcache") {
       m_createCache = true;
     } else if (all_arguments[i] == "-lineoffsetascomments") {
@@ -721,6 +745,56 @@ int CommandLineParser::parseCommandLine(int argc, const char** argv) {
       }
       i++;
       m_cacheDirId = m_symbolTable->registerSymbol(all_arguments[i]);
+    } else if (all_arguments[i] == "-precompiled") {
+      if (i >= all_arguments.size() - 2) {
+        Location loc(getSymbolTable()->registerSymbol(all_arguments[i]));
+        Error err(ErrorDefinition::CMD_PRECOMPILED_MISSING_PACKAGE, loc);
+        m_errors->addError(err);
+        break;
+      }
+      std::string packageName = all_arguments[i + 1];
+      std::string fileName = all_arguments[i + 2];
+      i += 2;
+      Precompiled::getSingleton()->addPrecompiled(
+          packageName, StringUtils::getRootFileName(fileName));
+    } else if (all_arguments[i] == "-precompiledmanifest") {
+      if (i == all_arguments.size() - 1) {
+        Location loc(getSymbolTable()->registerSymbol(all_arguments[i]));
+        Error err(ErrorDefinition::CMD_PRECOMPILED_MISSING_PACKAGE, loc);
+        m_errors->addError(err);
+        break;
+      }
+      i++;
+      parsePrecompiledManifest_(all_arguments[i]);
+    } else if (all_arguments[i] == "-precompileddir") {
+      if (i == all_arguments.size() - 1) {
+        Location loc(getSymbolTable()->registerSymbol(all_arguments[i]));
+        Error err(ErrorDefinition::CMD_PP_FILE_MISSING_FILE, loc);
+        m_errors->addError(err);
+        break;
+      }
+      i++;
+      std::string pkgDir = all_arguments[i];
+      if (pkgDir.size() && pkgDir[pkgDir.size() - 1] != '/') pkgDir += "/";
+      m_precompiledDirId = m_symbolTable->registerSymbol(pkgDir);
+    } else if (all_arguments[i] == "-prefetch") {
+      if (i == all_arguments.size() - 1) {
+        Location loc(getSymbolTable()->registerSymbol(all_arguments[i]));
+        Error err(ErrorDefinition::CMD_PREFETCH_MISSING_SIZE, loc);
+        m_errors->addError(err);
+        break;
+      }
+      i++;
+      int window = atoi(all_arguments[i].c_str());
+      if (window < 1) {
+        Location loc(getSymbolTable()->registerSymbol(all_arguments[i]));
+        Error err(ErrorDefinition::CMD_PREFETCH_MISSING_SIZE, loc);
+        m_errors->addError(err);
+      } else {
+        m_prefetchWindow = window;
+      }
+    } else if (all_arguments[i] == "-noprefetch") {
+      m_prefetchWindow = 0;
     } else if (all_arguments[i] == "-writepp") {
       m_writePpOutput = true;
     } else if (all_arguments[i] == "-noinfo") {
@@ -893,6 +967,43 @@ int CommandLineParser::parseCommandLine(int argc, const char** argv) {
   return status;
 }
 
+void CommandLineParser::parsePrecompiledManifest_(
+    const std::string& fileName) {
+  SymbolId fId = m_symbolTable->registerSymbol(fileName);
+  std::ifstream ifs(fileName);
+  if (!ifs) {
+    Location loc(fId);
+    Error err(ErrorDefinition::CMD_CANNOT_OPEN_FILE_FOR_READ, loc);
+    m_errors->addError(err);
+    return;
+  }
+  std::stringstream ss;
+  ss << ifs.rdbuf();
+  ifs.close();
+  std::string fileContent = ss.str();
+  fileContent = StringUtils::removeComments(fileContent);
+  fileContent = StringUtils::evaluateEnvVars(fileContent);
+  // One "<package> <file>" pair per line
+  std::vector<std::string> lines;
+  StringUtils::tokenize(fileContent, "\n\r", lines);
+  Precompiled* prec = Precompiled::getSingleton();
+  for (unsigned int i = 0; i < lines.size(); i++) {
+    std::vector<std::string> fields;
+    StringUtils::tokenize(lines[i], " \t", fields);
+    std::vector<std::string> entry;
+    for (unsigned int j = 0; j < fields.size(); j++)
+      if (fields[j].size()) entry.push_back(fields[j]);
+    if (entry.empty()) continue;
+    if (entry.size() != 2) {
+      Location loc(fId, i + 1, 0, m_symbolTable->registerSymbol(lines[i]));
+      Error err(ErrorDefinition::CMD_PRECOMPILED_MISSING_PACKAGE, loc);
+      m_errors->addError(err);
+      continue;
+    }
+    prec->addPrecompiled(entry[0], StringUtils::getRootFileName(entry[1]));
+  }
+}
+
 bool CommandLineParser::checkCommandLine_() {
   bool noError = true;
   for (auto fid : m_sourceFiles) {
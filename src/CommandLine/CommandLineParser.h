@@ -75,6 +75,7 @@ class CommandLineParser {
   void setwritePpOutput(bool value) { m_writePpOutput = value; }
   bool cacheAllowed() { return m_cacheAllowed; }
   void setCacheAllowed(bool val) { m_cacheAllowed = val; }
+  unsigned int getPrefetchWindow() { return m_prefetchWindow; }
   bool lineOffsetsAsComments() { return m_lineOffsetsAsComments; }
   SymbolId getCacheDir() { return m_cacheDirId; }
   SymbolId getPrecompiledDir() { return m_precompiledDirId; }
@@ -142,6 +143,9 @@ class CommandLineParser {
   std::string getExePath() { return m_exePath; }
   std::string getExeCommand() { return m_exeCommand; }
   std::vector<std::string>& getTopLevelModules() { return m_topLevelModules; }
+  bool lazyElaboration() { return m_lazyElaboration; }
+  void setLazyElaboration(bool val) { m_lazyElaboration = val; }
+  std::vector<std::string>& getElaborationPaths() { return m_elabPaths; }
   bool fullSVMode() { return m_sverilog; } 
   bool isSVFile(const std::string& fileName);
  private:
@@ -153,6 +157,7 @@ class CommandLineParser {
   void splitPlusArg_(std::string s, std::string prefix,
                      std::map<SymbolId, std::string>& container);
   bool checkCommandLine_();
+  void parsePrecompiledManifest_(const std::string& fileName);
   bool prepareCompilation_(int argc, const char** argv);
   std::vector<SymbolId> m_libraryPaths;          // -y
   std::vector<SymbolId> m_sourceFiles;           // .v .sv
@@ -190,6 +195,7 @@ class CommandLineParser {
   bool m_diff_comp_mode;
   bool m_help;
   bool m_cacheAllowed;
+  unsigned int m_prefetchWindow;
   unsigned short int m_nbMaxTreads;
   unsigned short int m_nbMaxProcesses;
   SymbolId m_compileUnitDirectory;
@@ -229,6 +235,8 @@ class CommandLineParser {
   std::vector<std::string> m_topLevelModules;
   bool m_sverilog;
   bool m_dumpUhdm;
+  bool m_lazyElaboration;
+  std::vector<std::string> m_elabPaths;
 };
 
 };  // namespace SURELOG
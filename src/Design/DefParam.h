@@ -23,8 +23,10 @@
 
 #ifndef DEFPARAM_H
 #define DEFPARAM_H
+#include "SourceCompile/SymbolTable.h"
 #include "Expression/Value.h"
 #include <map>
+#include <unordered_map>
 
 namespace SURELOG {
 
@@ -45,10 +47,16 @@ class DefParam {
   Value* getValue() { return m_value; }
   void setValue(Value* value) { m_value = value; }
 
-  void setChild(std::string name, DefParam* child) {
+  void setChild(std::string name, SymbolId nameId, DefParam* child) {
     m_children.insert(std::make_pair(name, child));
+    m_childIds.insert(std::make_pair(nameId, child));
   }
   std::map<std::string, DefParam*>& getChildren() { return m_children; }
+  DefParam* getChild(SymbolId nameId) {
+    std::unordered_map<SymbolId, DefParam*>::iterator itr =
+        m_childIds.find(nameId);
+    return (itr == m_childIds.end()) ? NULL : (*itr).second;
+  }
   bool isUsed() { return m_used; }
   void setUsed() { m_used = true; }
   void setLocation(FileContent* fC, NodeId nodeId) {
@@ -63,6 +71,7 @@ class DefParam {
  private:
   std::string m_name;
   std::map<std::string, DefParam*> m_children;
+  std::unordered_map<SymbolId, DefParam*> m_childIds;
   Value* m_value;
   bool m_used;
   DefParam* m_parent;
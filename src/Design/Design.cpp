@@ -22,6 +22,7 @@
  */
 #include <queue>
 #include <set>
+#include <unordered_map>
 #include "Utils/StringUtils.h"
 #include "SourceCompile/VObjectTypes.h"
 #include "Design/VObject.h"
@@ -236,8 +237,8 @@ ModuleInstance* Design::findInstance_(std::vector<std::string>& path,
     }
   }
 
-  for (unsigned int i = 0; i < scope->getNbChildren(); i++) {
-    ModuleInstance* child = scope->getChildren(i);
+  for (unsigned int i = 0; i < scope->getNbScalarChildren(); i++) {
+    ModuleInstance* child = scope->getScalarChildren(i);
     if (path.size()) {
       if (child->getInstanceName() == path[0]) {
         if (path.size() == 1) {
@@ -251,6 +252,20 @@ ModuleInstance* Design::findInstance_(std::vector<std::string>& path,
       }
     }
   }
+
+  // Only the element of an instance array on the path is created
+  for (unsigned int i = 0; i < scope->getNbInstanceArrays(); i++) {
+    InstanceArray* array = scope->getInstanceArray(i);
+    int index = array->findElement(path[0]);
+    if (index < 0) continue;
+    ModuleInstance* child = array->getElement(index);
+    if (child == NULL) continue;
+    if (path.size() == 1) return child;
+    std::vector<std::string> subpath = path;
+    subpath.erase(subpath.begin());
+    ModuleInstance* res = findInstance(subpath, child);
+    if (res) return res;
+  }
   return NULL;
 }
 
@@ -271,6 +286,14 @@ Value* Design::getDefParamValue(std::string name) {
   return NULL;
 }
 
+DefParam* Design::getDefParam(DefParam* parent, ModuleInstance* instance) {
+  SymbolId nameId = instance->getInstanceId(m_errors->getSymbolTable());
+  if (parent) return parent->getChild(nameId);
+  std::unordered_map<SymbolId, DefParam*>::iterator itr =
+      m_defParamIds.find(nameId);
+  return (itr == m_defParamIds.end()) ? NULL : (*itr).second;
+}
+
 DefParam* Design::getDefParam_(std::vector<std::string>& path,
                                DefParam* parent) {
   if (path.size() == 0) {
@@ -286,23 +309,28 @@ DefParam* Design::getDefParam_(std::vector<std::string>& path,
 }
 
 void Design::addDefParam(std::string name, FileContent* fC, NodeId nodeId,
-                         Value* value) {
+                         Value* value, ErrorContainer* errors) {
+  if (errors == NULL) errors = m_errors;
   std::vector<std::string> vpath;
   StringUtils::tokenize(name, ".", vpath);
+  m_defParamGeneration++;
   std::map<std::string, DefParam*>::iterator itr = m_defParams.find(vpath[0]);
   if (itr != m_defParams.end()) {
     vpath.erase(vpath.begin());
-    addDefParam_(vpath, fC, nodeId, value, (*itr).second);
+    addDefParam_(vpath, fC, nodeId, value, (*itr).second, errors);
   } else {
     DefParam* def = new DefParam(vpath[0]);
     m_defParams.insert(std::make_pair(vpath[0], def));
+    m_defParamIds.insert(std::make_pair(
+        m_errors->getSymbolTable()->registerSymbol(vpath[0]), def));
     vpath.erase(vpath.begin());
-    addDefParam_(vpath, fC, nodeId, value, def);
+    addDefParam_(vpath, fC, nodeId, value, def, errors);
   }
 }
 
 void Design::addDefParam_(std::vector<std::string>& path, FileContent* fC,
-                          NodeId nodeId, Value* value, DefParam* parent) {
+                          NodeId nodeId, Value* value, DefParam* parent,
+                          ErrorContainer* errors) {
   if (path.size() == 0) {
     parent->setValue(value);
     parent->setLocation(fC, nodeId);
@@ -326,15 +354,16 @@ void Design::addDefParam_(std::vector<std::string>& path, FileContent* fC,
                       previous->getLocation()->Line(previous->getNodeId()), 0,
                       0);
         Error err(ErrorDefinition::ELAB_MULTI_DEFPARAM_ON_OBJECT, loc1, loc2);
-        m_errors->addError(err);
+        errors->addError(err);
       }
     }
-    addDefParam_(path, fC, nodeId, value, (*itr).second);
+    addDefParam_(path, fC, nodeId, value, (*itr).second, errors);
   } else {
     DefParam* def = new DefParam(path[0], parent);
-    parent->setChild(path[0], def);
+    parent->setChild(path[0],
+                     m_errors->getSymbolTable()->registerSymbol(path[0]), def);
     path.erase(path.begin());
-    addDefParam_(path, fC, nodeId, value, def);
+    addDefParam_(path, fC, nodeId, value, def, errors);
   }
 }
 
@@ -404,34 +433,23 @@ ClassDefinition* Design::getClassDefinition(std::string name) {
 
 void Design::orderPackages() {
   if (m_orderedPackageNames.size() == 0) return;
-  m_orderedPackageDefinitions.resize(m_orderedPackageNames.size());
+  m_orderedPackageDefinitions.clear();
+  m_orderedPackageDefinitions.resize(m_orderedPackageNames.size(), NULL);
   unsigned int index = 0;
-  typedef std::map<std::string, int> MultiDefCount;
+  // The n-th occurrence of a name takes the n-th definition of that name
+  typedef std::unordered_map<std::string, unsigned int> MultiDefCount;
   MultiDefCount multiDefCount;
-  for (auto packageName : m_orderedPackageNames) {
-    for (unsigned int i = 0; i < m_packageDefinitions.size(); i++) {
-      PackageNamePackageDefinitionMultiMap::iterator pos =
-          m_packageDefinitions.begin();
-      for (unsigned ii = 0; ii < i; ii++) pos++;
-      std::pair<const std::string, Package*>* name_pack;
-      name_pack = &(*pos);
-
-      if (packageName == name_pack->first) {
-        MultiDefCount::iterator itr = multiDefCount.find(packageName);
-        if (itr == multiDefCount.end()) {
-          multiDefCount.insert(std::make_pair(packageName, 1));
-        } else {
-          int level = (*itr).second;
-          (*itr).second++;
-          pos = m_packageDefinitions.begin();
-          for (unsigned ii = 0; ii < i + level; ii++) pos++;
-          name_pack = &(*pos);
-        }
-        m_orderedPackageDefinitions[index] = name_pack->second;
-        index++;
-        break;
-      }
-    }
+  for (auto& packageName : m_orderedPackageNames) {
+    std::pair<PackageNamePackageDefinitionMultiMap::iterator,
+              PackageNamePackageDefinitionMultiMap::iterator>
+        range = m_packageDefinitions.equal_range(packageName);
+    if (range.first == range.second) continue;
+    unsigned int level = multiDefCount[packageName]++;
+    PackageNamePackageDefinitionMultiMap::iterator pos = range.first;
+    for (unsigned int ii = 0; ii < level && pos != range.second; ii++) pos++;
+    if (pos == range.second) continue;
+    m_orderedPackageDefinitions[index] = (*pos).second;
+    index++;
   }
 }
 
@@ -468,6 +486,7 @@ void Design::clearContainers() {
   m_topLevelModuleInstances.clear();
 
   m_defParams.clear();
+  m_defParamIds.clear();
 
   m_packageDefinitions.clear();
   m_orderedPackageDefinitions.clear();
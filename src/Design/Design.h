@@ -23,6 +23,7 @@
 
 #ifndef DESIGN_H
 #define DESIGN_H
+#include <unordered_map>
 #include "Design/ModuleDefinition.h"
 #include "Design/ModuleInstance.h"
 #include "Design/DefParam.h"
@@ -51,7 +52,8 @@ class Design {
   Design(ErrorContainer* errors, LibrarySet* librarySet, ConfigSet* configSet)
       : m_errors(errors),
         m_librarySet(librarySet),
-        m_configSet(configSet) {}
+        m_configSet(configSet),
+        m_defParamGeneration(1) {}
       
   Design(const Design& orig);
   
@@ -113,6 +115,13 @@ class Design {
   Value* getDefParamValue(std::string name);
   
   std::map<std::string, DefParam*>& getDefParams() { return m_defParams; }
+
+  /* Walks the defparam trie one instance at a time, from the top level
+     defparams if parent is NULL */
+  DefParam* getDefParam(DefParam* parent, ModuleInstance* instance);
+
+  /* Changes each time a defparam is added */
+  unsigned int getDefParamGeneration() { return m_defParamGeneration; }
   
   void checkDefParamUsage(DefParam* parent = NULL);
 
@@ -149,8 +158,9 @@ class Design {
     m_topLevelModuleInstances.push_back(instance);
   }   
   
+  /* The messages go to errors if given, to the design container otherwise */
   void addDefParam(std::string name, FileContent* fC, NodeId nodeId,
-                   Value* value);  
+                   Value* value, ErrorContainer* errors = NULL);
      
   void addClassDefinition(std::string className, ClassDefinition* classDef);
 
@@ -168,7 +178,8 @@ class Design {
   ModuleInstance* findInstance_(std::vector<std::string>& path,
                                 ModuleInstance* scope);
   void addDefParam_(std::vector<std::string>& path, FileContent* fC,
-                    NodeId nodeId, Value* value, DefParam* parent);
+                    NodeId nodeId, Value* value, DefParam* parent,
+                    ErrorContainer* errors);
   DefParam* getDefParam_(std::vector<std::string>& path, DefParam* parent);
 
   ErrorContainer* m_errors;
@@ -187,6 +198,10 @@ class Design {
 
   std::map<std::string, DefParam*> m_defParams;
 
+  std::unordered_map<SymbolId, DefParam*> m_defParamIds;
+
+  unsigned int m_defParamGeneration;
+
   PackageNamePackageDefinitionMultiMap m_packageDefinitions;
   
   PackageDefinitionVec m_orderedPackageDefinitions;
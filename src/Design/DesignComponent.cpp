@@ -27,9 +27,40 @@
 #include "Design/DesignComponent.h"
 #include "Design/Function.h"
 #include "Testbench/Variable.h"
+#include "Expression/ExprBuilder.h"
 
 using namespace SURELOG;
 
+Value* DesignComponent::getValue(const std::string& name) {
+  std::map<std::string, Value*>::iterator itr = m_paramMap.find(name);
+  if (itr == m_paramMap.end()) {
+    if (getParentScope()) {
+      return getParentScope()->getValue(name);
+    } else
+      return NULL;
+  } else {
+    return (*itr).second;
+  }
+}
+
+void DesignComponent::setValue(const std::string& name, Value* val,
+                               ExprBuilder& exprBuilder) {
+  m_paramValues.push_back(val);
+  std::map<std::string, Value*>::iterator itr = m_paramMap.find(name);
+  if (itr == m_paramMap.end()) {
+    m_paramMap.insert(std::make_pair(name, val));
+  } else {
+    exprBuilder.deleteValue((*itr).second);
+    (*itr).second = val;
+  }
+}
+
+void DesignComponent::copyValue(const std::string& name, Value* val,
+                                ExprBuilder& exprBuilder) {
+  // The values are also listed in m_paramValues, they are not overwritten
+  setValue(name, exprBuilder.clone(val), exprBuilder);
+}
+
 void DesignComponent::addFileContent(FileContent* fileContent, NodeId nodeId) {
   bool add = true;
   for (auto f : m_fileContents)
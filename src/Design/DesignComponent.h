@@ -48,6 +48,14 @@ class DesignComponent : public ValuedComponentI {
   virtual std::string getName() = 0;
   void append(DesignComponent*);
 
+  Value* getValue(const std::string& name) override;
+  void setValue(const std::string& name, Value* val,
+                ExprBuilder& exprBuilder) override;
+  void copyValue(const std::string& name, Value* val,
+                 ExprBuilder& exprBuilder) override;
+  std::vector<Value*>& getValues() { return m_paramValues; }
+  std::map<std::string, Value*>& getMappedValues() { return m_paramMap; }
+
   typedef std::map<std::string, DataType*> DataTypeMap;
   typedef std::map<std::string, TypeDef*> TypeDefMap;
   typedef std::map<std::string, Function*> FunctionMap;
@@ -107,6 +115,8 @@ class DesignComponent : public ValuedComponentI {
   TypeDefMap m_typedefs;
   std::vector<Package*> m_packages;
   VariableMap m_variables;
+  std::vector<Value*> m_paramValues;
+  std::map<std::string, Value*> m_paramMap;
 };
 
 };  // namespace SURELOG
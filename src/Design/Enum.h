@@ -35,7 +35,7 @@ class FileContent;
 class Enum : public DataType {
  public:
   Enum(std::string name, FileContent* fC, NodeId nodeId, VObjectType baseType);
-  void addValue(std::string& name, Value* value) {
+  void addValue(const std::string& name, Value* value) {
     m_values.insert(std::make_pair(name, value));
   }
   Value* getValue(std::string& name);
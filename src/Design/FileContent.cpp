@@ -27,14 +27,24 @@
 #include "Library/Library.h"
 #include "ErrorReporting/ErrorContainer.h"
 #include "Design/FileContent.h"
+#include <algorithm>
 #include <queue>
 #include <iostream>
 #include <stack>
 #include <string.h>
 
+// AVX2 kernels are compiled through target attributes and picked at run
+// time, the build needs no architecture flag
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define SL_VECTOR_KERNELS 1
+#include <immintrin.h>
+#else
+#define SL_VECTOR_KERNELS 0
+#endif
+
 using namespace SURELOG;
 
-FileContent::~FileContent() {}
+FileContent::~FileContent() { delete m_index.load(); }
 
 NodeId FileContent::getRootNode() {
   if (m_objects.size() == 0) {
@@ -43,11 +53,59 @@ NodeId FileContent::getRootNode() {
   return m_objects[0].m_sibling;
 }
 
-SymbolId& FileContent::getFileId(NodeId id) { return m_objects[id].m_fileId; }
+unsigned short FileContent::getFileIndex(SymbolId fileId) {
+  // Nodes come in runs from the same file
+  if (m_fileIds.size() && m_fileIds[m_lastFileIndex] == fileId)
+    return m_lastFileIndex;
+  std::unordered_map<SymbolId, unsigned short>::iterator itr =
+      m_fileIndexMap.find(fileId);
+  if (itr != m_fileIndexMap.end()) {
+    m_lastFileIndex = (*itr).second;
+  } else if (m_fileIds.size() > MaxFileIndex) {
+    // VObject::m_fileIndex is 16 bits
+    if (!m_fileIndexOverflow && m_errors) {
+      Location loc(m_fileId);
+      Error err(ErrorDefinition::PA_TOO_MANY_FILES, loc);
+      m_errors->addError(err);
+    }
+    m_fileIndexOverflow = true;
+    m_lastFileIndex = 0;
+  } else {
+    m_lastFileIndex = m_fileIds.size();
+    m_fileIds.push_back(fileId);
+    m_fileIndexMap.insert(std::make_pair(fileId, m_lastFileIndex));
+  }
+  return m_lastFileIndex;
+}
+
+void FileContent::reportNameOverflow_() {
+  if (!m_nameOverflow && m_errors) {
+    Location loc(m_fileId);
+    Error err(ErrorDefinition::PA_TOO_MANY_SYMBOLS, loc);
+    m_errors->addError(err);
+  }
+  m_nameOverflow = true;
+}
+
+void FileContent::setFileIdTable(const std::vector<SymbolId>& fileIds) {
+  m_fileIds = fileIds;
+  m_fileIndexMap.clear();
+  if (m_fileIds.size() > MaxFileIndex + 1) {
+    if (!m_fileIndexOverflow && m_errors) {
+      Location loc(m_fileId);
+      Error err(ErrorDefinition::PA_TOO_MANY_FILES, loc);
+      m_errors->addError(err);
+    }
+    m_fileIndexOverflow = true;
+    m_fileIds.resize(MaxFileIndex + 1);
+  }
+  for (unsigned int i = 0; i < m_fileIds.size(); i++)
+    m_fileIndexMap.insert(std::make_pair(m_fileIds[i], (unsigned short)i));
+  m_lastFileIndex = 0;
+}
 
-std::string FileContent::getFileName(NodeId id) {
-  SymbolId fileId = m_objects[id].m_fileId;
-  return m_symbolTable->getSymbol(fileId);
+const std::string& FileContent::getFileName(NodeId id) {
+  return m_symbolTable->getSymbol(getFileId(id));
 }
 
 std::string FileContent::printObjects() {
@@ -180,11 +238,11 @@ VObject& FileContent::Object(NodeId index) { return m_objects[index]; }
 
 NodeId FileContent::UniqueId(NodeId index) { return index; }
 
-SymbolId& FileContent::Name(NodeId index) { return m_objects[index].m_name; }
+SymbolId FileContent::Name(NodeId index) { return m_objects[index].m_name; }
 
-NodeId& FileContent::Child(NodeId index) { return m_objects[index].m_child; }
+NodeId FileContent::Child(NodeId index) { return m_objects[index].m_child; }
 
-NodeId& FileContent::Sibling(NodeId index) {
+NodeId FileContent::Sibling(NodeId index) {
   return m_objects[index].m_sibling;
 }
 
@@ -198,22 +256,285 @@ VObjectType FileContent::Type(NodeId index) {
   return (VObjectType)m_objects[index].m_type;
 }
 
+void FileContent::setType(NodeId index, VObjectType type) {
+  VObject& object = m_objects[index];
+  if (object.m_type == type) return;
+  m_indexMutex.lock();
+  SearchIndex* searchIndex = m_index.load(std::memory_order_relaxed);
+  if (searchIndex && index < searchIndex->m_size &&
+      searchIndex->m_preOrder[searchIndex->m_preOrderPos[index]] == index) {
+    // Moves the node position from the old type postings to the new ones
+    std::vector<std::vector<unsigned int>>& postings = searchIndex->m_postings;
+    unsigned int pos = searchIndex->m_preOrderPos[index];
+    std::vector<unsigned int>& from = postings[object.m_type];
+    from.erase(std::lower_bound(from.begin(), from.end(), pos));
+    if ((unsigned int)type >= postings.size()) postings.resize(type + 1);
+    std::vector<unsigned int>& to = postings[type];
+    to.insert(std::lower_bound(to.begin(), to.end(), pos), pos);
+    searchIndex->m_preOrderTypes[pos] = type;
+  }
+  object.m_type = type;
+  m_indexMutex.unlock();
+}
+
 unsigned int& FileContent::Line(NodeId index) {
   return m_objects[index].m_line;
 }
 
+static VObjectTypeSet typeSet(const std::vector<VObjectType>& types) {
+  VObjectTypeSet set;
+  for (auto type : types) set.set(type);
+  return set;
+}
+
+void FileContent::buildIndex_(SearchIndex& index) {
+  unsigned int size = m_objects.size();
+  index.m_preOrder.reserve(size);
+  index.m_preOrderPos.assign(size, 0);
+  index.m_chainSize.assign(size, 0);
+  index.m_preOrderTypes.reserve(size);
+  // Roots are the nodes nobody points to
+  std::vector<bool> linked(size, false);
+  for (const VObject& object : m_objects) {
+    if (object.m_child && object.m_child < size) linked[object.m_child] = true;
+    if (object.m_sibling && object.m_sibling < size)
+      linked[object.m_sibling] = true;
+  }
+  std::vector<bool> visited(size, false);
+  std::stack<NodeId> stack;
+  for (NodeId root = 0; root < size; root++) {
+    if (linked[root]) continue;
+    stack.push(root);
+    while (stack.size()) {
+      NodeId id = stack.top();
+      stack.pop();
+      if (visited[id]) continue;
+      visited[id] = true;
+      const VObject& current = m_objects[id];
+      index.m_preOrderPos[id] = index.m_preOrder.size();
+      index.m_preOrder.push_back(id);
+      index.m_preOrderTypes.push_back(current.m_type);
+      if (current.m_type >= index.m_postings.size())
+        index.m_postings.resize(current.m_type + 1);
+      index.m_postings[current.m_type].push_back(index.m_preOrderPos[id]);
+      if (current.m_sibling && current.m_sibling < size)
+        stack.push(current.m_sibling);
+      if (current.m_child && current.m_child < size)
+        stack.push(current.m_child);
+    }
+  }
+  // Child and sibling are always after their node in pre-order
+  index.m_childSpan.assign(index.m_preOrder.size(), 0);
+  for (unsigned int pos = index.m_preOrder.size(); pos > 0; pos--) {
+    NodeId id = index.m_preOrder[pos - 1];
+    const VObject& current = m_objects[id];
+    unsigned int chainSize = 1;
+    if (current.m_child && current.m_child < size &&
+        index.m_preOrderPos[current.m_child] > pos - 1) {
+      index.m_childSpan[pos - 1] = index.m_chainSize[current.m_child];
+      chainSize += index.m_childSpan[pos - 1];
+    }
+    if (current.m_sibling && current.m_sibling < size &&
+        index.m_preOrderPos[current.m_sibling] > pos - 1)
+      chainSize += index.m_chainSize[current.m_sibling];
+    index.m_chainSize[id] = chainSize;
+  }
+}
+
+const FileContent::SearchIndex* FileContent::checkIndex_() {
+  // Nodes appended since the index was built make it stale
+  SearchIndex* index = m_index.load(std::memory_order_acquire);
+  if (index && index->m_size == m_objects.size()) return index;
+  m_indexMutex.lock();
+  index = m_index.load(std::memory_order_relaxed);
+  if (index == NULL || index->m_size != m_objects.size()) {
+    delete index;
+    index = new SearchIndex();
+    buildIndex_(*index);
+    index->m_size = m_objects.size();
+    m_index.store(index, std::memory_order_release);
+  }
+  m_indexMutex.unlock();
+  return index;
+}
+
+void FileContent::clearIndex() {
+  if (m_index.load(std::memory_order_acquire) == NULL) return;
+  m_indexMutex.lock();
+  delete m_index.exchange(NULL);
+  m_indexMutex.unlock();
+}
+
+void FileContent::collectRange_(const SearchIndex& index, VObjectType type,
+                                unsigned int from, unsigned int to, bool first,
+                                std::vector<unsigned int>& positions) {
+  if ((unsigned int)type >= index.m_postings.size()) return;
+  const std::vector<unsigned int>& posting = index.m_postings[type];
+  for (auto itr = std::lower_bound(posting.begin(), posting.end(), from);
+       itr != posting.end() && *itr < to; itr++) {
+    positions.push_back(*itr);
+    if (first) return;
+  }
+}
+
+static const unsigned int NbTypeWords = 4096 / 32;
+static const unsigned int VectorMinRange = 32;
+
+/* Type set as 32 bits words, the layout the vector kernels gather from */
+static void typeWords(const VObjectTypeSet& set, uint32_t* words) {
+  memset(words, 0, NbTypeWords * sizeof(uint32_t));
+#if defined(__GLIBCXX__)
+  for (size_t type = set._Find_first(); type < set.size();
+       type = set._Find_next(type))
+    words[type >> 5] |= 1u << (type & 31);
+#else
+  for (size_t type = 0; type < set.size(); type++)
+    if (set[type]) words[type >> 5] |= 1u << (type & 31);
+#endif
+}
+
+#if SL_VECTOR_KERNELS
+/* Mask of the 8 nodes at pos whose type is in the set */
+__attribute__((target("avx2"))) static inline unsigned int typeMask8(
+    const unsigned short* nodeTypes, unsigned int pos, const uint32_t* words) {
+  const __m256i one = _mm256_set1_epi32(1);
+  __m256i types = _mm256_cvtepu16_epi32(
+      _mm_loadu_si128((const __m128i*)(nodeTypes + pos)));
+  __m256i word = _mm256_i32gather_epi32((const int*)words,
+                                        _mm256_srli_epi32(types, 5), 4);
+  __m256i bit = _mm256_and_si256(
+      _mm256_srlv_epi32(word,
+                        _mm256_and_si256(types, _mm256_set1_epi32(31))),
+      one);
+  return _mm256_movemask_ps(
+      _mm256_castsi256_ps(_mm256_cmpeq_epi32(bit, one)));
+}
+
+/* Appends the positions in [from, to) whose type is in the set, returns
+   the new count */
+__attribute__((target("avx2"))) static size_t compactAvx2(
+    const unsigned short* nodeTypes, const uint32_t* words, unsigned int from,
+    unsigned int to, unsigned int* out, size_t count) {
+  unsigned int pos = from;
+  for (; pos + 8 <= to; pos += 8) {
+    unsigned int mask = typeMask8(nodeTypes, pos, words);
+    while (mask) {
+      out[count++] = pos + __builtin_ctz(mask);
+      mask &= mask - 1;
+    }
+  }
+  for (; pos < to; pos++) {
+    unsigned short type = nodeTypes[pos];
+    out[count] = pos;
+    count += (words[type >> 5] >> (type & 31)) & 1;
+  }
+  return count;
+}
+
+/* First position in [from, to) whose type is in the set, to if none */
+__attribute__((target("avx2"))) static unsigned int nextHitAvx2(
+    const unsigned short* nodeTypes, const uint32_t* words, unsigned int from,
+    unsigned int to) {
+  unsigned int pos = from;
+  for (; pos + 8 <= to; pos += 8) {
+    unsigned int mask = typeMask8(nodeTypes, pos, words);
+    if (mask) return pos + __builtin_ctz(mask);
+  }
+  for (; pos < to; pos++) {
+    unsigned short type = nodeTypes[pos];
+    if ((words[type >> 5] >> (type & 31)) & 1) return pos;
+  }
+  return to;
+}
+
+static bool detectVectorKernels() {
+  __builtin_cpu_init();
+  return __builtin_cpu_supports("avx2");
+}
+bool FileContent::m_vectorKernels = detectVectorKernels();
+#else
+bool FileContent::m_vectorKernels = false;
+#endif
+
+void FileContent::useVectorKernels(bool use) {
+#if SL_VECTOR_KERNELS
+  m_vectorKernels = use && detectVectorKernels();
+#else
+  (void)use;
+#endif
+}
+
+void FileContent::scanRange_(const SearchIndex& index,
+                             const VObjectTypeSet& types,
+                             const VObjectTypeSet& stopPoints,
+                             unsigned int from, unsigned int to, bool first,
+                             std::vector<unsigned int>& positions) {
+  const unsigned short* nodeTypes = index.m_preOrderTypes.data();
+  const unsigned int* childSpans = index.m_childSpan.data();
+#if SL_VECTOR_KERNELS
+  // Short ranges do not pay for the word conversion of the sets
+  if (m_vectorKernels && to - from >= VectorMinRange) {
+    uint32_t typeBits[NbTypeWords];
+    typeWords(types, typeBits);
+    if (stopPoints.none() && !first) {
+      size_t count = positions.size();
+      positions.resize(count + (to - from));
+      count = compactAvx2(nodeTypes, typeBits, from, to, positions.data(),
+                          count);
+      positions.resize(count);
+      return;
+    }
+    // Skips to the next node that matches or stops, the scalar code
+    // handles that node
+    uint32_t hitBits[NbTypeWords];
+    typeWords(types | stopPoints, hitBits);
+    for (unsigned int pos = nextHitAvx2(nodeTypes, hitBits, from, to);
+         pos < to; pos = nextHitAvx2(nodeTypes, hitBits, pos + 1, to)) {
+      unsigned short type = nodeTypes[pos];
+      if (types[type]) {
+        positions.push_back(pos);
+        if (first) return;
+      }
+      if (stopPoints[type]) pos += childSpans[pos];
+    }
+    return;
+  }
+#endif
+  if (stopPoints.none() && !first) {
+    // Branch free compaction of the matching positions
+    size_t count = positions.size();
+    positions.resize(count + (to - from));
+    unsigned int* out = positions.data();
+    for (unsigned int pos = from; pos < to; pos++) {
+      out[count] = pos;
+      count += types[nodeTypes[pos]];
+    }
+    positions.resize(count);
+    return;
+  }
+  for (unsigned int pos = from; pos < to; pos++) {
+    unsigned short type = nodeTypes[pos];
+    if (types[type]) {
+      positions.push_back(pos);
+      if (first) return;
+    }
+    // The subtree below a stop point is made of the next childSpan nodes
+    if (stopPoints[type]) pos += childSpans[pos];
+  }
+}
+
 NodeId FileContent::sl_get(NodeId parent, VObjectType type) {
   if (!m_objects.size()) return 0;
   if (parent > m_objects.size() - 1) return 0;
-  VObject current = Object(parent);
-  if (current.m_type == type) return parent;
-  NodeId id = current.m_child;
+  const VObject* current = &m_objects[parent];
+  if (current->m_type == type) return parent;
+  NodeId id = current->m_child;
   while (id) {
-    current = Object(id);
-    if (current.m_type == type) {
+    current = &m_objects[id];
+    if (current->m_type == type) {
       return id;
     }
-    id = current.m_sibling;
+    id = current->m_sibling;
   }
   return InvalidNodeId;
 }
@@ -222,37 +543,31 @@ NodeId FileContent::sl_parent(NodeId parent, std::vector<VObjectType> types,
                               VObjectType& actualType) {
   if (!m_objects.size()) return 0;
   if (parent > m_objects.size() - 1) return 0;
-  VObject current = Object(parent);
-  for (auto type : types)
-    if (current.m_type == type) {
-      actualType = type;
-      return parent;
+  VObjectTypeSet set = typeSet(types);
+  NodeId id = parent;
+  do {
+    const VObject& current = m_objects[id];
+    if (set.test(current.m_type)) {
+      actualType = (VObjectType)current.m_type;
+      return id;
     }
-  NodeId id = current.m_parent;
-  while (id) {
-    current = Object(id);
-    for (auto type : types)
-      if (current.m_type == type) {
-        actualType = type;
-        return id;
-      }
     id = current.m_parent;
-  }
+  } while (id);
   return InvalidNodeId;
 }
 
 NodeId FileContent::sl_parent(NodeId parent, VObjectType type) {
   if (!m_objects.size()) return 0;
   if (parent > m_objects.size() - 1) return 0;
-  VObject current = Object(parent);
-  if (current.m_type == type) return parent;
-  NodeId id = current.m_parent;
+  const VObject* current = &m_objects[parent];
+  if (current->m_type == type) return parent;
+  NodeId id = current->m_parent;
   while (id) {
-    current = Object(id);
-    if (current.m_type == type) {
+    current = &m_objects[id];
+    if (current->m_type == type) {
       return id;
     }
-    id = current.m_parent;
+    id = current->m_parent;
   }
   return InvalidNodeId;
 }
@@ -261,15 +576,15 @@ std::vector<NodeId> FileContent::sl_get_all(NodeId parent, VObjectType type) {
   std::vector<NodeId> objects;
   if (!m_objects.size()) return objects;
   if (parent > m_objects.size() - 1) return objects;
-  VObject current = Object(parent);
-  if (current.m_type == type) objects.push_back(parent);
-  NodeId id = current.m_child;
+  const VObject* current = &m_objects[parent];
+  if (current->m_type == type) objects.push_back(parent);
+  NodeId id = current->m_child;
   while (id) {
-    current = Object(id);
-    if (current.m_type == type) {
+    current = &m_objects[id];
+    if (current->m_type == type) {
       objects.push_back(id);
     }
-    id = current.m_sibling;
+    id = current->m_sibling;
   }
   return objects;
 }
@@ -279,24 +594,14 @@ std::vector<NodeId> FileContent::sl_get_all(NodeId parent,
   std::vector<NodeId> objects;
   if (!m_objects.size()) return objects;
   if (parent > m_objects.size() - 1) return objects;
-  VObject current = Object(parent);
-  for (auto type : types) {
-    if (current.m_type == type) {
-      objects.push_back(parent);
-      break;
-    }
-  }
-
-  NodeId id = current.m_child;
+  VObjectTypeSet set = typeSet(types);
+  const VObject* current = &m_objects[parent];
+  if (set.test(current->m_type)) objects.push_back(parent);
+  NodeId id = current->m_child;
   while (id) {
-    current = Object(id);
-    for (auto type : types) {
-      if (current.m_type == type) {
-        objects.push_back(id);
-        break;
-      }
-    }
-    id = current.m_sibling;
+    current = &m_objects[id];
+    if (set.test(current->m_type)) objects.push_back(id);
+    id = current->m_sibling;
   }
   return objects;
 }
@@ -304,21 +609,16 @@ std::vector<NodeId> FileContent::sl_get_all(NodeId parent,
 NodeId FileContent::sl_collect(NodeId parent, VObjectType type) {
   if (!m_objects.size()) return 0;
   if (parent > m_objects.size() - 1) return 0;
-  VObject current = Object(parent);
-  if (current.m_type == type) return parent;
-  NodeId id = current.m_child;
-  while (id) {
-    NodeId idsub = sl_collect(id, type);
-    if (idsub != InvalidNodeId) {
-      return idsub;
-    }
-    current = Object(id);
-    if (current.m_type == type) {
-      return id;
-    }
-    id = current.m_sibling;
-  }
-  return InvalidNodeId;
+  const SearchIndex* index = checkIndex_();
+  // The subtree of parent is parent followed by the chain of its first child
+  unsigned int from = index->m_preOrderPos[parent];
+  unsigned int to = from + 1;
+  NodeId child = m_objects[parent].m_child;
+  if (child) to += index->m_chainSize[child];
+  std::vector<unsigned int> positions;
+  collectRange_(*index, type, from, to, true, positions);
+  if (positions.empty()) return InvalidNodeId;
+  return index->m_preOrder[positions[0]];
 }
 
 std::vector<NodeId> FileContent::sl_collect_all(NodeId parent, VObjectType type,
@@ -326,23 +626,18 @@ std::vector<NodeId> FileContent::sl_collect_all(NodeId parent, VObjectType type,
   std::vector<NodeId> objects;
   if (!m_objects.size()) return objects;
   if (parent > m_objects.size() - 1) return objects;
-  VObject current = Object(parent);
+  const VObject& current = m_objects[parent];
   NodeId id = current.m_child;
   if (!id) id = current.m_sibling;
   if (!id) return objects;
-  std::stack<NodeId> stack;
-  stack.push(id);
-  while (stack.size()) {
-    id = stack.top();
-    stack.pop();
-    current = Object(id);
-    if (current.m_type == type) {
-      objects.push_back(id);
-      if (first) return objects;
-    }
-    if (current.m_sibling) stack.push(current.m_sibling);
-    if (current.m_child) stack.push(current.m_child);
-  }
+  const SearchIndex* index = checkIndex_();
+  // The search covers id, its siblings and all their subtrees
+  unsigned int from = index->m_preOrderPos[id];
+  std::vector<unsigned int> positions;
+  collectRange_(*index, type, from, from + index->m_chainSize[id], first,
+                positions);
+  objects.reserve(positions.size());
+  for (unsigned int pos : positions) objects.push_back(index->m_preOrder[pos]);
   return objects;
 }
 
@@ -352,28 +647,25 @@ std::vector<NodeId> FileContent::sl_collect_all(NodeId parent,
   std::vector<NodeId> objects;
   if (!m_objects.size()) return objects;
   if (parent > m_objects.size() - 1) return objects;
-  VObject current = Object(parent);
+  const VObject& current = m_objects[parent];
   NodeId id = current.m_child;
   if (!id) id = current.m_sibling;
   if (!id) return objects;
-  std::stack<NodeId> stack;
-  stack.push(id);
-  while (stack.size()) {
-    id = stack.top();
-    stack.pop();
-    current = Object(id);
-    // std::cout << "COLLECT:" << current.print (m_symbolTable, id,
-    // GetDefinitionFile(id)) << std::endl;
-    for (auto type : types) {
-      if (current.m_type == type) {
-        objects.push_back(id);
-        if (first) return objects;
-        break;
-      }
-    }
-    if (current.m_sibling) stack.push(current.m_sibling);
-    if (current.m_child) stack.push(current.m_child);
+  const SearchIndex* index = checkIndex_();
+  unsigned int from = index->m_preOrderPos[id];
+  unsigned int to = from + index->m_chainSize[id];
+  VObjectTypeSet set = typeSet(types);
+  std::vector<unsigned int> positions;
+  for (auto type : types) {
+    if (!set.test(type)) continue;  // Duplicated type
+    set.reset(type);
+    collectRange_(*index, type, from, to, first, positions);
   }
+  // Results are returned in tree order
+  std::sort(positions.begin(), positions.end());
+  if (first && positions.size()) positions.resize(1);
+  objects.reserve(positions.size());
+  for (unsigned int pos : positions) objects.push_back(index->m_preOrder[pos]);
   return objects;
 }
 
@@ -382,72 +674,56 @@ NodeId FileContent::sl_collect(NodeId parent, VObjectType type,
   NodeId result = InvalidNodeId;
   if (!m_objects.size()) return result;
   if (parent > m_objects.size() - 1) return result;
-  VObject current = Object(parent);
+  const VObject& current = m_objects[parent];
   NodeId id = current.m_child;
   if (!id) id = current.m_sibling;
   if (!id) return result;
-  std::stack<NodeId> stack;
-  stack.push(id);
-  while (stack.size()) {
-    id = stack.top();
-    stack.pop();
-    current = Object(id);
-    if (current.m_type == type) {
-      return id;
-    }
-
-    if (current.m_sibling) stack.push(current.m_sibling);
-
-    if (current.m_child) {
-      if (stopPoint != current.m_type)
-        if (current.m_child) stack.push(current.m_child);
-    }
-  }
+  const SearchIndex* index = checkIndex_();
+  VObjectTypeSet types;
+  types.set(type);
+  VObjectTypeSet stopPoints;
+  stopPoints.set(stopPoint);
+  unsigned int from = index->m_preOrderPos[id];
+  std::vector<unsigned int> positions;
+  scanRange_(*index, types, stopPoints, from, from + index->m_chainSize[id],
+             true, positions);
+  if (positions.size()) result = index->m_preOrder[positions[0]];
   return result;
 }
 
 std::vector<NodeId> FileContent::sl_collect_all(
     NodeId parent, std::vector<VObjectType>& types,
     std::vector<VObjectType>& stopPoints, bool first) {
-  std::vector<NodeId> objects;
+  if (stopPoints.empty()) return sl_collect_all(parent, types, first);
+  std::vector<NodeId> parents(1, parent);
+  std::vector<std::vector<NodeId>> objects =
+      sl_collect_all(parents, types, stopPoints, first);
+  return objects[0];
+}
+
+std::vector<std::vector<NodeId>> FileContent::sl_collect_all(
+    const std::vector<NodeId>& parents, std::vector<VObjectType>& types,
+    std::vector<VObjectType>& stopPoints, bool first) {
+  std::vector<std::vector<NodeId>> objects(parents.size());
   if (!m_objects.size()) return objects;
-  if (parent > m_objects.size() - 1) return objects;
-  VObject current = Object(parent);
-  NodeId id = current.m_child;
-  if (!id) id = current.m_sibling;
-  if (!id) return objects;
-  std::stack<NodeId> stack;
-  stack.push(id);
-  while (stack.size()) {
-    id = stack.top();
-    stack.pop();
-    current = Object(id);
-    // std::cout << "COLLECT:" << current.print (m_symbolTable, id,
-    // GetDefinitionFile(id)) << std::endl;
-    for (auto type : types) {
-      if (current.m_type == type) {
-        objects.push_back(id);
-        if (first) return objects;
-        break;
-      }
-    }
-    if (current.m_sibling) stack.push(current.m_sibling);
-
-    if (current.m_child) {
-      if (stopPoints.size()) {
-        bool stop = false;
-        for (auto t : stopPoints) {
-          if (t == current.m_type) {
-            stop = true;
-            break;
-          }
-        }
-        if (!stop)
-          if (current.m_child) stack.push(current.m_child);
-      } else {
-        if (current.m_child) stack.push(current.m_child);
-      }
-    }
+  const SearchIndex* index = checkIndex_();
+  VObjectTypeSet typeBits = typeSet(types);
+  VObjectTypeSet stopBits = typeSet(stopPoints);
+  std::vector<unsigned int> positions;
+  for (unsigned int i = 0; i < parents.size(); i++) {
+    NodeId parent = parents[i];
+    if (parent > m_objects.size() - 1) continue;
+    const VObject& current = m_objects[parent];
+    NodeId id = current.m_child;
+    if (!id) id = current.m_sibling;
+    if (!id) continue;
+    unsigned int from = index->m_preOrderPos[id];
+    positions.clear();
+    scanRange_(*index, typeBits, stopBits, from,
+               from + index->m_chainSize[id], first, positions);
+    objects[i].reserve(positions.size());
+    for (unsigned int pos : positions)
+      objects[i].push_back(index->m_preOrder[pos]);
   }
   return objects;
 }
@@ -23,8 +23,14 @@
 
 #ifndef FILECONTENT_H
 #define FILECONTENT_H
+#include <algorithm>
+#include <atomic>
+#include <bitset>
+#include <mutex>
 #include <vector>
 #include <map>
+#include <set>
+#include <unordered_map>
 #include <unordered_set>
 #include "Design/TimeInfo.h"
 #include "Design/DesignElement.h"
@@ -53,6 +59,9 @@ typedef std::multimap<std::string, ClassDefinition*>
     ClassNameClassDefinitionMultiMap;
 typedef std::map<std::string, ClassDefinition*> ClassNameClassDefinitionMap;
 
+/* Node types fit on 12 bits (see the legacy cache encoding) */
+typedef std::bitset<4096> VObjectTypeSet;
+
 class FileContent : public DesignComponent {
  public:
   FileContent(SymbolId fileId, Library* library, SymbolTable* symbolTable,
@@ -63,7 +72,13 @@ class FileContent : public DesignComponent {
         m_symbolTable(symbolTable),
         m_errors(errors),
         m_parentFile(parent),
-        m_fileChunkId(fileChunkId) {}
+        m_fileChunkId(fileChunkId),
+        m_lastFileIndex(0),
+        m_fileIndexOverflow(false),
+        m_nameOverflow(false),
+        m_index(NULL) {
+    getFileIndex(fileId);
+  }
   void setLibrary(Library* lib) { m_library = lib; }
   ~FileContent() override;
 
@@ -107,6 +122,20 @@ class FileContent : public DesignComponent {
                                      bool first = false);
   // Recursively search for all items of types
   // and stops at types stopPoints
+
+  std::vector<std::vector<NodeId>> sl_collect_all(
+      const std::vector<NodeId>& parents, std::vector<VObjectType>& types,
+      std::vector<VObjectType>& stopPoints, bool first = false);
+  // Same search for a batch of parents, one result per parent
+
+  /* The recursive searches use a pre-order index of the tree, built on first
+     use and rebuilt when nodes were added since. Child and Sibling are read
+     only and setType keeps the index current; code linking the nodes
+     through getVObjects (the parse listeners) has to clear it */
+  void clearIndex();
+  /* The searches with type sets scan with AVX2 kernels when the CPU has
+     them, the scalar code is used otherwise or when turned off here */
+  static void useVectorKernels(bool use);
   unsigned int getSize() override;
   VObjectType getType() override { return VObjectType::slNoType; }
   bool isInstance() override { return false; }
@@ -115,13 +144,31 @@ class FileContent : public DesignComponent {
   std::string printObjects();                    // The whole file content
   std::string printSubTree(NodeId parentIndex);  // Print subtree from parent
   std::vector<std::string> collectSubTree(NodeId uniqueId);  // Helper function
-  std::string getFileName(NodeId id);
-  std::string getChunkFileName() {
+  const std::string& getFileName(NodeId id);
+  const std::string& getChunkFileName() {
     return m_symbolTable->getSymbol(m_fileChunkId);
   }
   SymbolTable* getSymbolTable() { return m_symbolTable; }
   void setSymbolTable(SymbolTable* table) { m_symbolTable = table; }
-  SymbolId& getFileId(NodeId id);
+  SymbolId getFileId(NodeId id) {
+    return m_fileIds[m_objects[id].m_fileIndex];
+  }
+  void setFileId(NodeId id, SymbolId fileId) {
+    m_objects[id].m_fileIndex = getFileIndex(fileId);
+  }
+  /* Index of a file in the file table, the VObjects store that index.
+     Past MaxFileIndex files an error is reported and the nodes are
+     attributed to the file of this FileContent */
+  static const unsigned int MaxFileIndex = 0xFFFF;
+  unsigned short getFileIndex(SymbolId fileId);
+  const std::vector<SymbolId>& getFileIdTable() { return m_fileIds; }
+  /* Name of a new node, past VObject::MaxName an error is reported and the
+     node gets the bad symbol */
+  SymbolId getNameId(SymbolId name) {
+    if (name > VObject::MaxName) reportNameOverflow_();
+    return name;
+  }
+  void setFileIdTable(const std::vector<SymbolId>& fileIds);
   Library* getLibrary() { return m_library; }
   std::vector<DesignElement>& getDesignElements() { return m_elements; }
   std::vector<VObject>& getVObjects() { return m_objects; }
@@ -130,16 +177,24 @@ class FileContent : public DesignComponent {
   std::unordered_set<std::string>& getReferencedObjects() {
     return m_referencedObjects;
   }
+  /* Packages named by a "pkg::" scope, the scope leaves no node in the tree.
+     Kept in source order, the ids of the names depend on the threads */
+  void addPackageScope(SymbolId name) {
+    if (std::find(m_packageScopes.begin(), m_packageScopes.end(), name) ==
+        m_packageScopes.end())
+      m_packageScopes.push_back(name);
+  }
+  const std::vector<SymbolId>& getPackageScopes() { return m_packageScopes; }
 
   VObject& Object(NodeId index);
 
   NodeId UniqueId(NodeId index);
 
-  SymbolId& Name(NodeId index);
+  SymbolId Name(NodeId index);
 
-  NodeId& Child(NodeId index);
+  NodeId Child(NodeId index);
 
-  NodeId& Sibling(NodeId index);
+  NodeId Sibling(NodeId index);
 
   NodeId& Definition(NodeId index);
 
@@ -149,10 +204,13 @@ class FileContent : public DesignComponent {
   NodeId& Parent(NodeId index);
 
   VObjectType Type(NodeId index);
+  /* Retypes a node, the search index is patched rather than rebuilt. Not
+     to be called while another thread searches this file */
+  void setType(NodeId index, VObjectType type);
 
   unsigned int& Line(NodeId index);
 
-  std::string SymName(NodeId index) {
+  const std::string& SymName(NodeId index) {
     return m_symbolTable->getSymbol(Name(index));
   }
 
@@ -194,7 +252,9 @@ class FileContent : public DesignComponent {
   FileContent* getParent() { return m_parentFile; }
   void setParent(FileContent* parent) { m_parentFile = parent; }
 
-  std::string getFileName() { return m_symbolTable->getSymbol(m_fileId); }
+  const std::string& getFileName() {
+    return m_symbolTable->getSymbol(m_fileId);
+  }
 
   bool diffTree(std::string& diff, NodeId id, FileContent* oFc, NodeId oId);
 
@@ -206,6 +266,7 @@ class FileContent : public DesignComponent {
 
   NameIdMap m_objectLookup;  // Populated at ResolveSymbol stage
   std::unordered_set<std::string> m_referencedObjects;
+  std::vector<SymbolId> m_packageScopes;
 
   ModuleNameModuleDefinitionMap m_moduleDefinitions;
 
@@ -221,6 +282,45 @@ class FileContent : public DesignComponent {
   ErrorContainer* m_errors;
   FileContent* m_parentFile;  // for file chunks
   SymbolId m_fileChunkId;
+  std::vector<SymbolId> m_fileIds;
+  std::unordered_map<SymbolId, unsigned short> m_fileIndexMap;
+  unsigned short m_lastFileIndex;
+  bool m_fileIndexOverflow;
+  bool m_nameOverflow;
+
+ private:
+  void reportNameOverflow_();
+  /* Search index, a side table built on the first search. It costs 22
+     bytes per node on top of the 28 of the VObject and is dropped by
+     clearIndex */
+  class SearchIndex {
+   public:
+    // Pre-order of the child/sibling tree: the subtree of a node and the
+    // subtrees of its next siblings form the range
+    // [m_preOrderPos[id], m_preOrderPos[id] + m_chainSize[id])
+    std::vector<NodeId> m_preOrder;
+    std::vector<unsigned int> m_preOrderPos;
+    std::vector<unsigned int> m_chainSize;
+    // Per pre-order position, the node type and the size of its child chain
+    std::vector<unsigned short> m_preOrderTypes;
+    std::vector<unsigned int> m_childSpan;
+    // Per type, sorted pre-order positions of the nodes of that type
+    std::vector<std::vector<unsigned int>> m_postings;
+    unsigned int m_size;  // Number of nodes the index covers
+  };
+  const SearchIndex* checkIndex_();
+  void buildIndex_(SearchIndex& index);
+  static void collectRange_(const SearchIndex& index, VObjectType type,
+                            unsigned int from, unsigned int to, bool first,
+                            std::vector<unsigned int>& positions);
+  static void scanRange_(const SearchIndex& index, const VObjectTypeSet& types,
+                         const VObjectTypeSet& stopPoints, unsigned int from,
+                         unsigned int to, bool first,
+                         std::vector<unsigned int>& positions);
+
+  std::atomic<SearchIndex*> m_index;  // Released once complete
+  static bool m_vectorKernels;
+  std::mutex m_indexMutex;  // Held while building or clearing the index
 };
 
 };  // namespace SURELOG
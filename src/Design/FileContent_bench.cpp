@@ -0,0 +1,212 @@
+/*
+ Copyright 2026 The Surelog contributors
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+/*
+ * File:   FileContent_bench.cpp
+ *
+ * Created on October 19, 2026
+ */
+
+// Times the recursive searches of FileContent on the trees of a parsed
+// design: the depth first walk the index replaced, then the index scans
+// with the scalar and the AVX2 kernels. Results are checked against the
+// walk. Example of usage:
+// cd third_party/tests/Ibex
+// FileContent-Bench -f Ibex.sl -nocache -mutestdout
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <stack>
+#include "surelog.h"
+
+using namespace SURELOG;
+
+namespace {
+
+const unsigned int NbRuns = 20;
+
+class Query {
+ public:
+  const char* m_name;
+  std::vector<NodeId> m_parents;
+  std::vector<VObjectType> m_types;
+  std::vector<VObjectType> m_stopPoints;
+};
+
+/* The depth first search the index replaced */
+std::vector<NodeId> collectDFS(FileContent* fC, NodeId parent,
+                               const std::vector<VObjectType>& types,
+                               const std::vector<VObjectType>& stopPoints) {
+  std::vector<NodeId> objects;
+  std::vector<VObject>& nodes = fC->getVObjects();
+  NodeId id = nodes[parent].m_child;
+  if (!id) id = nodes[parent].m_sibling;
+  if (!id) return objects;
+  std::stack<NodeId> stack;
+  stack.push(id);
+  while (stack.size()) {
+    id = stack.top();
+    stack.pop();
+    const VObject& current = nodes[id];
+    for (auto type : types) {
+      if (current.m_type == type) {
+        objects.push_back(id);
+        break;
+      }
+    }
+    if (current.m_sibling) stack.push(current.m_sibling);
+    bool stop = false;
+    for (auto type : stopPoints)
+      if (current.m_type == type) stop = true;
+    if (current.m_child && !stop) stack.push(current.m_child);
+  }
+  return objects;
+}
+
+/* The queries of ResolveSymbols and of the instance and defparam
+   collection of DesignElaboration */
+std::vector<Query> makeQueries(FileContent* fC) {
+  std::vector<Query> queries(3);
+  Query& units = queries[0];
+  units.m_name = "design units";
+  units.m_parents.push_back(fC->getRootNode());
+  units.m_types = {
+      VObjectType::slModule_declaration,    VObjectType::slPackage_declaration,
+      VObjectType::slConfig_declaration,    VObjectType::slUdp_declaration,
+      VObjectType::slInterface_declaration, VObjectType::slProgram_declaration,
+      VObjectType::slClass_declaration};
+  units.m_stopPoints = {
+      VObjectType::slModule_declaration, VObjectType::slPackage_declaration,
+      VObjectType::slProgram_declaration, VObjectType::slClass_declaration};
+  std::vector<VObjectType> scopes = {
+      VObjectType::slConditional_generate_construct,
+      VObjectType::slGenerate_module_conditional_statement,
+      VObjectType::slLoop_generate_construct,
+      VObjectType::slGenerate_module_loop_statement,
+      VObjectType::slPar_block,
+      VObjectType::slSeq_block,
+      VObjectType::slModule_declaration};
+  std::vector<NodeId> modules;
+  for (NodeId id : collectDFS(fC, fC->getRootNode(), units.m_types,
+                              units.m_stopPoints)) {
+    if (fC->Type(id) == VObjectType::slModule_declaration)
+      modules.push_back(id);
+  }
+  Query& instances = queries[1];
+  instances.m_name = "instances";
+  instances.m_parents = modules;
+  instances.m_types = {VObjectType::slModule_instantiation,
+                       VObjectType::slInterface_instantiation,
+                       VObjectType::slProgram_instantiation,
+                       VObjectType::slUdp_instantiation,
+                       VObjectType::slGate_instantiation};
+  instances.m_types.insert(instances.m_types.end(), scopes.begin(),
+                           scopes.end() - 1);
+  instances.m_stopPoints = scopes;
+  Query& defParams = queries[2];
+  defParams.m_name = "defparams";
+  defParams.m_parents = modules;
+  defParams.m_types = {VObjectType::slDefparam_assignment};
+  defParams.m_stopPoints = scopes;
+  return queries;
+}
+
+double elapsedMs(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(
+             std::chrono::steady_clock::now() - start)
+      .count();
+}
+
+}  // namespace
+
+int main(int argc, const char** argv) {
+  SymbolTable* symbolTable = new SymbolTable();
+  ErrorContainer* errors = new ErrorContainer(symbolTable);
+  CommandLineParser* clp =
+      new CommandLineParser(errors, symbolTable, false, false);
+  clp->noPython();
+  bool success = clp->parseCommandLine(argc, argv);
+  errors->printMessages(clp->muteStdout());
+  if (!success || clp->help()) return 1;
+  scompiler* compiler = start_compiler(clp);
+  Design* design = get_design(compiler);
+  shutdown_compiler(compiler);
+  if (design == NULL) return 1;
+
+  unsigned long nbNodes = 0;
+  unsigned long nbResults = 0;
+  unsigned int nbMismatches = 0;
+  double dfsMs = 0, indexMs = 0, scalarMs = 0, vectorMs = 0;
+  for (auto& file : design->getAllFileContents()) {
+    FileContent* fC = file.second;
+    if (fC->getVObjects().empty()) continue;
+    nbNodes += fC->getVObjects().size();
+    std::vector<Query> queries = makeQueries(fC);
+    std::vector<std::vector<std::vector<NodeId>>> expected(queries.size());
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned int run = 0; run < NbRuns; run++) {
+      for (unsigned int q = 0; q < queries.size(); q++) {
+        Query& query = queries[q];
+        expected[q].clear();
+        for (NodeId parent : query.m_parents)
+          expected[q].push_back(
+              collectDFS(fC, parent, query.m_types, query.m_stopPoints));
+      }
+    }
+    dfsMs += elapsedMs(start);
+    for (auto& results : expected)
+      for (auto& result : results) nbResults += result.size();
+
+    fC->clearIndex();
+    start = std::chrono::steady_clock::now();
+    fC->sl_collect_all(fC->getRootNode(), VObjectType::slModule_declaration);
+    indexMs += elapsedMs(start);
+
+    for (bool vectorKernels : {false, true}) {
+      FileContent::useVectorKernels(vectorKernels);
+      start = std::chrono::steady_clock::now();
+      for (unsigned int run = 0; run < NbRuns; run++) {
+        for (unsigned int q = 0; q < queries.size(); q++) {
+          Query& query = queries[q];
+          std::vector<std::vector<NodeId>> results = fC->sl_collect_all(
+              query.m_parents, query.m_types, query.m_stopPoints);
+          if (run == 0 && results != expected[q]) {
+            std::cerr << "MISMATCH: " << query.m_name << " in "
+                      << fC->getFileName() << std::endl;
+            nbMismatches++;
+          }
+        }
+      }
+      (vectorKernels ? vectorMs : scalarMs) += elapsedMs(start);
+    }
+    FileContent::useVectorKernels(true);
+    fC->clearIndex();
+  }
+
+  std::cout << std::fixed << std::setprecision(2);
+  std::cout << "Files: " << design->getAllFileContents().size()
+            << ", nodes: " << nbNodes << ", results: " << nbResults
+            << ", runs: " << NbRuns << std::endl;
+  std::cout << "Depth first walk: " << dfsMs << " ms" << std::endl;
+  std::cout << "Index build:      " << indexMs << " ms" << std::endl;
+  std::cout << "Scalar kernels:   " << scalarMs << " ms" << std::endl;
+  std::cout << "AVX2 kernels:     " << vectorMs << " ms" << std::endl;
+  delete design;
+  delete clp;
+  delete symbolTable;
+  delete errors;
+  return nbMismatches ? 1 : 0;
+}
@@ -0,0 +1,203 @@
+/*
+ Copyright 2026 The Surelog contributors
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+/*
+ * File:   FileContent_test.cpp
+ *
+ * Created on October 19, 2026
+ */
+
+#include <random>
+#include <stack>
+#include <vector>
+
+#include "SourceCompile/SymbolTable.h"
+#include "Design/FileContent.h"
+#include "gtest/gtest.h"
+
+using namespace SURELOG;
+
+namespace {
+
+const unsigned int NbTypes = 12;
+
+/* Random child/sibling tree, node 0 is the root */
+class RandomTree {
+ public:
+  RandomTree(unsigned int seed, unsigned int maxDepth)
+      : m_random(seed), m_fC(0, NULL, &m_symbols, NULL, NULL, 0) {
+    addNode_(0, 0, maxDepth);
+  }
+  FileContent& fileContent() { return m_fC; }
+  std::mt19937& random() { return m_random; }
+
+ private:
+  NodeId addNode_(NodeId parent, unsigned int depth, unsigned int maxDepth) {
+    std::vector<VObject>& objects = m_fC.getVObjects();
+    NodeId id = objects.size();
+    objects.push_back(
+        VObject(0, 0, (VObjectType)(1 + m_random() % NbTypes), 1, parent));
+    if (depth == maxDepth) return id;
+    unsigned int nbChildren = m_random() % 5;
+    NodeId previous = 0;
+    for (unsigned int i = 0; i < nbChildren; i++) {
+      NodeId child = addNode_(id, depth + 1, maxDepth);
+      if (previous)
+        objects[previous].m_sibling = child;
+      else
+        objects[id].m_child = child;
+      previous = child;
+    }
+    return id;
+  }
+
+  std::mt19937 m_random;
+  SymbolTable m_symbols;
+  FileContent m_fC;
+};
+
+/* The depth first search the index replaced */
+std::vector<NodeId> collectDFS(FileContent& fC, NodeId parent,
+                               const std::vector<VObjectType>& types,
+                               const std::vector<VObjectType>& stopPoints,
+                               bool first) {
+  std::vector<NodeId> objects;
+  std::vector<VObject>& nodes = fC.getVObjects();
+  NodeId id = nodes[parent].m_child;
+  if (!id) id = nodes[parent].m_sibling;
+  if (!id) return objects;
+  std::stack<NodeId> stack;
+  stack.push(id);
+  while (stack.size()) {
+    id = stack.top();
+    stack.pop();
+    const VObject& current = nodes[id];
+    for (auto type : types) {
+      if (current.m_type == type) {
+        objects.push_back(id);
+        if (first) return objects;
+        break;
+      }
+    }
+    if (current.m_sibling) stack.push(current.m_sibling);
+    bool stop = false;
+    for (auto type : stopPoints)
+      if (current.m_type == type) stop = true;
+    if (current.m_child && !stop) stack.push(current.m_child);
+  }
+  return objects;
+}
+
+std::vector<VObjectType> randomTypes(std::mt19937& random,
+                                     unsigned int maxSize) {
+  std::vector<VObjectType> types;
+  unsigned int size = random() % (maxSize + 1);
+  for (unsigned int i = 0; i < size; i++)
+    types.push_back((VObjectType)(1 + random() % NbTypes));
+  return types;
+}
+
+void checkAgainstDFS(bool vectorKernels) {
+  FileContent::useVectorKernels(vectorKernels);
+  for (unsigned int seed = 1; seed <= 20; seed++) {
+    RandomTree tree(seed, 6);
+    FileContent& fC = tree.fileContent();
+    std::mt19937& random = tree.random();
+    unsigned int size = fC.getVObjects().size();
+    std::vector<NodeId> parents;
+    for (unsigned int i = 0; i < 50; i++) parents.push_back(random() % size);
+    for (unsigned int query = 0; query < 20; query++) {
+      std::vector<VObjectType> types = randomTypes(random, 3);
+      if (types.empty()) types.push_back((VObjectType)1);
+      std::vector<VObjectType> stopPoints = randomTypes(random, 2);
+      bool first = random() % 4 == 0;
+      std::vector<std::vector<NodeId>> batch =
+          fC.sl_collect_all(parents, types, stopPoints, first);
+      ASSERT_EQ(batch.size(), parents.size());
+      for (unsigned int i = 0; i < parents.size(); i++) {
+        std::vector<NodeId> expected =
+            collectDFS(fC, parents[i], types, stopPoints, first);
+        ASSERT_EQ(batch[i], expected)
+            << "seed " << seed << " parent " << parents[i];
+        if (!stopPoints.empty()) {
+          ASSERT_EQ(fC.sl_collect_all(parents[i], types, stopPoints, first),
+                    expected);
+        }
+      }
+    }
+  }
+  FileContent::useVectorKernels(true);
+}
+
+}  // namespace
+
+TEST(FileContentTest, CollectMatchesDFSScalar) { checkAgainstDFS(false); }
+
+TEST(FileContentTest, CollectMatchesDFSVector) { checkAgainstDFS(true); }
+
+TEST(FileContentTest, IndexFollowsAppendedNodes) {
+  RandomTree tree(7, 3);
+  FileContent& fC = tree.fileContent();
+  std::vector<VObjectType> types(1, (VObjectType)(NbTypes + 1));
+  std::vector<VObjectType> stopPoints(1, (VObjectType)(NbTypes + 2));
+  std::vector<NodeId> parents(1, 0);
+  EXPECT_TRUE(fC.sl_collect_all(parents, types, stopPoints)[0].empty());
+  // Appends a node of a new type below the root, the index is rebuilt
+  std::vector<VObject>& objects = fC.getVObjects();
+  NodeId id = objects.size();
+  objects.push_back(VObject(0, 0, types[0], 1, 0));
+  objects[id].m_sibling = objects[0].m_child;
+  objects[0].m_child = id;
+  EXPECT_EQ(fC.sl_collect_all(parents, types, stopPoints)[0],
+            std::vector<NodeId>(1, id));
+}
+
+TEST(FileContentTest, SetTypeKeepsTheIndex) {
+  RandomTree tree(11, 5);
+  FileContent& fC = tree.fileContent();
+  std::mt19937& random = tree.random();
+  unsigned int size = fC.getVObjects().size();
+  std::vector<VObjectType> noStop;
+  // Builds the index, then retypes nodes between the searches
+  fC.sl_collect_all(0, (VObjectType)1);
+  for (unsigned int i = 0; i < 200; i++) {
+    NodeId id = 1 + random() % (size - 1);
+    fC.setType(id, (VObjectType)(1 + random() % (NbTypes + 2)));
+    NodeId parent = random() % size;
+    std::vector<VObjectType> types = randomTypes(random, 2);
+    types.push_back(fC.Type(id));
+    ASSERT_EQ(fC.sl_collect_all(parent, types, noStop, false),
+              collectDFS(fC, parent, types, noStop, false))
+        << "step " << i;
+  }
+}
+
+TEST(FileContentTest, ClearedIndexIsRebuilt) {
+  RandomTree tree(5, 4);
+  FileContent& fC = tree.fileContent();
+  std::vector<VObjectType> types(1, (VObjectType)1);
+  std::vector<VObjectType> noStop;
+  fC.sl_collect_all(0, types, noStop, false);
+  // Cuts the siblings of the first child of the root, then drops the index
+  std::vector<VObject>& objects = fC.getVObjects();
+  NodeId child = objects[0].m_child;
+  ASSERT_NE(child, 0u);
+  ASSERT_NE(objects[child].m_sibling, 0u);
+  objects[child].m_sibling = 0;
+  fC.clearIndex();
+  EXPECT_EQ(fC.sl_collect_all(0, types, noStop, false),
+            collectDFS(fC, 0, types, noStop, false));
+}
@@ -22,6 +22,8 @@
  */
 #include <string>
 #include <iostream>
+#include <algorithm>
+#include <cctype>
 #include "SourceCompile/SymbolTable.h"
 #include "Library/Library.h"
 #include "Design/FileContent.h"
@@ -32,7 +34,7 @@ using namespace SURELOG;
 ModuleInstance::ModuleInstance(DesignComponent* moduleDefinition,
                                FileContent* fileContent, NodeId nodeId,
                                ModuleInstance* parent, std::string instName,
-                               std::string modName)
+                               std::string modName, SymbolTable* symbols)
     : ValuedComponentI(parent),
       m_definition(moduleDefinition),
       m_children(NULL),
@@ -40,26 +42,226 @@ ModuleInstance::ModuleInstance(DesignComponent* moduleDefinition,
       m_fileContent(fileContent),
       m_nodeId(nodeId),
       m_parent(parent),
-      m_instName(instName),
-      m_netlist(nullptr) {
+      m_symbols(symbols),
+      m_instName(symbols->registerSymbol(instName)),
+      m_moduleName(0),
+      m_fullPathId(0),
+      m_sharedValues(NULL),
+      m_netlist(nullptr),
+      m_lazyElaborator(NULL),
+      m_defParamScope(NULL),
+      m_defParamGeneration(0),
+      m_nbArrayElements(0) {
   if (m_definition == NULL) {
-    m_instName = modName + "&" + instName;
+    m_moduleName = symbols->registerSymbol(modName);
   }
 }
 
 ModuleInstance::~ModuleInstance() {}
 
+static bool paramLess(const std::pair<const std::string*, Value*>& param,
+                      const std::string& name) {
+  return *param.first < name;
+}
+
+Value* ModuleInstance::getValue(const std::string& name) {
+  ParamVector::iterator itr = std::lower_bound(
+      m_paramValues.begin(), m_paramValues.end(), name, paramLess);
+  if (itr != m_paramValues.end() && *(*itr).first == name) {
+    return (*itr).second;
+  }
+  if (m_sharedValues) {
+    ParamVector::const_iterator shared =
+        std::lower_bound(m_sharedValues->begin(), m_sharedValues->end(), name,
+                         paramLess);
+    if (shared != m_sharedValues->end() && *(*shared).first == name)
+      return (*shared).second;
+  }
+  if (getParentScope()) return getParentScope()->getValue(name);
+  return NULL;
+}
+
+ModuleInstance::ParamVector ModuleInstance::getParamValues() {
+  if (m_sharedValues == NULL) return m_paramValues;
+  const ParamVector& shared = *m_sharedValues;
+  ParamVector values;
+  unsigned int i = 0;
+  unsigned int j = 0;
+  while (i < m_paramValues.size() || j < shared.size()) {
+    if (j == shared.size() ||
+        (i < m_paramValues.size() &&
+         *m_paramValues[i].first <= *shared[j].first)) {
+      if (j < shared.size() && *m_paramValues[i].first == *shared[j].first)
+        j++;
+      values.push_back(m_paramValues[i++]);
+    } else {
+      values.push_back(shared[j++]);
+    }
+  }
+  return values;
+}
+
+void ModuleInstance::setValue(const std::string& name, Value* val,
+                              ExprBuilder& exprBuilder) {
+  ParamVector::iterator itr = std::lower_bound(
+      m_paramValues.begin(), m_paramValues.end(), name, paramLess);
+  if (itr != m_paramValues.end() && *(*itr).first == name) {
+    exprBuilder.deleteValue((*itr).second);
+    (*itr).second = val;
+    return;
+  }
+  const std::string& interned =
+      m_symbols->getSymbol(m_symbols->registerSymbol(name));
+  m_paramValues.insert(itr, std::make_pair(&interned, val));
+}
+
+void ModuleInstance::copyValue(const std::string& name, Value* val,
+                               ExprBuilder& exprBuilder) {
+  ParamVector::iterator itr = std::lower_bound(
+      m_paramValues.begin(), m_paramValues.end(), name, paramLess);
+  if (itr != m_paramValues.end() && *(*itr).first == name &&
+      (*itr).second && (*itr).second->isLValue() &&
+      val->getType() != Value::Type::String) {
+    (*itr).second->u_plus(val);
+    return;
+  }
+  setValue(name, exprBuilder.clone(val), exprBuilder);
+}
+
 void ModuleInstance::addSubInstances(ModuleInstance** subInstances,
                                      unsigned int nbSubInstances) {
   m_children = subInstances;
   m_nbChildren = nbSubInstances;
 }
 
+void ModuleInstance::clearSubInstances() {
+  // The instances belong to the factory
+  delete[] m_children;
+  m_children = NULL;
+  m_nbChildren = 0;
+  m_arrays.clear();
+  m_nbArrayElements = 0;
+}
+
+void ModuleInstance::addInstanceArray(InstanceArray* array) {
+  m_arrays.push_back(array);
+  m_nbArrayElements += array->getSize();
+}
+
+ModuleInstance* ModuleInstance::getArrayChild_(unsigned int i) {
+  unsigned int elements = 0;
+  for (InstanceArray* array : m_arrays) {
+    unsigned int start = array->getPosition() + elements;
+    if (i < start) return m_children[i - elements];
+    if (i < start + array->getSize()) return array->getElement(i - start);
+    elements += array->getSize();
+  }
+  return m_children[i - elements];
+}
+
+InstanceArray::InstanceArray(ModuleInstance* parent, DesignComponent* definition,
+                             FileContent* fileContent, NodeId nodeId,
+                             NodeId paramOverride, Config* config,
+                             const std::string& instName,
+                             const std::string& moduleName,
+                             const std::vector<int>& from,
+                             const std::vector<int>& to, unsigned int position,
+                             LazyElaborator* elaborator)
+    : m_parent(parent),
+      m_definition(definition),
+      m_fileContent(fileContent),
+      m_nodeId(nodeId),
+      m_paramOverride(paramOverride),
+      m_config(config),
+      m_instName(instName),
+      m_moduleName(moduleName),
+      m_from(from),
+      m_to(to),
+      m_size(1),
+      m_position(position),
+      m_elaborator(elaborator) {
+  for (unsigned int i = 0; i < m_from.size(); i++)
+    m_size *= (m_to[i] - m_from[i] + 1);
+}
+
+std::string InstanceArray::getFullPathName() {
+  return m_parent->getFullPathName() + "." + m_instName;
+}
+
+std::string InstanceArray::getElementName(unsigned int index) {
+  // The last dimension varies the fastest
+  std::vector<int> indexes(m_from.size());
+  for (int i = m_from.size() - 1; i >= 0; i--) {
+    unsigned int range = m_to[i] - m_from[i] + 1;
+    indexes[i] = m_from[i] + (index % range);
+    index /= range;
+  }
+  std::string name = m_instName;
+  for (unsigned int i = 0; i < indexes.size(); i++)
+    name += std::to_string(indexes[i]);
+  return name;
+}
+
+int InstanceArray::findElement(const std::string& name) {
+  if (name.compare(0, m_instName.size(), m_instName) != 0) return -1;
+  if (name.size() == m_instName.size()) return -1;
+  if (m_from.size() == 1) {
+    if (name.size() - m_instName.size() > 9) return -1;
+    for (unsigned int i = m_instName.size(); i < name.size(); i++) {
+      if (!isdigit(name[i])) return -1;
+    }
+    unsigned long index = std::stoul(name.substr(m_instName.size()));
+    if (index < (unsigned long)m_from[0] || index > (unsigned long)m_to[0])
+      return -1;
+    index -= m_from[0];
+    // Leading zeros
+    if (getElementName(index) != name) return -1;
+    return index;
+  }
+  // The concatenated indexes of several dimensions are ambiguous
+  for (unsigned int i = 0; i < m_size; i++) {
+    if (getElementName(i) == name) return i;
+  }
+  return -1;
+}
+
+ModuleInstance* InstanceArray::getElement(unsigned int index) {
+  std::map<unsigned int, ModuleInstance*>::iterator itr =
+      m_elements.find(index);
+  if (itr != m_elements.end()) return (*itr).second;
+  if (m_elaborator == NULL) return NULL;
+  ModuleInstance* element = m_elaborator->elaborateArrayElement(this, index);
+  m_elements.insert(std::make_pair(index, element));
+  return element;
+}
+
+ModuleInstanceFactory::ModuleInstanceFactory(SymbolTable* symbols)
+    : m_symbols(symbols), m_used(ChunkSize) {}
+
+ModuleInstanceFactory::~ModuleInstanceFactory() {
+  for (unsigned int i = 0; i < m_chunks.size(); i++) {
+    unsigned int nb = (i == m_chunks.size() - 1) ? m_used : ChunkSize;
+    for (unsigned int j = 0; j < nb; j++) {
+      m_chunks[i][j].~ModuleInstance();
+    }
+    ::operator delete(m_chunks[i]);
+  }
+}
+
 ModuleInstance* ModuleInstanceFactory::newModuleInstance(
     DesignComponent* moduleDefinition, FileContent* fileContent, NodeId nodeId,
     ModuleInstance* parent, std::string instName, std::string modName) {
-  return new ModuleInstance(moduleDefinition, fileContent, nodeId, parent,
-                            instName, modName);
+  m_mutex.lock();
+  if (m_used == ChunkSize) {
+    m_chunks.push_back(static_cast<ModuleInstance*>(
+        ::operator new(ChunkSize * sizeof(ModuleInstance))));
+    m_used = 0;
+  }
+  void* slot = m_chunks.back() + m_used;
+  m_used++;
+  m_mutex.unlock();
+  return new (slot) ModuleInstance(moduleDefinition, fileContent, nodeId,
+                                   parent, instName, modName, m_symbols);
 }
 
 VObjectType ModuleInstance::getType() { return m_fileContent->Type(m_nodeId); }
@@ -76,32 +278,40 @@ unsigned int ModuleInstance::getLineNb() {
   return m_fileContent->Line(m_nodeId);
 }
 
+SymbolId ModuleInstance::getFullPathId_() {
+  SymbolId id = m_fullPathId.load();
+  if (id) return id;
+  std::string path;
+  if (m_parent) path = m_parent->getFullPathName() + ".";
+  path += getInstanceName();
+  id = m_symbols->registerSymbol(path);
+  m_fullPathId.store(id);
+  return id;
+}
+
+void ModuleInstance::resetFullPath_() {
+  m_fullPathId.store(0);
+  setDefParamScope(NULL, 0);
+  for (unsigned int i = 0; i < m_nbChildren; i++) {
+    m_children[i]->resetFullPath_();
+  }
+}
+
 SymbolId ModuleInstance::getFullPathId(SymbolTable* symbols) {
+  if (symbols == m_symbols) return getFullPathId_();
   return symbols->registerSymbol(getFullPathName());
 }
 
 SymbolId ModuleInstance::getInstanceId(SymbolTable* symbols) {
+  if (symbols == m_symbols) return m_instName;
   return symbols->registerSymbol(getInstanceName());
 }
 SymbolId ModuleInstance::getModuleNameId(SymbolTable* symbols) {
   return symbols->registerSymbol(getModuleName());
 }
 
-std::string ModuleInstance::getFullPathName() {
-  std::string path;
-  ModuleInstance* tmp = this;
-  std::vector<std::string> nibbles;
-  while (tmp) {
-    nibbles.push_back(tmp->getInstanceName());
-    tmp = tmp->getParent();
-  }
-  for (int i = nibbles.size() - 1; i >= 0; i--) {
-    path += nibbles[i];
-    if (i > 0) {
-      path += ".";
-    }
-  }
-  return path;
+const std::string& ModuleInstance::getFullPathName() {
+  return m_symbols->getSymbol(getFullPathId_());
 }
 
 unsigned int ModuleInstance::getDepth() {
@@ -114,20 +324,13 @@ unsigned int ModuleInstance::getDepth() {
   return depth;
 }
 
-std::string ModuleInstance::getInstanceName() {
-  if (m_definition == NULL) {
-    std::string name =
-        m_instName.substr(m_instName.find("&", 0, 1) + 1, m_instName.size());
-    return name;
-  } else {
-    return m_instName;
-  }
+const std::string& ModuleInstance::getInstanceName() {
+  return m_symbols->getSymbol(m_instName);
 }
 
 std::string ModuleInstance::getModuleName() {
   if (m_definition == NULL) {
-    std::string name = m_instName.substr(0, m_instName.find("&", 0, 1));
-    return name;
+    return m_symbols->getSymbol(m_moduleName);
   } else {
     return m_definition->getName();
   }
@@ -139,9 +342,22 @@ void ModuleInstance::overrideParentChild(ModuleInstance* parent,
   if (parent != this) return;
   child->m_parent = this;
   std::vector<ModuleInstance*> children;
+  std::vector<InstanceArray*> arrays;
+  unsigned int nextArray = 0;
 
   for (unsigned int i = 0; i < m_nbChildren; i++) {
+    // The arrays keep their place among the scalar children
+    while (nextArray < m_arrays.size() &&
+           m_arrays[nextArray]->getPosition() <= i) {
+      m_arrays[nextArray]->setPosition(children.size());
+      arrays.push_back(m_arrays[nextArray++]);
+    }
     if (m_children[i] == interm) {
+      unsigned int start = children.size();
+      for (InstanceArray* array : interm->m_arrays) {
+        array->setPosition(start + array->getPosition());
+        arrays.push_back(array);
+      }
       for (unsigned int j = 0; j < interm->m_nbChildren; j++) {
         children.push_back(interm->m_children[j]);
       }
@@ -149,6 +365,13 @@ void ModuleInstance::overrideParentChild(ModuleInstance* parent,
       children.push_back(m_children[i]);
     }
   }
+  while (nextArray < m_arrays.size()) {
+    m_arrays[nextArray]->setPosition(children.size());
+    arrays.push_back(m_arrays[nextArray++]);
+  }
+  m_arrays = arrays;
+  m_nbArrayElements = 0;
+  for (InstanceArray* array : m_arrays) m_nbArrayElements += array->getSize();
 
   ModuleInstance** newChild = new ModuleInstance*[children.size()];
   for (unsigned int i = 0; i < children.size(); i++) {
@@ -157,4 +380,5 @@ void ModuleInstance::overrideParentChild(ModuleInstance* parent,
   m_nbChildren = children.size();
   delete[] m_children;
   m_children = newChild;
+  child->resetFullPath_();
 }
@@ -24,6 +24,9 @@
 #ifndef MODULEINSTANCE_H
 #define MODULEINSTANCE_H
 
+#include <atomic>
+#include <mutex>
+#include "SourceCompile/SymbolTable.h"
 #include "Design/ModuleDefinition.h"
 #include "Expression/Value.h"
 #include "Expression/ExprBuilder.h"
@@ -32,23 +35,80 @@
 
 namespace SURELOG {
 
+class ModuleInstance;
+class InstanceArray;
+class DefParam;
+class Config;
+
+/* Elaborates the sub-instances of an instance the first time they are
+   accessed (lazy elaboration) */
+class LazyElaborator {
+ public:
+  virtual ~LazyElaborator() {}
+  virtual void elaborateSubInstances(ModuleInstance* instance) = 0;
+  virtual ModuleInstance* elaborateArrayElement(InstanceArray* array,
+                                                unsigned int index) = 0;
+};
+
 class ModuleInstance : public ValuedComponentI {
  public:
+  /* Parameter values sorted by name, the names are interned */
+  typedef std::vector<std::pair<const std::string*, Value*>> ParamVector;
+
   ModuleInstance(DesignComponent* definition, FileContent* fileContent,
                  NodeId nodeId, ModuleInstance* parent, std::string instName,
-                 std::string moduleName);
+                 std::string moduleName, SymbolTable* symbols);
   ~ModuleInstance() override;
+  Value* getValue(const std::string& name) override;
+  void setValue(const std::string& name, Value* val,
+                ExprBuilder& exprBuilder) override;
+  void copyValue(const std::string& name, Value* val,
+                 ExprBuilder& exprBuilder) override;
+  /* The values sorted by name: the instance's own, then the shared ones it
+     does not set */
+  ParamVector getParamValues();
+  /* Values shared by the identically parameterized instances, owned by the
+     elaboration and never modified: setValue shadows them */
+  void shareValues(const ParamVector* values) { m_sharedValues = values; }
   void addSubInstances(ModuleInstance** subInstances,
                        unsigned int nbSubInstances);
+  /* Detaches the sub-instances and arrays, the elaboration builds them
+     again */
+  void clearSubInstances();
   DesignComponent* getDefinition() { return m_definition; }
-  unsigned int getNbChildren() { return m_nbChildren; }
+  /* The children include the elements of the instance arrays, which are
+     created on access */
+  unsigned int getNbChildren() {
+    elaborate_();
+    return m_nbChildren + m_nbArrayElements;
+  }
   ModuleInstance* getChildren(unsigned int i) { 
+    elaborate_();
+    if (!m_arrays.empty()) return getArrayChild_(i);
     if (m_children != NULL) {
       return m_children[i];
     } else { 
       return NULL; 
     }
   }
+  /* Children that are not elements of an instance array */
+  unsigned int getNbScalarChildren() {
+    elaborate_();
+    return m_nbChildren;
+  }
+  ModuleInstance* getScalarChildren(unsigned int i) {
+    elaborate_();
+    return m_children[i];
+  }
+  void addInstanceArray(InstanceArray* array);
+  unsigned int getNbInstanceArrays() {
+    elaborate_();
+    return m_arrays.size();
+  }
+  InstanceArray* getInstanceArray(unsigned int i) {
+    elaborate_();
+    return m_arrays[i];
+  }
   ModuleInstance* getParent() { return m_parent; }
   FileContent* getFileContent() { return m_fileContent; }
   SymbolId getFileId() { return m_fileContent->getFileId(m_nodeId); }
@@ -60,36 +120,139 @@ class ModuleInstance : public ValuedComponentI {
   SymbolId getFullPathId(SymbolTable* symbols);
   SymbolId getInstanceId(SymbolTable* symbols);
   SymbolId getModuleNameId(SymbolTable* symbols);
-  std::string getInstanceName();
-  std::string getFullPathName();
+  const std::string& getInstanceName();
+  /* The path is computed once, from the parent path */
+  const std::string& getFullPathName();
   std::string getModuleName();
   unsigned int getDepth();
 
   void setNodeId(NodeId id) { m_nodeId = id; }  // Used for generate stmt
   void overrideParentChild(ModuleInstance* parent, ModuleInstance* interm,
                            ModuleInstance* child);
-  Netlist* getNetlist() { return m_netlist; }
+  Netlist* getNetlist() {
+    elaborate_();
+    return m_netlist;
+  }
   void setNetlist(Netlist* netlist) { m_netlist = netlist; }
+  /* The sub-instances and the netlist are elaborated on first access.
+     Not thread safe */
+  void setLazyElaborator(LazyElaborator* elaborator) {
+    m_lazyElaborator = elaborator;
+  }
+  /* Node of the defparam trie matching this instance, resolved by the
+     elaboration at the given defparam generation (0: not resolved) */
+  DefParam* getDefParamScope() { return m_defParamScope; }
+  unsigned int getDefParamGeneration() { return m_defParamGeneration; }
+  void setDefParamScope(DefParam* scope, unsigned int generation) {
+    m_defParamScope = scope;
+    m_defParamGeneration = generation;
+  }
  private:
+  void elaborate_() {
+    if (m_lazyElaborator == NULL) return;
+    LazyElaborator* elaborator = m_lazyElaborator;
+    m_lazyElaborator = NULL;
+    elaborator->elaborateSubInstances(this);
+  }
+  SymbolId getFullPathId_();
+  void resetFullPath_();
+  ModuleInstance* getArrayChild_(unsigned int i);
+
   DesignComponent* m_definition;
   ModuleInstance** m_children;
   unsigned int m_nbChildren;
   FileContent* m_fileContent;
   NodeId m_nodeId;
   ModuleInstance* m_parent;
-  std::string m_instName;  // Can carry the moduleName@instanceName if the
-                           // module is undefined
-  std::map<std::string, Value*> m_paramMap;
+  SymbolTable* m_symbols;
+  SymbolId m_instName;
+  SymbolId m_moduleName;  // Only used if the module is undefined
+  std::atomic<SymbolId> m_fullPathId;
+  ParamVector m_paramValues;
+  const ParamVector* m_sharedValues;
   Netlist* m_netlist;
+  LazyElaborator* m_lazyElaborator;
+  DefParam* m_defParamScope;
+  unsigned int m_defParamGeneration;
+  std::vector<InstanceArray*> m_arrays;
+  unsigned int m_nbArrayElements;
+};
+
+/* Array of identical instances (same definition and parameters) kept as a
+   range, an element is only created when accessed. The elements are named
+   like the expanded instances: the instance name followed by the indexes.
+   The array sits before the scalar child at "position" of its parent */
+class InstanceArray {
+ public:
+  InstanceArray(ModuleInstance* parent, DesignComponent* definition,
+                FileContent* fileContent, NodeId nodeId, NodeId paramOverride,
+                Config* config, const std::string& instName,
+                const std::string& moduleName, const std::vector<int>& from,
+                const std::vector<int>& to, unsigned int position,
+                LazyElaborator* elaborator);
+
+  ModuleInstance* getParent() { return m_parent; }
+  DesignComponent* getDefinition() { return m_definition; }
+  FileContent* getFileContent() { return m_fileContent; }
+  NodeId getNodeId() { return m_nodeId; }
+  NodeId getParamOverride() { return m_paramOverride; }
+  Config* getConfig() { return m_config; }
+  const std::string& getInstanceName() { return m_instName; }
+  const std::string& getModuleName() { return m_moduleName; }
+  std::string getFullPathName();
+  std::vector<int>& getFrom() { return m_from; }
+  std::vector<int>& getTo() { return m_to; }
+  unsigned int getSize() { return m_size; }
+  unsigned int getPosition() { return m_position; }
+  void setPosition(unsigned int position) { m_position = position; }
+
+  std::string getElementName(unsigned int index);
+  /* Index of the element of that name, -1 if none */
+  int findElement(const std::string& name);
+  /* Creates the element on first access */
+  ModuleInstance* getElement(unsigned int index);
+  std::map<unsigned int, ModuleInstance*>& getElaboratedElements() {
+    return m_elements;
+  }
+  void setElaborator(LazyElaborator* elaborator) { m_elaborator = elaborator; }
+
+ private:
+  InstanceArray(const InstanceArray& orig);
+
+  ModuleInstance* m_parent;
+  DesignComponent* m_definition;
+  FileContent* m_fileContent;
+  NodeId m_nodeId;
+  NodeId m_paramOverride;
+  Config* m_config;
+  std::string m_instName;
+  std::string m_moduleName;
+  std::vector<int> m_from;
+  std::vector<int> m_to;
+  unsigned int m_size;
+  unsigned int m_position;
+  std::map<unsigned int, ModuleInstance*> m_elements;
+  LazyElaborator* m_elaborator;
 };
 
+/* Allocates the instances by chunks, they live as long as the factory */
 class ModuleInstanceFactory {
  public:
+  ModuleInstanceFactory(SymbolTable* symbols);
+  ~ModuleInstanceFactory();
   ModuleInstance* newModuleInstance(DesignComponent* definition,
                                     FileContent* fileContent, NodeId nodeId,
                                     ModuleInstance* parent,
                                     std::string instName,
                                     std::string moduleName);
+
+ private:
+  ModuleInstanceFactory(const ModuleInstanceFactory& orig);
+  static const unsigned int ChunkSize = 1024;
+  SymbolTable* m_symbols;
+  std::vector<ModuleInstance*> m_chunks;
+  unsigned int m_used;  // Instances of the last chunk
+  std::mutex m_mutex;
 };
 
 };  // namespace SURELOG
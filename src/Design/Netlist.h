@@ -26,6 +26,7 @@
 #include <string>
 #include <vector>
 #include <map>
+#include <unordered_map>
 #include "SourceCompile/SymbolTable.h"
 #include "Design/FileContent.h"
 #include "Design/ModPort.h"
@@ -50,9 +51,24 @@ class Netlist {
                                     m_ports(NULL), m_processes(NULL), m_cont_assigns(NULL) {}
   ~Netlist();
 
-  typedef std::map<std::string, std::pair<ModPort*, UHDM::modport*>> ModPortMap;
-  typedef std::map<std::string, std::pair<ModuleInstance*, UHDM::BaseClass*>> InstanceMap;
-  typedef std::map<std::string, UHDM::BaseClass*> SymbolTable;
+  /* Symbols are keyed by interned names: a plain name is (name, 0), a
+     member "a.b" is (a, b) */
+  typedef std::pair<SymbolId, SymbolId> SymbolPath;
+  struct SymbolPathHash {
+    size_t operator()(const SymbolPath& path) const {
+      return std::hash<SymbolId>()(path.first * 31 + path.second);
+    }
+  };
+  typedef std::unordered_map<SymbolPath, std::pair<ModPort*, UHDM::modport*>,
+                             SymbolPathHash>
+      ModPortMap;
+  typedef std::unordered_map<SymbolId,
+                             std::pair<ModuleInstance*, UHDM::BaseClass*>>
+      InstanceMap;
+  typedef std::unordered_map<SymbolPath, UHDM::BaseClass*, SymbolPathHash>
+      SymbolTable;
+  /* Members of an interface or a modport of this netlist, by name */
+  typedef std::unordered_map<SymbolId, UHDM::BaseClass*> MemberMap;
 
   std::vector<UHDM::interface*>*   interfaces() { return m_interfaces; }
   std::vector<UHDM::port*>*        ports() { return m_ports;}
@@ -70,6 +86,14 @@ class Netlist {
   SymbolTable&  getSymbolTable() { return m_symbolTable; }
   ModPortMap& getModPortMap() { return m_modPortMap; }
   InstanceMap& getInstanceMap() { return m_instanceMap; }
+  MemberMap& addMembers(const UHDM::BaseClass* object) {
+    return m_members[object];
+  }
+  MemberMap* getMembers(const UHDM::BaseClass* object) {
+    std::unordered_map<const UHDM::BaseClass*, MemberMap>::iterator itr =
+        m_members.find(object);
+    return (itr == m_members.end()) ? NULL : &(*itr).second;
+  }
   ModuleInstance* getParent() { return m_parent; }
  private:
   ModuleInstance*                  m_parent;
@@ -84,6 +108,7 @@ class Netlist {
   SymbolTable m_symbolTable;
   ModPortMap m_modPortMap;
   InstanceMap m_instanceMap;
+  std::unordered_map<const UHDM::BaseClass*, MemberMap> m_members;
 };
 
 };  // namespace SURELOG
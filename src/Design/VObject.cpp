@@ -26,8 +26,6 @@
 
 using namespace SURELOG;
 
-VObject::~VObject() {}
-
 std::string VObject::print(SymbolTable* symbols, unsigned int uniqueId,
                            NodeId definitionFile) {
   std::string text;
@@ -29,22 +29,29 @@
 
 namespace SURELOG {
 
+/* AST node. Kept small and without vtable, large designs have hundreds of
+   millions of them: the name is a 32 bits symbol id and the file is an index
+   in the file table of the owning FileContent (see FileContent::getFileId).
+   28 bytes against the former 48. The search index of FileContent is a
+   side table of 22 bytes per node, only held from the first search to the
+   end of the elaboration. */
 class VObject {
  public:
-  VObject(SymbolId name, SymbolId fileId, VObjectType type, unsigned int line,
-          NodeId parent = 0)
-      : m_name(name),
-        m_fileId(fileId),
+  VObject(SymbolId name, unsigned short fileIndex, VObjectType type,
+          unsigned int line, NodeId parent = 0)
+      : m_name(name <= MaxName ? (uint32_t)name : 0),
+        m_fileIndex(fileIndex),
         m_type(type),
         m_line(line),
         m_parent(parent),
         m_definition(0),
         m_child(0),
         m_sibling(0) {}
-  VObject(SymbolId name, SymbolId fileId, VObjectType type, unsigned int line,
-          NodeId parent, NodeId definition, NodeId child, NodeId sibling)
-      : m_name(name),
-        m_fileId(fileId),
+  VObject(SymbolId name, unsigned short fileIndex, VObjectType type,
+          unsigned int line, NodeId parent, NodeId definition, NodeId child,
+          NodeId sibling)
+      : m_name(name <= MaxName ? (uint32_t)name : 0),
+        m_fileIndex(fileIndex),
         m_type(type),
         m_line(line),
         m_parent(parent),
@@ -52,14 +59,16 @@ class VObject {
         m_child(child),
         m_sibling(sibling) {}
 
-  virtual ~VObject();
+  /* m_name is 32 bits, a larger symbol id leaves the node with the bad
+     symbol, FileContent::getNameId reports it */
+  static const SymbolId MaxName = 0xFFFFFFFF;
 
   static std::string getTypeName(unsigned short type);
 
   std::string print(SymbolTable* symbols, unsigned int uniqueId,
                     NodeId definitionFile);
-  SymbolId m_name;
-  SymbolId m_fileId;
+  uint32_t m_name;
+  unsigned short m_fileIndex;
   unsigned short m_type;
   unsigned int m_line;
   NodeId m_parent;
@@ -70,6 +79,8 @@ class VObject {
  private:
 };
 
+static_assert(sizeof(VObject) == 28, "VObject layout changed");
+
 };  // namespace SURELOG
 
 #endif /* VOBJECT_H */
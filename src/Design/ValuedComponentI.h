@@ -33,16 +33,19 @@ class ValuedComponentI {
   ValuedComponentI(ValuedComponentI* parentScope)
       : m_parentScope(parentScope){};
   virtual ~ValuedComponentI(){};
-  virtual Value* getValue(std::string name);
-  virtual void setValue(std::string name, Value* val, ExprBuilder& exprBuilder);
-  std::vector<Value*>& getValues() { return m_paramValues; }
-  std::map<std::string, Value*>& getMappedValues() { return m_paramMap; }
+  /* Looks up the parent scope if not found locally */
+  virtual Value* getValue(const std::string& name) = 0;
+  /* Takes the ownership of val */
+  virtual void setValue(const std::string& name, Value* val,
+                        ExprBuilder& exprBuilder) = 0;
+  /* Stores a copy of val, which the caller keeps (a view of ExprBuilder):
+     a value already stored locally is overwritten in place */
+  virtual void copyValue(const std::string& name, Value* val,
+                         ExprBuilder& exprBuilder) = 0;
   ValuedComponentI* getParentScope() { return m_parentScope; }
 
  private:
   ValuedComponentI* m_parentScope;
-  std::vector<Value*> m_paramValues;
-  std::map<std::string, Value*> m_paramMap;
 };
 
 };  // namespace SURELOG
@@ -50,6 +50,8 @@
 #include "DesignCompile/Builtin.h"
 #include "DesignCompile/PackageAndRootElaboration.h"
 #include "DesignCompile/UhdmWriter.h"
+#include "Package/Package.h"
+#include "Utils/ThreadPool.h"
 
 #ifdef USETBB
 #include <tbb/task.h>
@@ -59,14 +61,23 @@
 
 #include <vector>
 #include <thread>
+#include <algorithm>
+#include <unordered_map>
+#include <queue>
 
 using namespace SURELOG;
 
-CompileDesign::CompileDesign(Compiler* compiler) : m_compiler(compiler) {}
+CompileDesign::CompileDesign(Compiler* compiler)
+    : m_compiler(compiler),
+      m_designElaboration(NULL),
+      m_netlistElaboration(NULL) {}
 
 CompileDesign::CompileDesign(const CompileDesign& orig) {}
 
-CompileDesign::~CompileDesign() {}
+CompileDesign::~CompileDesign() {
+  delete m_designElaboration;
+  delete m_netlistElaboration;
+}
 
 bool CompileDesign::compile() {
   Location loc(0);
@@ -89,57 +100,136 @@ void CompileDesign::compileMT_(ObjectMapType& objects, int maxThreadCount) {
       funct.operator()();
     }
   } else {
-    // Optimize the load balance, try to even out the work in each thread by the
-    // number of VObjects
-    std::vector<unsigned long> jobSize(maxThreadCount);
-    for (unsigned short i = 0; i < maxThreadCount; i++) {
-      jobSize[i] = 0;
-    }
-    std::vector<std::vector<ObjectType*>> jobArray(maxThreadCount);
+    // Biggest objects first (by number of VObjects), the pool balances the
+    // load dynamically
+    std::vector<std::pair<unsigned int, ObjectType*>> jobs;
     for (auto mod : objects) {
       unsigned int size = mod.second->getSize();
       if (size == 0) size = 100;
-      unsigned int newJobIndex = 0;
-      unsigned long long minJobQueue = ULLONG_MAX;
-      for (unsigned short ii = 0; ii < maxThreadCount; ii++) {
-        if (jobSize[ii] < minJobQueue) {
-          newJobIndex = ii;
-          minJobQueue = jobSize[ii];
-        }
-      }
-      jobSize[newJobIndex] += size;
-      jobArray[newJobIndex].push_back(mod.second);
+      jobs.push_back(std::make_pair(size, mod.second));
     }
+    std::stable_sort(jobs.begin(), jobs.end(),
+                     [](const std::pair<unsigned int, ObjectType*>& a,
+                        const std::pair<unsigned int, ObjectType*>& b) {
+                       return a.first > b.first;
+                     });
 
     if (getCompiler()->getCommandLineParser()->profile()) {
       std::cout << "Compilation Task\n";
-      for (unsigned short i = 0; i < maxThreadCount; i++) {
-        std::cout << "Thread " << i << " : \n";
-        for (unsigned int j = 0; j < jobArray[i].size(); j++) {
-          std::cout << jobArray[i][j]->getName() << "\n";
-        }
+      for (unsigned int j = 0; j < jobs.size(); j++) {
+        std::cout << jobs[j].second->getName() << "\n";
       }
     }
 
-    // Create the threads with their respective workloads
-    std::vector<std::thread*> threads;
-    for (unsigned short i = 0; i < maxThreadCount; i++) {
-      std::thread* th = new std::thread([=] {
-        for (unsigned int j = 0; j < jobArray[i].size(); j++) {
-          FunctorType funct(this, jobArray[i][j], m_compiler->getDesign(),
-                            m_symbolTables[i], m_errorContainers[i]);
-          funct.operator()();
-        }
+    // Each worker uses its own error container
+    ThreadPool* pool = m_compiler->getThreadPool();
+    for (unsigned int j = 0; j < jobs.size(); j++) {
+      ObjectType* object = jobs[j].second;
+      pool->addJob([=](unsigned int workerIndex) {
+        FunctorType funct(this, object, m_compiler->getDesign(),
+                          m_symbolTables[workerIndex],
+                          m_errorContainers[workerIndex]);
+        funct.operator()();
       });
-      threads.push_back(th);
     }
-    // Sync the threads
-    for (unsigned int th = 0; th < threads.size(); th++) {
-      threads[th]->join();
+    pool->wait();
+  }
+}
+
+std::vector<std::vector<Package*>> CompileDesign::packageLevels_() {
+  // A package is compiled after the packages it imports or refers to with a
+  // scope, and after the ones before it in the ordered list that refer to it:
+  // the edges always go forward in that list, so there is no cycle.
+  // A "pkg::" scope leaves no node, the parser records its package on the
+  // file content; all the scopes of the file count, which can only add
+  // edges.
+  PackageDefinitionVec& ordered =
+      m_compiler->getDesign()->getOrderedPackageDefinitions();
+  unsigned int size = ordered.size();
+  std::unordered_map<std::string, std::vector<unsigned int>> packageIndexes;
+  for (unsigned int i = 0; i < size; i++) {
+    if (ordered[i]) packageIndexes[ordered[i]->getName()].push_back(i);
+  }
+  std::vector<VObjectType> types = {VObjectType::slPackage_import_item,
+                                    VObjectType::slClass_scope};
+  std::vector<std::vector<unsigned int>> laterRefs(size);
+  std::vector<unsigned int> levels(size, 0);
+  unsigned int nbLevels = 0;
+  for (unsigned int i = 0; i < size; i++) {
+    Package* package = ordered[i];
+    if (package == NULL) continue;
+    std::vector<std::string> names(1, package->getName());
+    std::vector<FileContent*>& fileContents = package->getFileContents();
+    std::vector<NodeId>& nodeIds = package->getNodeIds();
+    for (unsigned int j = 0; j < fileContents.size(); j++) {
+      FileContent* fC = fileContents[j];
+      for (SymbolId scope : fC->getPackageScopes())
+        names.push_back(fC->getSymbolTable()->getSymbol(scope));
+      for (auto& import : fC->getObjects(VObjectType::slPackage_import_item))
+        names.push_back(import.fC->SymName(import.fC->Child(import.nodeId)));
+      for (NodeId id : fC->sl_collect_all(nodeIds[j], types)) {
+        if (fC->Type(id) == VObjectType::slPackage_import_item)
+          names.push_back(fC->SymName(fC->Child(id)));
+        else
+          names.push_back(fC->SymName(fC->Child(fC->Child(id))));
+      }
+    }
+    unsigned int level = 0;
+    for (auto& name : names) {
+      auto itr = packageIndexes.find(name);
+      if (itr == packageIndexes.end()) continue;
+      for (unsigned int other : (*itr).second) {
+        if (other < i)
+          level = std::max(level, levels[other] + 1);
+        else if (other > i)
+          laterRefs[other].push_back(i);
+      }
+    }
+    for (unsigned int other : laterRefs[i])
+      level = std::max(level, levels[other] + 1);
+    levels[i] = level;
+    nbLevels = std::max(nbLevels, level + 1);
+  }
+  std::vector<std::vector<Package*>> packageLevels(nbLevels);
+  for (unsigned int i = 0; i < size; i++) {
+    if (ordered[i]) packageLevels[levels[i]].push_back(ordered[i]);
+  }
+  return packageLevels;
+}
+
+void CompileDesign::compilePackages_(int maxThreadCount) {
+  Design* design = m_compiler->getDesign();
+  for (auto& level : packageLevels_()) {
+    for (Package* package : level)
+      CompilePackage::reportCompile(this, package, m_symbolTables[0]);
+    if (maxThreadCount == 0 || level.size() == 1) {
+      for (Package* package : level) {
+        FunctorCompilePackage funct(this, package, design, m_symbolTables[0],
+                                    m_errorContainers[0]);
+        funct.operator()();
+      }
+      continue;
+    }
+    // The packages of a level are independent. One error container each,
+    // merged in package order
+    std::vector<ErrorContainer*> errors(level.size());
+    ThreadPool* pool = m_compiler->getThreadPool();
+    for (unsigned int i = 0; i < level.size(); i++) {
+      errors[i] = new ErrorContainer(m_symbolTables[0]);
+      errors[i]->regiterCmdLine(m_compiler->getCommandLineParser());
+      Package* package = level[i];
+      ErrorContainer* packageErrors = errors[i];
+      pool->addJob([=](unsigned int workerIndex) {
+        FunctorCompilePackage funct(this, package, design,
+                                    m_symbolTables[workerIndex],
+                                    packageErrors);
+        funct.operator()();
+      });
     }
-    // Delete the threads
-    for (unsigned int th = 0; th < threads.size(); th++) {
-      delete threads[th];
+    pool->wait();
+    for (unsigned int i = 0; i < level.size(); i++) {
+      m_errorContainers[0]->appendErrors(*errors[i]);
+      delete errors[i];
     }
   }
 }
@@ -256,8 +346,8 @@ bool CompileDesign::compilation_() {
   int maxThreadCount = m_compiler->getCommandLineParser()->getNbMaxTreads();
   int index = 0;
   do {
-    SymbolTable* symbols = new SymbolTable(
-            *m_compiler->getCommandLineParser()->getSymbolTable());
+    // The symbol table is shared by all the threads
+    SymbolTable* symbols = m_compiler->getSymbolTable();
     m_symbolTables.push_back(symbols);
     ErrorContainer* errors = new ErrorContainer(symbols);
     errors->regiterCmdLine(m_compiler->getCommandLineParser());
@@ -276,12 +366,7 @@ bool CompileDesign::compilation_() {
   collectObjects_(all_files, design, false);
   m_compiler->getDesign()->orderPackages();
 
-  // Compile packages in strict order
-  for (auto itr : m_compiler->getDesign()->getOrderedPackageDefinitions()) {
-    FunctorCompilePackage funct(this, itr, m_compiler->getDesign(),
-                                m_symbolTables[0], m_errorContainers[0]);
-    funct.operator()();
-  }
+  compilePackages_(maxThreadCount);
 
   // Compile modules
   compileMT_<ModuleDefinition, ModuleNameModuleDefinitionMap,
@@ -307,7 +392,6 @@ bool CompileDesign::compilation_() {
   unsigned int size = m_symbolTables.size();
   for (unsigned int i = 0; i < size; i++) {
     m_compiler->getErrorContainer()->appendErrors(*m_errorContainers[i]);
-    delete m_symbolTables[i];
     delete m_errorContainers[i];
   }
   return true;
@@ -318,18 +402,61 @@ bool CompileDesign::elaboration_()
   PackageAndRootElaboration* packEl = new PackageAndRootElaboration(this);
   packEl->elaborate();
   delete packEl;
-  DesignElaboration* designEl = new DesignElaboration(this);
-  designEl->elaborate();
-  delete designEl;
-  NetlistElaboration* netlistEl = new NetlistElaboration(this);
-  netlistEl->elaborate();
-  delete netlistEl;
+  CommandLineParser* clp = m_compiler->getCommandLineParser();
+  if (clp->lazyElaboration()) {
+    // Instances are elaborated, with their netlist, as they are accessed
+    m_netlistElaboration = new NetlistElaboration(this);
+    m_designElaboration = new DesignElaboration(this);
+    m_designElaboration->setNetlistElaboration(m_netlistElaboration);
+    m_designElaboration->elaborate();
+    elaboratePaths_();
+  } else {
+    DesignElaboration* designEl = new DesignElaboration(this);
+    designEl->elaborate();
+    delete designEl;
+    NetlistElaboration* netlistEl = new NetlistElaboration(this);
+    netlistEl->elaborate();
+    delete netlistEl;
+  }
   UVMElaboration* uvmEl = new UVMElaboration(this);
   uvmEl->elaborate();
   delete uvmEl;
+  if (!clp->lazyElaboration()) {
+    // Done with the tree searches, their indexes are released
+    Design* design = m_compiler->getDesign();
+    for (auto& file : design->getAllFileContents()) file.second->clearIndex();
+    for (auto& file : design->getAllPPFileContents())
+      file.second->clearIndex();
+  }
   return true;
 }
 
+void CompileDesign::elaboratePaths_() {
+  Design* design = m_compiler->getDesign();
+  SymbolTable* symbols = m_compiler->getSymbolTable();
+  for (auto& path : m_compiler->getCommandLineParser()->getElaborationPaths()) {
+    // The top level instances are named after their library
+    std::string fullPath = path;
+    if (fullPath.find('@') == std::string::npos) fullPath = "work@" + fullPath;
+    ModuleInstance* instance = design->findInstance(fullPath);
+    if (instance == NULL) {
+      Location loc(symbols->registerSymbol(path));
+      Error err(ErrorDefinition::ELAB_UNDEFINED_INSTANCE_PATH, loc);
+      m_compiler->getErrorContainer()->addError(err);
+      continue;
+    }
+    // Elaborates the whole subtree
+    std::queue<ModuleInstance*> queue;
+    queue.push(instance);
+    while (!queue.empty()) {
+      ModuleInstance* current = queue.front();
+      queue.pop();
+      for (unsigned int i = 0; i < current->getNbChildren(); i++)
+        queue.push(current->getChildren(i));
+    }
+  }
+}
+
 bool CompileDesign::writeUHDM(const std::string& fileName) {
   UhdmWriter* uhdmwriter = new UhdmWriter(this, m_compiler->getDesign());
   uhdmwriter->write(fileName);
@@ -29,6 +29,9 @@ using namespace UHDM;
 
 namespace SURELOG {
 
+class DesignElaboration;
+class NetlistElaboration;
+
 class CompileDesign {
  public:
   CompileDesign(Compiler* compiler);
@@ -49,8 +52,11 @@ class CompileDesign {
 
   void collectObjects_(Design::FileIdDesignContentMap& all_files,
                        Design* design, bool finalCollection);
+  std::vector<std::vector<Package*>> packageLevels_();
+  void compilePackages_(int maxThreadCount);
   bool compilation_();
   bool elaboration_();
+  void elaboratePaths_();
 
   Compiler* m_compiler;
   std::vector<SymbolTable*> m_symbolTables;
@@ -58,6 +64,9 @@ class CompileDesign {
 
   std::mutex m_serializerMutex;
   Serializer m_serializer;
+  // Kept alive by the lazy elaboration
+  DesignElaboration* m_designElaboration;
+  NetlistElaboration* m_netlistElaboration;
 };
 
 };  // namespace SURELOG
@@ -47,7 +47,7 @@ bool CompileHelper::importPackage(DesignComponent* scope, Design* design,
   scope->addObject(VObjectType::slPackage_import_item, fnid);
 
   NodeId nameId = fC->Child(id);
-  std::string pack_name = fC->SymName(nameId);
+  const std::string& pack_name = fC->SymName(nameId);
   Package* def = design->getPackage(pack_name);
   if (def) {
     scope->addAccessPackage(def);
@@ -55,7 +55,7 @@ bool CompileHelper::importPackage(DesignComponent* scope, Design* design,
     for (unsigned int i = 0; i < classSet.size(); i++) {
       FileContent* packageFile = classSet[i].fC;
       NodeId classDef = classSet[i].nodeId;
-      std::string name = packageFile->SymName(classDef);
+      const std::string& name = packageFile->SymName(classDef);
       std::string fullName = def->getName() + "::" + name;
       DesignComponent* comp = packageFile->getComponentDefinition(fullName);
       FileCNodeId fnid(packageFile, classDef);
@@ -211,7 +211,7 @@ bool CompileHelper::compileTfPortList(Procedure* parent, FileContent* fC,
       } else {
         typeName = VObject::getTypeName(the_type);
       }
-      std::string name = fC->SymName(tf_param_name);
+      const std::string& name = fC->SymName(tf_param_name);
       NodeId expression = fC->Sibling(tf_param_name);
       DataType* dtype = new DataType(fC, type, typeName, fC->Type(type));
 
@@ -288,7 +288,7 @@ DataType* CompileHelper::compileTypeDef(DesignComponent* scope, FileContent* fC,
   }
 
   NodeId type_name = fC->Sibling(data_type);
-  std::string name = fC->SymName(type_name);
+  const std::string& name = fC->SymName(type_name);
   TypeDef* prevDef = scope->getTypeDef(name);
   if (prevDef) {
     Location loc1(m_symbols->registerSymbol(fC->getFileName(data_type)),
@@ -344,7 +344,7 @@ DataType* CompileHelper::compileTypeDef(DesignComponent* scope, FileContent* fC,
     newType = newTypeDef;
     while (enum_name_declaration) {
       NodeId enumNameId = fC->Child(enum_name_declaration);
-      std::string enumName = fC->SymName(enumNameId);
+      const std::string& enumName = fC->SymName(enumNameId);
       NodeId enumValueId = fC->Sibling(enumNameId);
       Value* value = NULL;
       if (enumValueId) {
@@ -526,7 +526,7 @@ bool CompileHelper::compileSubroutine_call(Scope* parent, Statement* parentStmt,
 
     next_name = fC->Sibling(next_name);
   }
-  std::string funcName = fC->SymName(var_chain[var_chain.size() - 1]);
+  const std::string& funcName = fC->SymName(var_chain[var_chain.size() - 1]);
   var_chain.pop_back();
 
   NodeId list_of_arguments = next_name;
@@ -747,7 +747,7 @@ bool CompileHelper::compileScopeVariable(Scope* parent, FileContent* fC,
         if (varType == VObjectType::slList_of_arguments) {
           // new ()
         } else {
-          std::string varName = fC->SymName(var);
+          const std::string& varName = fC->SymName(var);
 
           Variable* previous = parent->getVariable(varName);
           if (previous) {
@@ -990,7 +990,7 @@ bool CompileHelper::compilePortDeclaration(PortNetHolder* component,
       */
       NodeId type_identifier = fC->Child(subNode);
       NodeId interfIdName = fC->Child(type_identifier);
-      std::string interfName = fC->SymName(interfIdName);
+      const std::string& interfName = fC->SymName(interfIdName);
 
       NodeId list_of_interface_identifiers =
               fC->Sibling(type_identifier);
@@ -1349,7 +1349,7 @@ UHDM::atomic_stmt* CompileHelper::compileProceduralTimingControlStmt(FileContent
     return compileEventControlStmt(fC, Procedural_timing_control_statement, compileDesign);
   }
   NodeId IntConst = fC->Child(Delay_control);
-  std::string value = fC->SymName(IntConst);        
+  const std::string& value = fC->SymName(IntConst);        
   UHDM::delay_control* dc = s.MakeDelay_control();
   dc->VpiDelay(value);
   NodeId Statement_or_null = fC->Sibling(Procedural_timing_control);
@@ -1446,7 +1446,7 @@ VectorOfany* CompileHelper::compileTfCallArguments(FileContent* fC,
 
   while (argumentNode) {
 
-    Value* val = m_exprBuilder.evalExpr(fC, argumentNode, NULL, true);
+    Value* val = m_exprBuilder.evalView(fC, argumentNode, NULL, true);
     if (val->isValid()) {
       // Expression is a constant
       UHDM::constant* c = constantFromValue(val, compileDesign);
@@ -1483,7 +1483,7 @@ UHDM::assignment* CompileHelper::compileBlockingAssignment(FileContent* fC,
     Expression = fC->Sibling(AssignOp_Assign); // To be checked
   }
   // Set a pre-elab value here, might override post elab
-  Value* val = m_exprBuilder.evalExpr(fC, Expression, NULL, true);
+  Value* val = m_exprBuilder.evalView(fC, Expression, NULL, true);
   UHDM::any* rhs_rf = nullptr;
   if (val->isValid()) {
     // Expression is a constant
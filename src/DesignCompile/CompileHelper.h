@@ -147,6 +147,7 @@ class CompileHelper {
   bool compileInitialBlock(PortNetHolder* component, FileContent* fC, 
         NodeId id, CompileDesign* compileDesign);
   
+  /* val is only read, it can be a view of the ExprBuilder */
   UHDM::constant* constantFromValue(Value* val, CompileDesign* compileDesign);
 
   UHDM::any* compileExpression(FileContent* fC, NodeId nodeId, 
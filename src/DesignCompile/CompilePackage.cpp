@@ -56,25 +56,26 @@ CompilePackage::~CompilePackage() {}
 
 bool CompilePackage::compile() {
   if (!m_package) return false;
-  FileContent* fC = m_package->m_fileContents[0];
-  NodeId packId = m_package->m_nodeIds[0];
+  collectObjects_();
+  return true;
+}
+
+void CompilePackage::reportCompile(CompileDesign* compiler, Package* package,
+                                   SymbolTable* symbols) {
+  if (!package) return;
+  FileContent* fC = package->m_fileContents[0];
+  NodeId packId = package->m_nodeIds[0];
 
-  Location loc(m_symbols->registerSymbol(fC->getFileName(packId)),
-               fC->Line(packId), 0, m_symbols->getId(m_package->getName()));
+  Location loc(symbols->registerSymbol(fC->getFileName(packId)),
+               fC->Line(packId), 0, symbols->getId(package->getName()));
   Error err(ErrorDefinition::COMP_COMPILE_PACKAGE, loc);
 
-  ErrorContainer* errors = new ErrorContainer(m_symbols);
-  errors->regiterCmdLine(
-      m_compileDesign->getCompiler()->getCommandLineParser());
+  ErrorContainer* errors = new ErrorContainer(symbols);
+  errors->regiterCmdLine(compiler->getCompiler()->getCommandLineParser());
   errors->addError(err);
   errors->printMessage(
-      err,
-      m_compileDesign->getCompiler()->getCommandLineParser()->muteStdout());
+      err, compiler->getCompiler()->getCommandLineParser()->muteStdout());
   delete errors;
-
-  collectObjects_();
-
-  return true;
 }
 
 bool CompilePackage::collectObjects_() {
@@ -59,6 +59,10 @@ class CompilePackage {
 
   bool compile();
 
+  // Packages compile concurrently, the caller reports them in package order
+  static void reportCompile(CompileDesign* compiler, Package* package,
+                            SymbolTable* symbols);
+
   virtual ~CompilePackage();
 
  private:
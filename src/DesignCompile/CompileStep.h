@@ -50,7 +50,7 @@ class CompileStep {
 
   virtual unsigned int Line(NodeId index) = 0;
 
-  virtual std::string Symbol(SymbolId id) = 0;
+  virtual const std::string& Symbol(SymbolId id) = 0;
 
   virtual NodeId sl_get(NodeId parent,
                         VObjectType type) = 0;  // Get first item of type
@@ -72,7 +72,7 @@ class CompileStep {
       NodeId parent,
       VObjectType type) = 0;  // Recursively search for all items of type
 
-  virtual std::string SymName(NodeId index) = 0;
+  virtual const std::string& SymName(NodeId index) = 0;
 
  private:
 };
@@ -43,6 +43,9 @@
 #include "Design/Function.h"
 #include "Testbench/ClassDefinition.h"
 #include "DesignCompile/DesignElaboration.h"
+#include "DesignCompile/NetlistElaboration.h"
+#include "Utils/ThreadPool.h"
+#include <algorithm>
 #include <queue>
 
 using namespace SURELOG;
@@ -51,12 +54,19 @@ DesignElaboration::DesignElaboration(CompileDesign* compileDesign)
     : TestbenchElaboration(compileDesign) {
   m_moduleDefFactory = NULL;
   m_moduleInstFactory = NULL;
+  m_netlistElaboration = NULL;
   m_exprBuilder.seterrorReporting(
       m_compileDesign->getCompiler()->getErrorContainer(),
       m_compileDesign->getCompiler()->getSymbolTable());
+  m_exprBuilder.setFoldCache(&m_foldCache);
 }
 
-DesignElaboration::~DesignElaboration() {}
+DesignElaboration::~DesignElaboration() {
+  for (ExprBuilder* exprBuilder : m_exprBuilders) delete exprBuilder;
+  for (auto& body : m_instanceBodies) delete body.second;
+  for (auto& lazy : m_lazyInstances) lazy.first->setLazyElaborator(NULL);
+  for (InstanceArray* array : m_lazyArrays) array->setElaborator(NULL);
+}
 
 bool DesignElaboration::elaborate() {
   createBuiltinPrimitives_();
@@ -66,6 +76,15 @@ bool DesignElaboration::elaborate() {
   bindDataTypes_();
   elaborateAllModules_(true);
   elaborateAllModules_(false);
+  if (m_compileDesign->getCompiler()->getCommandLineParser()
+          ->lazyElaboration()) {
+    // Walking the tree would elaborate it all, the instance tree dump does
+    checkConfigurations_();
+    if (m_compileDesign->getCompiler()->getCommandLineParser()
+            ->getDebugInstanceTree())
+      reportElaboration_();
+    return true;
+  }
   reduceUnnamedBlocks_();
   checkElaboration_();
   reportElaboration_();
@@ -242,7 +261,7 @@ bool DesignElaboration::identifyTopModules_() {
   for (auto file : all_files) {
     if (m_compileDesign->getCompiler()->isLibraryFile(file.first)) continue;
     for (DesignElement& element : file.second->getDesignElements()) {
-      std::string elemName = st->getSymbol(element.m_name);
+      const std::string& elemName = st->getSymbol(element.m_name);
       if (element.m_type == DesignElement::Module) {
         if (element.m_parent) {
           // This is a nested element
@@ -312,7 +331,7 @@ bool DesignElaboration::identifyTopModules_() {
     if (moduleName == prevModuleName) {
       FileContent* fC1 = (*itr).second.second;
       NodeId nodeId1 = moduleDefinition->m_node;
-      std::string fileName1 = fC1->getFileName(nodeId1);
+      const std::string& fileName1 = fC1->getFileName(nodeId1);
       unsigned int line1 = fC1->Line(nodeId1);
       Location loc1(st->registerSymbol(fileName1), line1, 0,
                     st->registerSymbol(moduleName));
@@ -322,7 +341,7 @@ bool DesignElaboration::identifyTopModules_() {
       while (1) {
         FileContent* fC2 = prevFileContent;
         NodeId nodeId2 = prevModuleDefinition->m_node;
-        std::string fileName2 = fC2->getFileName(nodeId2);
+        const std::string& fileName2 = fC2->getFileName(nodeId2);
         unsigned int line2 = fC2->Line(nodeId2);
         Location loc2(st->registerSymbol(fileName2), line2, 0,
                       st->registerSymbol(moduleName));
@@ -399,11 +418,25 @@ bool DesignElaboration::createBuiltinPrimitives_() {
 
 bool DesignElaboration::elaborateAllModules_(bool onlyTopLevel) {
   bool status = true;
+  std::vector<PendingInstance> instances;
   for (auto topmodule : m_topLevelModules) {
-    if (!elaborateModule_(topmodule.first, topmodule.second, onlyTopLevel)) {
+    if (!elaborateModule_(topmodule.first, topmodule.second, onlyTopLevel,
+                          instances)) {
       status = false;
     }
   }
+  if (!onlyTopLevel) {
+    if (m_compileDesign->getCompiler()->getCommandLineParser()
+            ->lazyElaboration()) {
+      // The defparams are all collected before an access elaborates an
+      // instance: the instances that can declare one are elaborated now
+      findDefParamModules_();
+      elaborateLevels_(instances);
+      completeEagerScopes_();
+    } else {
+      elaborateLevels_(instances);
+    }
+  }
   return status;
 }
 
@@ -425,8 +458,9 @@ Config* DesignElaboration::getCellConfig(std::string name) {
   return config;
 }
 
-bool DesignElaboration::elaborateModule_(std::string moduleName,
-                                         FileContent* fC, bool onlyTopLevel) {
+bool DesignElaboration::elaborateModule_(
+    std::string moduleName, FileContent* fC, bool onlyTopLevel,
+    std::vector<PendingInstance>& instances) {
   FileContent::NameIdMap& nameIds = fC->getObjectLookup();
   std::vector<VObjectType> types = {VObjectType::slUdp_instantiation,
                                     VObjectType::slModule_instantiation,
@@ -436,7 +470,8 @@ bool DesignElaboration::elaborateModule_(std::string moduleName,
   Config* config = getInstConfig(moduleName);
   if (config == NULL) config = getCellConfig(moduleName);
   Design* design = m_compileDesign->getCompiler()->getDesign();
-  if (!m_moduleInstFactory) m_moduleInstFactory = new ModuleInstanceFactory();
+  if (!m_moduleInstFactory) m_moduleInstFactory = new ModuleInstanceFactory(
+        m_compileDesign->getCompiler()->getSymbolTable());
   for (auto nameId : nameIds) {
     if ((fC->Type(nameId.second) == VObjectType::slModule_declaration) &&
         (moduleName == (libName + "@" + nameId.first))) {
@@ -447,9 +482,12 @@ bool DesignElaboration::elaborateModule_(std::string moduleName,
         design->addTopLevelModuleInstance(instance);
       } else {
         ModuleInstance* instance = design->findInstance(moduleName);
-        for (unsigned int i = 0; i < def->getFileContents().size(); i++)
-          elaborateInstance_(def->getFileContents()[i], def->getNodeIds()[i], 0,
-                             m_moduleInstFactory, instance, config);
+        if (instance == NULL) break;
+        for (unsigned int i = 0; i < def->getFileContents().size(); i++) {
+          instances.push_back({def->getFileContents()[i], def->getNodeIds()[i],
+                               0, instance, config});
+          instances.back().order.push_back(instances.size());
+        }
       }
       break;
     }
@@ -457,12 +495,450 @@ bool DesignElaboration::elaborateModule_(std::string moduleName,
   return true;
 }
 
+void DesignElaboration::elaborateLevels_(
+    std::vector<PendingInstance>& instances) {
+  Compiler* compiler = m_compileDesign->getCompiler();
+  SymbolTable* symbols = compiler->getSymbolTable();
+  ThreadPool* pool = compiler->getThreadPool();
+  unsigned int nbWorkers = std::max(1u, pool->getNbThreads());
+  while (m_exprBuilders.size() < nbWorkers) {
+    m_exprBuilders.push_back(new ExprBuilder());
+    m_exprBuilders.back()->setFoldCache(&m_foldCache);
+  }
+  bool lazy = compiler->getCommandLineParser()->lazyElaboration();
+
+  // The instance tree is elaborated one depth at a time, the instances of a
+  // level are independent of each other: they only read their ancestors.
+  while (!instances.empty()) {
+    if (lazy) {
+      // The subtrees without defparams wait for an access
+      std::vector<PendingInstance> eager;
+      std::vector<PendingInstance> deferred;
+      for (PendingInstance& pending : instances) {
+        if (isUnitInstance_(pending.instance) &&
+            !declaresDefParams_(pending.instance->getDefinition()))
+          deferred.push_back(pending);
+        else
+          eager.push_back(pending);
+      }
+      deferInstances_(deferred);
+      instances.swap(eager);
+      if (instances.empty()) break;
+    }
+    // A defparam can set a parameter of an instance of its own level: the
+    // parameters and defparams of the whole level are committed before the
+    // bodies are elaborated
+    std::vector<std::vector<std::string>> params(instances.size());
+    std::vector<PendingInstance> next;
+    for (unsigned int phase = 0; phase < 2; phase++) {
+      // Contiguous slices, the entries of a same instance stay together
+      unsigned int chunkSize = instances.size() / (nbWorkers * 4) + 1;
+      std::vector<std::pair<unsigned int, unsigned int>> chunks;
+      unsigned int start = 0;
+      while (start < instances.size()) {
+        unsigned int end = std::min(start + chunkSize,
+                                    (unsigned int)instances.size());
+        while (end < instances.size() &&
+               instances[end].instance == instances[end - 1].instance)
+          end++;
+        chunks.push_back(std::make_pair(start, end));
+        start = end;
+      }
+      std::vector<LevelContext> contexts(chunks.size());
+      for (unsigned int c = 0; c < chunks.size(); c++) {
+        contexts[c].errors = new ErrorContainer(symbols);
+        contexts[c].errors->regiterCmdLine(compiler->getCommandLineParser());
+        pool->addJob([this, &instances, &chunks, &contexts, &params, c, phase,
+                      symbols](unsigned int workerIndex) {
+          LevelContext& context = contexts[c];
+          context.exprBuilder = m_exprBuilders[workerIndex];
+          context.exprBuilder->seterrorReporting(context.errors, symbols);
+          for (unsigned int i = chunks[c].first; i < chunks[c].second; i++) {
+            PendingInstance& pending = instances[i];
+            beginEntry_(context, pending);
+            if (phase == 0)
+              collectParams_(params[i], pending.fC, pending.nodeId,
+                             pending.instance, pending.paramOverride, context);
+            else
+              elaborateScope_(params[i], pending.fC, pending.nodeId,
+                              pending.paramOverride, m_moduleInstFactory,
+                              pending.instance, pending.config, context);
+          }
+        });
+      }
+      pool->wait();
+      std::vector<ModuleInstance*> targets;
+      commitLevel_(contexts, next, targets);
+      if (phase == 1) continue;
+      // A defparam on an instance of an earlier level: that instance is
+      // elaborated again, with the instances of the next level
+      if (!targets.empty()) {
+        std::vector<PendingInstance> kept;
+        std::vector<std::vector<std::string>> keptParams;
+        unsigned int nbInstances = instances.size();
+        reelaborate_(targets, instances, next);
+        for (unsigned int i = 0; i < nbInstances; i++) {
+          if (instances[i].instance == NULL) continue;
+          kept.push_back(instances[i]);
+          keptParams.push_back(params[i]);
+        }
+        instances.swap(kept);
+        params.swap(keptParams);
+      }
+      for (PendingInstance& pending : instances)
+        m_elaborated[pending.instance].push_back(pending);
+    }
+    instances.swap(next);
+  }
+  m_elaborated.clear();
+  flushMessages_();
+  for (ExprBuilder* exprBuilder : m_exprBuilders)
+    exprBuilder->seterrorReporting(compiler->getErrorContainer(), symbols);
+}
+
+void DesignElaboration::commitLevel_(std::vector<LevelContext>& contexts,
+                                     std::vector<PendingInstance>& next,
+                                     std::vector<ModuleInstance*>& targets) {
+  // Commit the level in tree order, the next level sees its defparams
+  Compiler* compiler = m_compileDesign->getCompiler();
+  Design* design = compiler->getDesign();
+  SymbolTable* st = compiler->getSymbolTable();
+  for (LevelContext& context : contexts) {
+    ErrorContainer defParamErrors(st);
+    defParamErrors.regiterCmdLine(compiler->getCommandLineParser());
+    for (PendingDefParam& defParam : context.defParams) {
+      // A defparam seen again, from an instance elaborated again, was
+      // already applied
+      DefParam* known = design->getDefParam(defParam.path);
+      if (known == NULL || known->getLocation() != defParam.fC ||
+          known->getNodeId() != defParam.nodeId) {
+        ModuleInstance* target = design->findInstance(
+            defParam.path.substr(0, defParam.path.rfind('.')));
+        if (target && m_elaborated.find(target) != m_elaborated.end())
+          targets.push_back(target);
+      }
+      unsigned int nbErrors = defParamErrors.getErrors().size();
+      design->addDefParam(defParam.path, defParam.fC, defParam.nodeId,
+                          defParam.value, &defParamErrors);
+      if (defParam.applied) design->getDefParam(defParam.path)->setUsed();
+      for (unsigned int i = nbErrors; i < defParamErrors.getErrors().size();
+           i++)
+        m_messages.push_back(
+            std::make_pair(defParam.order, defParamErrors.getErrors()[i]));
+    }
+    // The messages take the position of their entry
+    std::vector<Error>& errors = context.errors->getErrors();
+    unsigned int mark = 0;
+    for (unsigned int i = 0; i < errors.size(); i++) {
+      while (mark + 1 < context.marks.size() &&
+             context.marks[mark + 1].first <= i)
+        mark++;
+      m_messages.push_back(
+          std::make_pair(context.marks[mark].second, errors[i]));
+    }
+    delete context.errors;
+    next.insert(next.end(), context.pending.begin(), context.pending.end());
+  }
+  for (auto& definition : m_generateDefinitions)
+    design->addModuleDefinition(definition.first,
+                                (ModuleDefinition*)definition.second);
+  m_generateDefinitions.clear();
+}
+
+static bool isWithin(ModuleInstance* instance,
+                     const std::set<ModuleInstance*>& scopes) {
+  for (ModuleInstance* tmp = instance; tmp; tmp = tmp->getParent())
+    if (scopes.find(tmp) != scopes.end()) return true;
+  return false;
+}
+
+static bool hasPrefix(const std::vector<unsigned int>& order,
+                      const std::vector<unsigned int>& prefix) {
+  return order.size() >= prefix.size() &&
+         std::equal(prefix.begin(), prefix.end(), order.begin());
+}
+
+void DesignElaboration::reelaborate_(std::vector<ModuleInstance*>& targets,
+                                     std::vector<PendingInstance>& instances,
+                                     std::vector<PendingInstance>& next) {
+  std::set<ModuleInstance*> scopes(targets.begin(), targets.end());
+  std::vector<std::vector<unsigned int>> orders;
+  for (ModuleInstance* target : targets) {
+    // The subtree of a target is dropped with it
+    if (isWithin(target->getParent(), scopes)) continue;
+    auto itr = m_elaborated.find(target);
+    if (itr == m_elaborated.end()) continue;
+    target->clearSubInstances();
+    for (PendingInstance& pending : (*itr).second) {
+      orders.push_back(pending.order);
+      next.push_back(pending);
+    }
+    m_elaborated.erase(itr);
+  }
+  // The entries of the dropped subtrees are marked, the caller removes them
+  for (PendingInstance& pending : instances)
+    if (isWithin(pending.instance, scopes)) pending.instance = NULL;
+  // Lazy elaboration: so are their deferred instances
+  for (auto itr = m_lazyInstances.begin(); itr != m_lazyInstances.end();) {
+    if (isWithin((*itr).first, scopes)) {
+      (*itr).first->setLazyElaborator(NULL);
+      itr = m_lazyInstances.erase(itr);
+    } else {
+      itr++;
+    }
+  }
+  // Their messages are reported again
+  m_messages.erase(
+      std::remove_if(
+          m_messages.begin(), m_messages.end(),
+          [&orders](const std::pair<std::vector<unsigned int>, Error>& msg) {
+            for (auto& order : orders)
+              if (hasPrefix(msg.first, order)) return true;
+            return false;
+          }),
+      m_messages.end());
+}
+
+void DesignElaboration::beginEntry_(LevelContext& context,
+                                    const PendingInstance& entry) {
+  context.order = entry.order;
+  context.nbCreated = 0;
+  markMessages_(context);
+}
+
+void DesignElaboration::addPending_(LevelContext& context,
+                                    const PendingInstance& pending) {
+  // The recursive elaboration elaborated a sub-instance where it was
+  // created: its messages come before the next ones of its parent
+  context.pending.push_back(pending);
+  std::vector<unsigned int>& order = context.pending.back().order;
+  order = context.order;
+  order.push_back(2 * context.nbCreated + 1);
+  context.nbCreated++;
+  markMessages_(context);
+}
+
+void DesignElaboration::markMessages_(LevelContext& context) {
+  std::vector<unsigned int> order = context.order;
+  order.push_back(2 * context.nbCreated);
+  unsigned int nbErrors = context.errors->getErrors().size();
+  if (!context.marks.empty() && context.marks.back().first == nbErrors)
+    context.marks.back().second.swap(order);
+  else
+    context.marks.push_back(std::make_pair(nbErrors, order));
+}
+
+void DesignElaboration::flushMessages_() {
+  Compiler* compiler = m_compileDesign->getCompiler();
+  std::stable_sort(
+      m_messages.begin(), m_messages.end(),
+      [](const std::pair<std::vector<unsigned int>, Error>& a,
+         const std::pair<std::vector<unsigned int>, Error>& b) {
+        return a.first < b.first;
+      });
+  ErrorContainer sorted(compiler->getSymbolTable());
+  sorted.regiterCmdLine(compiler->getCommandLineParser());
+  for (auto& message : m_messages) sorted.addError(message.second);
+  compiler->getErrorContainer()->appendErrors(sorted);
+  m_messages.clear();
+}
+
+bool DesignElaboration::isUnitInstance_(ModuleInstance* instance) {
+  DesignComponent* def = instance->getDefinition();
+  if (def == NULL) return false;
+  VObjectType type = def->getType();
+  return (type == VObjectType::slModule_declaration ||
+          type == VObjectType::slInterface_declaration ||
+          type == VObjectType::slProgram_declaration);
+}
+
+void DesignElaboration::deferInstances_(
+    std::vector<PendingInstance>& instances) {
+  for (PendingInstance& pending : instances) {
+    m_lazyInstances[pending.instance].push_back(pending);
+    pending.instance->setLazyElaborator(this);
+  }
+}
+
+/* Module name without its library or enclosing module */
+static std::string baseName(const std::string& name) {
+  std::string::size_type pos = name.rfind("::");
+  if (pos != std::string::npos) return name.substr(pos + 2);
+  pos = name.find('@');
+  if (pos != std::string::npos) return name.substr(pos + 1);
+  return name;
+}
+
+void DesignElaboration::findDefParamModules_() {
+  Design* design = m_compileDesign->getCompiler()->getDesign();
+  std::vector<VObjectType> types = {VObjectType::slModule_instantiation,
+                                    VObjectType::slInterface_instantiation,
+                                    VObjectType::slProgram_instantiation};
+  // The generate constructs are not evaluated: a module is kept if any of
+  // its branches declares or instantiates a defparam
+  std::map<std::string, std::set<std::string>> instantiators;
+  std::vector<std::string> found;
+  for (auto& module : design->getModuleDefinitions()) {
+    ModuleDefinition* def = module.second;
+    std::string name = baseName(module.first);
+    for (unsigned int i = 0; i < def->getFileContents().size(); i++) {
+      FileContent* fC = def->getFileContents()[i];
+      if (fC == NULL) continue;
+      NodeId nodeId = def->getNodeIds()[i];
+      if (!fC->sl_collect_all(nodeId, VObjectType::slDefparam_assignment,
+                              true).empty())
+        found.push_back(name);
+      for (NodeId subInstanceId : fC->sl_collect_all(nodeId, types)) {
+        NodeId moduleName =
+            fC->sl_collect(subInstanceId, VObjectType::slStringConst);
+        std::string mname = fC->SymName(moduleName);
+        instantiators[mname].insert(name);
+        // A use clause binds the instance to another module
+        auto itr = m_cellUseClause.find(mname);
+        if (itr != m_cellUseClause.end() &&
+            (*itr).second.getType() == UseClause::UseModule)
+          instantiators[baseName((*itr).second.getName())].insert(name);
+      }
+    }
+  }
+  // Up the instantiations
+  while (!found.empty()) {
+    std::string name = found.back();
+    found.pop_back();
+    if (!m_defParamModules.insert(name).second) continue;
+    auto itr = instantiators.find(name);
+    if (itr == instantiators.end()) continue;
+    for (const std::string& instantiator : (*itr).second)
+      found.push_back(instantiator);
+  }
+}
+
+bool DesignElaboration::declaresDefParams_(DesignComponent* def) {
+  if (def == NULL) return false;
+  return m_defParamModules.find(baseName(def->getName())) !=
+         m_defParamModules.end();
+}
+
+void DesignElaboration::completeEagerScopes_() {
+  Design* design = m_compileDesign->getCompiler()->getDesign();
+  std::vector<ModuleInstance*> scopes;
+  std::queue<ModuleInstance*> queue;
+  for (auto instance : design->getTopLevelModuleInstances())
+    queue.push(instance);
+  while (queue.size()) {
+    ModuleInstance* current = queue.front();
+    queue.pop();
+    // A deferred subtree is completed when it is accessed
+    if (m_lazyInstances.find(current) != m_lazyInstances.end()) continue;
+    scopes.push_back(current);
+    for (unsigned int i = 0; i < current->getNbScalarChildren(); i++)
+      queue.push(current->getScalarChildren(i));
+  }
+  for (ModuleInstance* scope : scopes) reduceUnnamedBlock_(scope);
+  if (m_netlistElaboration) {
+    for (ModuleInstance* scope : scopes)
+      m_netlistElaboration->elaborateInstance(scope);
+  }
+}
+
+void DesignElaboration::elaborateSubInstances(ModuleInstance* instance) {
+  auto itr = m_lazyInstances.find(instance);
+  if (itr == m_lazyInstances.end()) return;
+  std::vector<PendingInstance> instances = (*itr).second;
+  m_lazyInstances.erase(itr);
+  Compiler* compiler = m_compileDesign->getCompiler();
+  if (m_exprBuilders.empty()) {
+    m_exprBuilders.push_back(new ExprBuilder());
+    m_exprBuilders.back()->setFoldCache(&m_foldCache);
+  }
+
+  // The generate and named blocks are part of the instance scope, they are
+  // elaborated with it. The module instances below are deferred.
+  std::vector<ModuleInstance*> scopes;
+  while (!instances.empty()) {
+    // Parameters and defparams first, as for a level
+    std::vector<std::vector<std::string>> params(instances.size());
+    std::vector<PendingInstance> next;
+    for (unsigned int phase = 0; phase < 2; phase++) {
+      std::vector<LevelContext> contexts(1);
+      LevelContext& context = contexts[0];
+      context.exprBuilder = m_exprBuilders[0];
+      context.errors = new ErrorContainer(compiler->getSymbolTable());
+      context.errors->regiterCmdLine(compiler->getCommandLineParser());
+      context.exprBuilder->seterrorReporting(context.errors,
+                                             compiler->getSymbolTable());
+      for (unsigned int i = 0; i < instances.size(); i++) {
+        PendingInstance& pending = instances[i];
+        beginEntry_(context, pending);
+        if (phase == 0) {
+          if (scopes.empty() || scopes.back() != pending.instance)
+            scopes.push_back(pending.instance);
+          collectParams_(params[i], pending.fC, pending.nodeId,
+                         pending.instance, pending.paramOverride, context);
+        } else {
+          elaborateScope_(params[i], pending.fC, pending.nodeId,
+                          pending.paramOverride, m_moduleInstFactory,
+                          pending.instance, pending.config, context);
+        }
+      }
+      // The instances above were elaborated without the defparams of an
+      // unvisited subtree
+      std::vector<ModuleInstance*> targets;
+      commitLevel_(contexts, next, targets);
+    }
+    instances.clear();
+    std::vector<PendingInstance> deferred;
+    for (PendingInstance& pending : next) {
+      if (isUnitInstance_(pending.instance))
+        deferred.push_back(pending);
+      else
+        instances.push_back(pending);
+    }
+    deferInstances_(deferred);
+  }
+  flushMessages_();
+  m_exprBuilders[0]->seterrorReporting(compiler->getErrorContainer(),
+                                       compiler->getSymbolTable());
+
+  for (ModuleInstance* scope : scopes) reduceUnnamedBlock_(scope);
+  if (m_netlistElaboration) {
+    for (ModuleInstance* scope : scopes)
+      m_netlistElaboration->elaborateInstance(scope);
+  }
+}
+
+void DesignElaboration::markUsed_(UseClause& use) {
+  m_mutex.lock();
+  use.setUsed();
+  m_mutex.unlock();
+}
+
+DesignComponent* DesignElaboration::getGenerateDefinition_(
+    FileContent* fC, NodeId nodeId, const std::string& fullName) {
+  Design* design = m_compileDesign->getCompiler()->getDesign();
+  DesignComponent* def = design->getComponentDefinition(fullName);
+  if (def) return def;
+  // The design definitions are only added between levels. The name holds
+  // the module and the block name: all the creators describe the same block
+  m_mutex.lock();
+  auto itr = m_generateDefinitions.find(fullName);
+  if (itr == m_generateDefinitions.end()) {
+    def = m_moduleDefFactory->newModuleDefinition(fC, nodeId, fullName);
+    m_generateDefinitions.insert(std::make_pair(fullName, def));
+  } else {
+    def = (*itr).second;
+  }
+  m_mutex.unlock();
+  return def;
+}
+
 void DesignElaboration::recurseInstanceLoop_(
     std::vector<int>& from, std::vector<int>& to, std::vector<int>& indexes,
     unsigned int pos, DesignComponent* def, FileContent* fC,
     NodeId subInstanceId, NodeId paramOverride, ModuleInstanceFactory* factory,
     ModuleInstance* parent, Config* config, std::string instanceName,
-    std::string modName, std::vector<ModuleInstance*>& allSubInstances) {
+    std::string modName, std::vector<ModuleInstance*>& allSubInstances,
+    LevelContext& context) {
   if (pos == indexes.size()) {
     // This is where the real logic goes.
     // indexes[i] contain the value of the i-th index.
@@ -474,8 +950,8 @@ void DesignElaboration::recurseInstanceLoop_(
     VObjectType type = fC->Type(subInstanceId);
     if (def && (type != VObjectType::slGate_instantiation))
       for (unsigned int i = 0; i < def->getFileContents().size(); i++)
-        elaborateInstance_(def->getFileContents()[i], def->getNodeIds()[i],
-                           paramOverride, factory, child, config);
+        addPending_(context, {def->getFileContents()[i], def->getNodeIds()[i],
+                              paramOverride, child, config});
     allSubInstances.push_back(child);
 
   } else {
@@ -483,7 +959,7 @@ void DesignElaboration::recurseInstanceLoop_(
       // Recurse for the next level
       recurseInstanceLoop_(from, to, indexes, pos + 1, def, fC, subInstanceId,
                            paramOverride, factory, parent, config, instanceName,
-                           modName, allSubInstances);
+                           modName, allSubInstances, context);
     }
   }
 }
@@ -492,33 +968,293 @@ void DesignElaboration::elaborateInstance_(FileContent* fC, NodeId nodeId,
                                            NodeId parentParamOverride,
                                            ModuleInstanceFactory* factory,
                                            ModuleInstance* parent,
-                                           Config* config) {
+                                           Config* config,
+                                           LevelContext& context) {
   if (!parent) return;
-  std::vector<ModuleInstance*> allSubInstances;
-  std::string genBlkBaseName = "genblk";
-  unsigned int genBlkIndex = 1;
-  bool reuseInstance = false;
-  std::string mname;
-  std::vector<VObjectType> types;
   std::vector<std::string> params;
 
   // Scan for parameters, including DefParams
-  collectParams_(params, fC, nodeId, parent, parentParamOverride);
+  collectParams_(params, fC, nodeId, parent, parentParamOverride, context);
+
+  elaborateScope_(params, fC, nodeId, parentParamOverride, factory, parent,
+                  config, context);
+}
+
+void DesignElaboration::elaborateScope_(const std::vector<std::string>& params,
+                                        FileContent* fC, NodeId nodeId,
+                                        NodeId paramOverride,
+                                        ModuleInstanceFactory* factory,
+                                        ModuleInstance* parent, Config* config,
+                                        LevelContext& context) {
+  if (!parent) return;
+  ExprBuilder& exprBuilder = *context.exprBuilder;
 
   // Apply DefParams
-  Design* design = m_compileDesign->getCompiler()->getDesign();
+  DefParam* defParamScope = defParamScope_(parent);
   for (auto name : params) {
-    DefParam* defparam =
-        design->getDefParam(parent->getFullPathName() + "." + name);
-    if (defparam) {
+    if (defParamScope == NULL) break;
+    auto itr = defParamScope->getChildren().find(name);
+    if (itr != defParamScope->getChildren().end()) {
+      DefParam* defparam = (*itr).second;
       Value* value = defparam->getValue();
       if (value) {
-        parent->setValue(name, value, m_exprBuilder);
+        parent->setValue(name, value, exprBuilder);
+        m_mutex.lock();
         defparam->setUsed();
+        m_mutex.unlock();
       }
     }
   }
 
+  // Identically parameterized instances share their body
+  std::string key = bodyKey_(fC, nodeId, paramOverride, parent, config);
+  if ((!key.empty()) && replayBody_(key, factory, parent, context)) return;
+  ModuleInstance::ParamVector scope = parent->getParamValues();
+  unsigned int pendingStart = context.pending.size();
+  bool reuseInstance =
+      elaborateBody_(fC, nodeId, factory, parent, config, context);
+  if ((!key.empty()) && (!reuseInstance))
+    recordBody_(key, parent, scope, context, pendingStart);
+}
+
+bool DesignElaboration::compressArray_(ModuleInstance* parent,
+                                       DesignComponent* def, VObjectType type,
+                                       const std::string& instName) {
+  // The elements are created as they are accessed
+  if (!m_compileDesign->getCompiler()->getCommandLineParser()
+           ->lazyElaboration())
+    return false;
+  if (def == NULL || type != VObjectType::slModule_instantiation) return false;
+  // The defparams of the elements are collected before any access
+  if (declaresDefParams_(def)) return false;
+  // Instance use clauses bind by hierarchical path
+  if (!m_instUseClause.empty()) return false;
+  // A defparam on an element makes it different from the others
+  DefParam* scope = defParamScope_(parent);
+  if (scope == NULL) return true;
+  auto itr = scope->getChildren().lower_bound(instName);
+  if (itr == scope->getChildren().end()) return true;
+  return (*itr).first.compare(0, instName.size(), instName) != 0;
+}
+
+ModuleInstance* DesignElaboration::elaborateArrayElement(InstanceArray* array,
+                                                         unsigned int index) {
+  DesignComponent* def = array->getDefinition();
+  ModuleInstance* element = m_moduleInstFactory->newModuleInstance(
+      def, array->getFileContent(), array->getNodeId(), array->getParent(),
+      array->getElementName(index), array->getModuleName());
+  std::vector<PendingInstance> pending;
+  for (unsigned int i = 0; i < def->getFileContents().size(); i++)
+    pending.push_back({def->getFileContents()[i], def->getNodeIds()[i],
+                       array->getParamOverride(), element,
+                       array->getConfig()});
+  deferInstances_(pending);
+  return element;
+}
+
+DefParam* DesignElaboration::defParamScope_(ModuleInstance* instance) {
+  Design* design = m_compileDesign->getCompiler()->getDesign();
+  unsigned int generation = design->getDefParamGeneration();
+  if (instance->getDefParamGeneration() == generation)
+    return instance->getDefParamScope();
+  // Trie nodes are never removed: a resolved node stays valid, a missing one
+  // only holds for the generation it was resolved at
+  std::vector<ModuleInstance*> chain;
+  DefParam* scope = NULL;
+  bool known = false;
+  for (ModuleInstance* tmp = instance; tmp; tmp = tmp->getParent()) {
+    if ((tmp != instance) && (tmp->getDefParamScope() ||
+                              tmp->getDefParamGeneration() == generation)) {
+      scope = tmp->getDefParamScope();
+      known = true;
+      break;
+    }
+    chain.push_back(tmp);
+  }
+  if ((!known) || scope) {
+    for (int i = chain.size() - 1; i >= 0; i--) {
+      scope = design->getDefParam(scope, chain[i]);
+      if (scope == NULL) break;
+    }
+  }
+  instance->setDefParamScope(scope, generation);
+  return scope;
+}
+
+std::string DesignElaboration::bodyKey_(FileContent* fC, NodeId nodeId,
+                                        NodeId paramOverride,
+                                        ModuleInstance* instance,
+                                        Config* config) {
+  // Instance use clauses bind by hierarchical path
+  if (!m_instUseClause.empty()) return "";
+  // Generate and named blocks see the parameters of the enclosing scopes, a
+  // module only sees its own
+  if (!isUnitInstance_(instance)) return "";
+  SymbolTable* st = m_compileDesign->getCompiler()->getSymbolTable();
+  std::string key;
+  // Interned ids, the same from one run to the next
+  SymbolId ids[] = {
+      st->registerSymbol(instance->getDefinition()->getName()),
+      st->registerSymbol(fC->getFileName(nodeId)),
+      config ? st->registerSymbol(config->getName()) : 0};
+  key.append((const char*)ids, sizeof(ids));
+  key.append((const char*)&nodeId, sizeof(nodeId));
+  for (auto& value : instance->getParamValues()) {
+    SymbolId name = st->registerSymbol(*value.first);
+    key.append((const char*)&name, sizeof(name));
+    char known = (value.second != NULL);
+    key += known;
+    if (value.second) FoldCache::appendValueKey(key, value.second);
+  }
+  if (!overrideKey_(key, instance, paramOverride)) return "";
+  return key;
+}
+
+bool DesignElaboration::overrideKey_(std::string& key,
+                                     ModuleInstance* instance,
+                                     NodeId paramOverride) {
+  if (!paramOverride) return true;
+  ModuleInstance* parent = instance->getParent();
+  if (parent == NULL || parent->getDefinition() == NULL) return false;
+  SymbolTable* st = m_compileDesign->getCompiler()->getSymbolTable();
+  FileContent* fC = parent->getDefinition()->getFileContents()[0];
+  std::vector<VObjectType> types = {VObjectType::slOrdered_parameter_assignment,
+                                    VObjectType::slNamed_parameter_assignment};
+  for (NodeId assign : fC->sl_collect_all(paramOverride, types)) {
+    NodeId expr = fC->Child(assign);
+    if (fC->Type(expr) == VObjectType::slStringConst) expr = fC->Sibling(expr);
+    if (!expr) continue;
+    // A type name parses as an expression: the names that are not values of
+    // the parent are keyed. A data type is keyed on all its nodes
+    bool dataType = (fC->Type(fC->Child(expr)) == VObjectType::slData_type);
+    std::vector<NodeId> stack;
+    stack.push_back(fC->Child(expr));
+    while (!stack.empty()) {
+      NodeId id = stack.back();
+      stack.pop_back();
+      if (!id) continue;
+      stack.push_back(fC->Sibling(id));
+      stack.push_back(fC->Child(id));
+      VObjectType type = fC->Type(id);
+      if (dataType) key.append((const char*)&type, sizeof(type));
+      if (type != VObjectType::slStringConst) continue;
+      // The dimensions of a type read the parameters of the parent
+      const std::string& name = fC->SymName(id);
+      Value* value = parent->getValue(name);
+      if (value && !dataType) continue;
+      SymbolId nameId = st->registerSymbol(name);
+      key.append((const char*)&nameId, sizeof(nameId));
+      if (value) FoldCache::appendValueKey(key, value);
+    }
+  }
+  return true;
+}
+
+bool DesignElaboration::replayBody_(const std::string& key,
+                                    ModuleInstanceFactory* factory,
+                                    ModuleInstance* instance,
+                                    LevelContext& context) {
+  m_mutex.lock();
+  auto itr = m_instanceBodies.find(key);
+  InstanceBody* body =
+      (itr == m_instanceBodies.end()) ? NULL : (*itr).second;
+  m_mutex.unlock();
+  if (body == NULL) return false;
+
+  // An instantiation loop is only reported by a full elaboration
+  for (auto& child : body->children) {
+    if (child.def == NULL) continue;
+    for (ModuleInstance* tmp = instance; tmp; tmp = tmp->getParent()) {
+      if (tmp->getDefinition() == child.def) return false;
+    }
+  }
+
+  ExprBuilder& exprBuilder = *context.exprBuilder;
+  for (auto& value : body->scopeValues)
+    instance->setValue(value.first, exprBuilder.clone(value.second),
+                       exprBuilder);
+  std::vector<ModuleInstance*> children;
+  for (auto& child : body->children) {
+    ModuleInstance* subInstance =
+        factory->newModuleInstance(child.def, child.fC, child.nodeId, instance,
+                                   child.instName, child.modName);
+    subInstance->shareValues(&child.values);
+    children.push_back(subInstance);
+  }
+  for (auto& pending : body->pending) {
+    addPending_(context, pending.second);
+    context.pending.back().instance = children[pending.first];
+  }
+  if (children.size()) {
+    ModuleInstance** subInstances = new ModuleInstance*[children.size()];
+    for (unsigned int index = 0; index < children.size(); index++) {
+      subInstances[index] = children[index];
+    }
+    instance->addSubInstances(subInstances, children.size());
+  }
+  return true;
+}
+
+void DesignElaboration::recordBody_(const std::string& key,
+                                    ModuleInstance* instance,
+                                    ModuleInstance::ParamVector& scope,
+                                    LevelContext& context,
+                                    unsigned int pendingStart) {
+  // The elements of the instance arrays are not expanded
+  if (instance->getNbInstanceArrays()) return;
+  ExprBuilder& exprBuilder = *context.exprBuilder;
+  InstanceBody* body = new InstanceBody();
+  // Values the body set on the instance itself (genvars), both vectors are
+  // sorted by name
+  unsigned int index = 0;
+  for (auto& value : instance->getParamValues()) {
+    while (index < scope.size() && *scope[index].first < *value.first)
+      index++;
+    if (index == scope.size() || scope[index].first != value.first ||
+        scope[index].second != value.second)
+      body->scopeValues.push_back(
+          std::make_pair(*value.first, exprBuilder.clone(value.second)));
+  }
+  std::map<ModuleInstance*, unsigned int> childIndexes;
+  for (unsigned int i = 0; i < instance->getNbChildren(); i++) {
+    ModuleInstance* child = instance->getChildren(i);
+    childIndexes.insert(std::make_pair(child, i));
+    InstanceBody::Child spec;
+    spec.def = child->getDefinition();
+    spec.fC = child->getFileContent();
+    spec.nodeId = child->getNodeId();
+    spec.instName = child->getInstanceName();
+    spec.modName = child->getModuleName();
+    for (auto& value : child->getParamValues())
+      spec.values.push_back(
+          std::make_pair(value.first, exprBuilder.clone(value.second)));
+    body->children.push_back(spec);
+  }
+  // Sub-instances the body dropped are not part of the tree
+  for (unsigned int i = pendingStart; i < context.pending.size(); i++) {
+    auto itr = childIndexes.find(context.pending[i].instance);
+    if (itr != childIndexes.end())
+      body->pending.push_back(std::make_pair((*itr).second, context.pending[i]));
+  }
+
+  m_mutex.lock();
+  if (!m_instanceBodies.insert(std::make_pair(key, body)).second) delete body;
+  m_mutex.unlock();
+}
+
+bool DesignElaboration::elaborateBody_(FileContent* fC, NodeId nodeId,
+                                       ModuleInstanceFactory* factory,
+                                       ModuleInstance* parent, Config* config,
+                                       LevelContext& context) {
+  ExprBuilder& exprBuilder = *context.exprBuilder;
+  Design* design = m_compileDesign->getCompiler()->getDesign();
+  std::vector<ModuleInstance*> allSubInstances;
+  std::string genBlkBaseName = "genblk";
+  unsigned int genBlkIndex = 1;
+  bool reuseInstance = false;
+  std::string mname;
+  std::vector<VObjectType> types;
+
   // Scan for regular instances and generate blocks
   types = {
       VObjectType::slUdp_instantiation,
@@ -652,12 +1388,7 @@ void DesignElaboration::elaborateInstance_(FileContent* fC, NodeId nodeId,
       } else {
         fullName += parent->getModuleName() + "." + instName;
       }
-      def = design->getComponentDefinition(fullName);
-      if (def == NULL) {
-        def = m_moduleDefFactory->newModuleDefinition(fC, subInstanceId,
-                                                      fullName);
-        design->addModuleDefinition(fullName, (ModuleDefinition*)def);
-      }
+      def = getGenerateDefinition_(fC, subInstanceId, fullName);
 
       NodeId conditionId = fC->Child(subInstanceId);
 
@@ -668,9 +1399,9 @@ void DesignElaboration::elaborateInstance_(FileContent* fC, NodeId nodeId,
         // Var init
         NodeId varId = fC->Child(conditionId);
         NodeId constExpr = fC->Sibling(varId);
-        Value* initValue = m_exprBuilder.evalExpr(fC, constExpr, parent);
         std::string name = fC->SymName(varId);
-        parent->setValue(name, initValue, m_exprBuilder);
+        parent->copyValue(name, exprBuilder.evalView(fC, constExpr, parent),
+                          exprBuilder);
 
         // End-loop test
         NodeId endLoopTest = fC->Sibling(conditionId);
@@ -686,10 +1417,7 @@ void DesignElaboration::elaborateInstance_(FileContent* fC, NodeId nodeId,
         // Generate block
         NodeId genBlock = fC->Sibling(iteration);
 
-        bool cont = true;
-        Value* testCond = m_exprBuilder.evalExpr(fC, endLoopTest, parent);
-        cont = testCond->getValueUL();
-        m_exprBuilder.deleteValue(testCond);
+        bool cont = exprBuilder.evalView(fC, endLoopTest, parent)->getValueUL();
 
         while (cont) {
           Value* currentIndexValue = parent->getValue(name);
@@ -699,16 +1427,16 @@ void DesignElaboration::elaborateInstance_(FileContent* fC, NodeId nodeId,
           instName = indexedModName;
           ModuleInstance* child = factory->newModuleInstance(
               def, fC, genBlock, parent, instName, indexedModName);
-          child->setValue(name, currentIndexValue, m_exprBuilder);
-          elaborateInstance_(def->getFileContents()[0], genBlock, 0, factory,
-                             child, config);
+          // The parent index value changes before the child is elaborated
+          child->setValue(name, exprBuilder.clone(currentIndexValue),
+                          exprBuilder);
+          addPending_(context,
+                      {def->getFileContents()[0], genBlock, 0, child, config});
           allSubInstances.push_back(child);
 
-          Value* newVal = m_exprBuilder.evalExpr(fC, expr, parent);
-          parent->setValue(name, newVal, m_exprBuilder);
-          Value* testCond = m_exprBuilder.evalExpr(fC, endLoopTest, parent);
-          cont = testCond->getValueUL();
-          m_exprBuilder.deleteValue(testCond);
+          parent->copyValue(name, exprBuilder.evalView(fC, expr, parent),
+                            exprBuilder);
+          cont = exprBuilder.evalView(fC, endLoopTest, parent)->getValueUL();
         }
         if (allSubInstances.size()) {
           ModuleInstance** children =
@@ -725,9 +1453,8 @@ void DesignElaboration::elaborateInstance_(FileContent* fC, NodeId nodeId,
         if (fC->Type(conditionId) != VObjectType::slConstant_expression) {
           conditionId = fC->Child(conditionId);
         }
-        Value* condValue = m_exprBuilder.evalExpr(fC, conditionId, parent);
-        long condVal = condValue->getValueUL();
-        m_exprBuilder.deleteValue(condValue);
+        long condVal =
+            exprBuilder.evalView(fC, conditionId, parent)->getValueUL();
         NodeId tmp = fC->Sibling(conditionId);
         if (fC->Type(tmp) == VObjectType::slCase_generate_item) {  // Case stmt
           NodeId caseItem = tmp;
@@ -740,9 +1467,8 @@ void DesignElaboration::elaborateInstance_(FileContent* fC, NodeId nodeId,
             while (nomatch) {
               // Find if one of the case expr matches the case expr
               if (fC->Type(exprItem) == VObjectType::slConstant_expression) {
-                Value* caseValue = m_exprBuilder.evalExpr(fC, exprItem, parent);
-                long caseVal = caseValue->getValueUL();
-                m_exprBuilder.deleteValue(caseValue);
+                long caseVal =
+                    exprBuilder.evalView(fC, exprItem, parent)->getValueUL();
                 if (condVal == caseVal) {
                   nomatch = false;
                   break;
@@ -783,17 +1509,12 @@ void DesignElaboration::elaborateInstance_(FileContent* fC, NodeId nodeId,
 
       libName = fC->getLibrary()->getName();
       fullName = parent->getModuleName() + "." + instName;
-      def = design->getComponentDefinition(fullName);
-      if (def == NULL) {
-        def = m_moduleDefFactory->newModuleDefinition(fC, subInstanceId,
-                                                      fullName);
-        design->addModuleDefinition(fullName, (ModuleDefinition*)def);
-      }
+      def = getGenerateDefinition_(fC, subInstanceId, fullName);
 
       ModuleInstance* child = factory->newModuleInstance(
           def, fC, subInstanceId, parent, instName, modName);
-      elaborateInstance_(def->getFileContents()[0], childId, paramOverride,
-                         factory, child, config);
+      addPending_(context, {def->getFileContents()[0], childId, paramOverride,
+                            child, config});
       allSubInstances.push_back(child);
 
     }
@@ -802,17 +1523,12 @@ void DesignElaboration::elaborateInstance_(FileContent* fC, NodeId nodeId,
       std::string libName = fC->getLibrary()->getName();
       std::string fullName = parent->getModuleName() + "." + instName;
 
-      def = design->getComponentDefinition(fullName);
-      if (def == NULL) {
-        def = m_moduleDefFactory->newModuleDefinition(fC, subInstanceId,
-                                                      fullName);
-        design->addModuleDefinition(fullName, (ModuleDefinition*)def);
-      }
+      def = getGenerateDefinition_(fC, subInstanceId, fullName);
 
       ModuleInstance* child = factory->newModuleInstance(
           def, fC, subInstanceId, parent, instName, modName);
-      elaborateInstance_(def->getFileContents()[0], subInstanceId,
-                         paramOverride, factory, child, config);
+      addPending_(context, {def->getFileContents()[0], subInstanceId,
+                            paramOverride, child, config});
       allSubInstances.push_back(child);
 
     }
@@ -854,7 +1570,7 @@ void DesignElaboration::elaborateInstance_(FileContent* fC, NodeId nodeId,
           case UseClause::UseModule: {
             std::string name = use.getName();
             def = design->getComponentDefinition(name);
-            if (def) use.setUsed();
+            if (def) markUsed_(use);
             break;
           }
           case UseClause::UseLib: {
@@ -862,7 +1578,7 @@ void DesignElaboration::elaborateInstance_(FileContent* fC, NodeId nodeId,
               modName = lib + "@" + mname;
               def = design->getComponentDefinition(modName);
               if (def) {
-                use.setUsed();
+                markUsed_(use);
                 break;
               }
             }
@@ -899,7 +1615,7 @@ void DesignElaboration::elaborateInstance_(FileContent* fC, NodeId nodeId,
                           tmp->getFileContent()->getFileName(tmp->getNodeId())),
                       tmp->getFileContent()->Line(tmp->getNodeId()), 0);
         Error err(ErrorDefinition::ELAB_INSTANTIATION_LOOP, loc, loc2);
-        m_compileDesign->getCompiler()->getErrorContainer()->addError(err);
+        context.errors->addError(err);
       } else {
         std::vector<int> from;
         std::vector<int> to;
@@ -934,7 +1650,7 @@ void DesignElaboration::elaborateInstance_(FileContent* fC, NodeId nodeId,
               case UseClause::UseModule: {
                 std::string name = use.getName();
                 def = design->getComponentDefinition(name);
-                if (def) use.setUsed();
+                if (def) markUsed_(use);
                 break;
               }
               case UseClause::UseLib: {
@@ -942,7 +1658,7 @@ void DesignElaboration::elaborateInstance_(FileContent* fC, NodeId nodeId,
                   modName = lib + "@" + mname;
                   def = design->getComponentDefinition(modName);
                   if (def) {
-                    use.setUsed();
+                    markUsed_(use);
                     break;
                   }
                 }
@@ -957,7 +1673,7 @@ void DesignElaboration::elaborateInstance_(FileContent* fC, NodeId nodeId,
                   std::string top = config->getDesignTop();
                   modName = lib + "@" + top;
                   def = design->getComponentDefinition(modName);
-                  if (def) use.setUsed();
+                  if (def) markUsed_(use);
                 }
               }
               default:
@@ -975,8 +1691,7 @@ void DesignElaboration::elaborateInstance_(FileContent* fC, NodeId nodeId,
                          fC->Line(subInstanceId), 0,
                          st->registerSymbol(modName));
             Error err(ErrorDefinition::ELAB_NO_MODULE_DEFINITION, loc);
-            m_compileDesign->getCompiler()->getErrorContainer()->addError(
-                err, false, false);
+            context.errors->addError(err, false, false);
           }
 
           NodeId unpackedDimId = 0;
@@ -990,12 +1705,10 @@ void DesignElaboration::elaborateInstance_(FileContent* fC, NodeId nodeId,
                 NodeId constantRangeId = fC->Child(unpackedDimId);
                 NodeId leftNode = fC->Child(constantRangeId);
                 NodeId rightNode = fC->Sibling(leftNode);
-                Value* leftVal = m_exprBuilder.evalExpr(fC, leftNode, parent);
-                Value* rightVal = m_exprBuilder.evalExpr(fC, rightNode, parent);
-                unsigned long left = leftVal->getValueUL();
-                unsigned long right = rightVal->getValueUL();
-                m_exprBuilder.deleteValue(leftVal);
-                m_exprBuilder.deleteValue(rightVal);
+                unsigned long left =
+                    exprBuilder.evalView(fC, leftNode, parent)->getValueUL();
+                unsigned long right =
+                    exprBuilder.evalView(fC, rightNode, parent)->getValueUL();
                 if (left < right) {
                   from.push_back(left);
                   to.push_back(right);
@@ -1008,9 +1721,18 @@ void DesignElaboration::elaborateInstance_(FileContent* fC, NodeId nodeId,
               }
               unpackedDimId = fC->Sibling(unpackedDimId);
             }
-            recurseInstanceLoop_(from, to, index, 0, def, fC, subInstanceId,
-                                 paramOverride, factory, parent, subConfig,
-                                 instName, modName, allSubInstances);
+            if (compressArray_(parent, def, type, instName)) {
+              InstanceArray* array = new InstanceArray(
+                  parent, def, fC, subInstanceId, paramOverride, subConfig,
+                  instName, modName, from, to, allSubInstances.size(), this);
+              parent->addInstanceArray(array);
+              m_mutex.lock();
+              m_lazyArrays.push_back(array);
+              m_mutex.unlock();
+            } else
+              recurseInstanceLoop_(from, to, index, 0, def, fC, subInstanceId,
+                                   paramOverride, factory, parent, subConfig,
+                                   instName, modName, allSubInstances, context);
           } else {
             // Simple instance
             ModuleInstance* child = NULL;
@@ -1021,9 +1743,16 @@ void DesignElaboration::elaborateInstance_(FileContent* fC, NodeId nodeId,
               child = factory->newModuleInstance(def, fC, subInstanceId, parent,
                                                  instName, modName);
             }
-            if (def && (type != VObjectType::slGate_instantiation))
-              elaborateInstance_(def->getFileContents()[0], childId,
-                                 paramOverride, factory, child, subConfig);
+            if (def && (type != VObjectType::slGate_instantiation)) {
+              // A reused instance is still being elaborated by this job
+              if (reuseInstance)
+                elaborateInstance_(def->getFileContents()[0], childId,
+                                   paramOverride, factory, child, subConfig,
+                                   context);
+              else
+                addPending_(context, {def->getFileContents()[0], childId,
+                                      paramOverride, child, subConfig});
+            }
 
             if (!reuseInstance) allSubInstances.push_back(child);
           }
@@ -1044,6 +1773,7 @@ void DesignElaboration::elaborateInstance_(FileContent* fC, NodeId nodeId,
     }
     parent->addSubInstances(children, allSubInstances.size());
   }
+  return reuseInstance;
 }
 
 void DesignElaboration::reportElaboration_() {
@@ -1102,12 +1832,14 @@ void DesignElaboration::reportElaboration_() {
 void DesignElaboration::collectParams_(std::vector<std::string>& params,
                                        FileContent* fC, NodeId nodeId,
                                        ModuleInstance* instance,
-                                       NodeId parentParamOverride) {
+                                       NodeId parentParamOverride,
+                                       LevelContext& context) {
   if (!nodeId) return;
   if (!instance) return;
   Design* design = m_compileDesign->getCompiler()->getDesign();
   SymbolTable* st = m_compileDesign->getCompiler()->getSymbolTable();
-  ErrorContainer* errors = m_compileDesign->getCompiler()->getErrorContainer();
+  ErrorContainer* errors = context.errors;
+  ExprBuilder& exprBuilder = *context.exprBuilder;
   DesignComponent* module = instance->getDefinition();
 
   // Parameters imported by package imports
@@ -1121,7 +1853,7 @@ void DesignElaboration::collectParams_(std::vector<std::string>& params,
 
   for (auto pack_import : pack_imports) {
     NodeId pack_id = pack_import.fC->Child(pack_import.nodeId);
-    std::string pack_name = pack_import.fC->SymName(pack_id);
+    const std::string& pack_name = pack_import.fC->SymName(pack_id);
     Package* def = design->getPackage(pack_name);
     if (def) {
       auto& paramSet = def->getObjects(VObjectType::slParam_assignment);
@@ -1131,8 +1863,8 @@ void DesignElaboration::collectParams_(std::vector<std::string>& params,
 
         NodeId ident = packageFile->Child(param);
         std::string name = packageFile->SymName(ident);
-        Value* value = m_exprBuilder.clone(def->getValues()[i]);
-        instance->setValue(name, value, m_exprBuilder);
+        Value* value = exprBuilder.clone(def->getValues()[i]);
+        instance->setValue(name, value, exprBuilder);
         params.push_back(name);
       }
     } else {
@@ -1149,8 +1881,8 @@ void DesignElaboration::collectParams_(std::vector<std::string>& params,
     NodeId ident = param.fC->Child(param.nodeId);
     std::string name = param.fC->SymName(ident);
     Value* value =
-        m_exprBuilder.evalExpr(param.fC, param.fC->Sibling(ident), instance);
-    instance->setValue(name, value, m_exprBuilder);
+        exprBuilder.evalExpr(param.fC, param.fC->Sibling(ident), instance);
+    instance->setValue(name, value, exprBuilder);
     params.push_back(name);
   }
 
@@ -1172,13 +1904,13 @@ void DesignElaboration::collectParams_(std::vector<std::string>& params,
         std::string name = parentFile->SymName(child);
         NodeId expr = parentFile->Sibling(child);
         Value* value =
-            m_exprBuilder.evalExpr(parentFile, expr, instance->getParent());
-        instance->setValue(name, value, m_exprBuilder);
+            exprBuilder.evalExpr(parentFile, expr, instance->getParent());
+        instance->setValue(name, value, exprBuilder);
       } else {
         // Index param
         NodeId expr = child;
         Value* value =
-            m_exprBuilder.evalExpr(parentFile, expr, instance->getParent());
+            exprBuilder.evalExpr(parentFile, expr, instance->getParent());
         std::string name = "OUT_OF_RANGE_PARAM_INDEX";
         if (index < params.size()) {
           name = params[index];
@@ -1189,7 +1921,7 @@ void DesignElaboration::collectParams_(std::vector<std::string>& params,
           Error err(ErrorDefinition::ELAB_OUT_OF_RANGE_PARAM_INDEX, loc);
           errors->addError(err);
         }
-        instance->setValue(name, value, m_exprBuilder);
+        instance->setValue(name, value, exprBuilder);
         index++;
       }
     }
@@ -1211,7 +1943,7 @@ void DesignElaboration::collectParams_(std::vector<std::string>& params,
     NodeId hIdent = fC->Child(defParam);
     NodeId var = fC->Child(hIdent);
     NodeId value = fC->Sibling(hIdent);
-    std::string fullPath = fC->SymName(var);
+    const std::string& fullPath = fC->SymName(var);
     std::string path;
     for (unsigned int i = 0; i < fullPath.size(); i++) {
       if (fullPath[i] == '.') break;
@@ -1235,8 +1967,21 @@ void DesignElaboration::collectParams_(std::vector<std::string>& params,
       prefix = instance->getFullPathName() + ".";
     }
     path = prefix + path;
-    Value* val = m_exprBuilder.evalExpr(fC, value, instance);
-    design->addDefParam(path, fC, hIdent, val);
+    Value* val = exprBuilder.evalExpr(fC, value, instance);
+    // A defparam on a parameter of the instance itself is applied before the
+    // body sees the parameter
+    bool applied = false;
+    std::string self = instance->getFullPathName() + ".";
+    if ((path.compare(0, self.size(), self) == 0) &&
+        (path.find('.', self.size()) == std::string::npos)) {
+      std::string name = path.substr(self.size());
+      if (std::find(params.begin(), params.end(), name) != params.end()) {
+        instance->setValue(name, exprBuilder.clone(val), exprBuilder);
+        applied = true;
+      }
+    }
+    context.defParams.push_back({path, fC, hIdent, val, applied,
+                                 context.marks.back().second});
   }
 }
 
@@ -1285,37 +2030,41 @@ void DesignElaboration::reduceUnnamedBlocks_() {
     for (unsigned int i = 0; i < current->getNbChildren(); i++) {
       queue.push(current->getChildren(i));
     }
-    FileContent* fC = current->getFileContent();
-    NodeId id = current->getNodeId();
-    VObjectType type = fC->Type(id);
-
-    ModuleInstance* parent = current->getParent();
-    if (parent) {
-      FileContent* fCP = parent->getFileContent();
-      NodeId idP = parent->getNodeId();
-      VObjectType typeP = fCP->Type(idP);
-
-      if ((type == VObjectType::slConditional_generate_construct ||
-           type == VObjectType::slGenerate_module_conditional_statement ||
-           type == VObjectType::slLoop_generate_construct ||
-           type == VObjectType::slGenerate_module_loop_statement) &&
-          (typeP == VObjectType::slConditional_generate_construct ||
-           typeP == VObjectType::slGenerate_module_conditional_statement ||
-           typeP == VObjectType::slLoop_generate_construct ||
-           typeP == VObjectType::slGenerate_module_loop_statement)) {
-        std::string fullModName = current->getModuleName();
-        fullModName = StringUtils::leaf(fullModName);
-        std::string fullModNameP = parent->getModuleName();
-        fullModNameP = StringUtils::leaf(fullModNameP);
-        if (strstr(fullModName.c_str(), "genblk")) {
-          if (fullModName == fullModNameP)
-            parent->getParent()->overrideParentChild(parent->getParent(),
-                                                     parent, current);
-        } else {
-          if (strstr(fullModNameP.c_str(), "genblk"))
-            parent->getParent()->overrideParentChild(parent->getParent(),
-                                                     parent, current);
-        }
+    reduceUnnamedBlock_(current);
+  }
+}
+
+void DesignElaboration::reduceUnnamedBlock_(ModuleInstance* current) {
+  FileContent* fC = current->getFileContent();
+  NodeId id = current->getNodeId();
+  VObjectType type = fC->Type(id);
+
+  ModuleInstance* parent = current->getParent();
+  if (parent) {
+    FileContent* fCP = parent->getFileContent();
+    NodeId idP = parent->getNodeId();
+    VObjectType typeP = fCP->Type(idP);
+
+    if ((type == VObjectType::slConditional_generate_construct ||
+         type == VObjectType::slGenerate_module_conditional_statement ||
+         type == VObjectType::slLoop_generate_construct ||
+         type == VObjectType::slGenerate_module_loop_statement) &&
+        (typeP == VObjectType::slConditional_generate_construct ||
+         typeP == VObjectType::slGenerate_module_conditional_statement ||
+         typeP == VObjectType::slLoop_generate_construct ||
+         typeP == VObjectType::slGenerate_module_loop_statement)) {
+      std::string fullModName = current->getModuleName();
+      fullModName = StringUtils::leaf(fullModName);
+      std::string fullModNameP = parent->getModuleName();
+      fullModNameP = StringUtils::leaf(fullModNameP);
+      if (strstr(fullModName.c_str(), "genblk")) {
+        if (fullModName == fullModNameP)
+          parent->getParent()->overrideParentChild(parent->getParent(),
+                                                   parent, current);
+      } else {
+        if (strstr(fullModNameP.c_str(), "genblk"))
+          parent->getParent()->overrideParentChild(parent->getParent(),
+                                                   parent, current);
       }
     }
   }
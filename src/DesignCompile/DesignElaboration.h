@@ -24,13 +24,18 @@
 #ifndef DESIGNELABORATION_H
 #define DESIGNELABORATION_H
 
+#include <mutex>
+#include <unordered_map>
 #include "DesignCompile/ElaborationStep.h"
 #include "TestbenchElaboration.h"
 #include "Expression/ExprBuilder.h"
+#include "Expression/FoldCache.h"
 
 namespace SURELOG {
 
-class DesignElaboration : public TestbenchElaboration {
+class NetlistElaboration;
+
+class DesignElaboration : public TestbenchElaboration, public LazyElaborator {
  public:
   DesignElaboration(CompileDesign* compileDesign);
   DesignElaboration(const DesignElaboration& orig) = delete;
@@ -40,7 +45,68 @@ class DesignElaboration : public TestbenchElaboration {
 
   bool elaborate() override;
 
+  /* Lazy elaboration: the netlist of an instance is elaborated with its
+     sub-instances */
+  void setNetlistElaboration(NetlistElaboration* netlistElaboration) {
+    m_netlistElaboration = netlistElaboration;
+  }
+  void elaborateSubInstances(ModuleInstance* instance) override;
+  ModuleInstance* elaborateArrayElement(InstanceArray* array,
+                                        unsigned int index) override;
+
  private:
+  /* An instance whose sub-instances are elaborated with the next level */
+  struct PendingInstance {
+    FileContent* fC;
+    NodeId nodeId;
+    NodeId paramOverride;
+    ModuleInstance* instance;
+    Config* config;
+    /* Position in the depth first elaboration, orders the messages */
+    std::vector<unsigned int> order;
+  };
+  struct PendingDefParam {
+    std::string path;
+    FileContent* fC;
+    NodeId nodeId;
+    Value* value;
+    /* Set on a parameter of the declaring instance itself */
+    bool applied;
+    std::vector<unsigned int> order;
+  };
+  /* State of one job of a level: what it adds to the design is only
+     committed, in tree order, once the whole level is elaborated */
+  struct LevelContext {
+    ExprBuilder* exprBuilder;
+    ErrorContainer* errors;
+    std::vector<PendingInstance> pending;
+    std::vector<PendingDefParam> defParams;
+    /* Position of the messages of the entry being elaborated: after the
+       subtrees of the nbCreated sub-instances it created so far */
+    std::vector<unsigned int> order;
+    unsigned int nbCreated;
+    /* First message of each position */
+    std::vector<std::pair<unsigned int, std::vector<unsigned int>>> marks;
+  };
+  /* What the elaboration of an instance adds below its parameters: the
+     sub-instances and the values it sets (genvars). Shared by the instances
+     of a same definition with the same resolved parameters, never modified
+     once recorded */
+  struct InstanceBody {
+    struct Child {
+      DesignComponent* def;
+      FileContent* fC;
+      NodeId nodeId;
+      std::string instName;
+      std::string modName;
+      /* Shared by the instances replaying the body */
+      ModuleInstance::ParamVector values;
+    };
+    std::vector<Child> children;
+    std::vector<std::pair<std::string, Value*>> scopeValues;
+    std::vector<std::pair<unsigned int, PendingInstance>> pending;
+  };
+
   bool bindDataTypes_() override;
   void bind_ports_nets_(std::vector<Signal*>& ports, 
                         std::vector<Signal*>& signals,
@@ -52,15 +118,70 @@ class DesignElaboration : public TestbenchElaboration {
   bool elaborateAllModules_(bool onlyTopLevel);
   void reportElaboration_();
   bool elaborateModule_(std::string moduleName, FileContent* fileContent,
-                        bool onlyTopLevel);
+                        bool onlyTopLevel,
+                        std::vector<PendingInstance>& instances);
+  void elaborateLevels_(std::vector<PendingInstance>& instances);
+  /* Commits the jobs of a level, returns in targets the instances of
+     earlier levels a defparam of the level sets */
+  void commitLevel_(std::vector<LevelContext>& contexts,
+                    std::vector<PendingInstance>& next,
+                    std::vector<ModuleInstance*>& targets);
+  /* Drops the subtrees of the targets and queues their entries again */
+  void reelaborate_(std::vector<ModuleInstance*>& targets,
+                    std::vector<PendingInstance>& instances,
+                    std::vector<PendingInstance>& next);
+  void beginEntry_(LevelContext& context, const PendingInstance& entry);
+  void addPending_(LevelContext& context, const PendingInstance& pending);
+  void markMessages_(LevelContext& context);
+  /* Emits the messages of the elaboration in depth first order */
+  void flushMessages_();
+  void deferInstances_(std::vector<PendingInstance>& instances);
+  bool isUnitInstance_(ModuleInstance* instance);
+  /* Lazy elaboration: finds the modules whose subtree can declare a
+     defparam, their instances are elaborated before any access */
+  void findDefParamModules_();
+  bool declaresDefParams_(DesignComponent* def);
+  /* Lazy elaboration: reduces and builds the netlists of the instances
+     elaborated before any access */
+  void completeEagerScopes_();
+  DesignComponent* getGenerateDefinition_(FileContent* fC, NodeId nodeId,
+                                          const std::string& fullName);
+  void markUsed_(UseClause& use);
   void checkElaboration_();
   void collectParams_(std::vector<std::string>& params, FileContent* fC,
                       NodeId nodeId, ModuleInstance* instance,
-                      NodeId parentParamOverride);
+                      NodeId parentParamOverride, LevelContext& context);
   void elaborateInstance_(FileContent* fC, NodeId nodeId,
                           NodeId parentParamOverride,
                           ModuleInstanceFactory* factory,
-                          ModuleInstance* parent, Config* config);
+                          ModuleInstance* parent, Config* config,
+                          LevelContext& context);
+  /* Applies the defparams to the collected parameters, then elaborates the
+     body */
+  void elaborateScope_(const std::vector<std::string>& params, FileContent* fC,
+                       NodeId nodeId, NodeId paramOverride,
+                       ModuleInstanceFactory* factory, ModuleInstance* parent,
+                       Config* config, LevelContext& context);
+  bool elaborateBody_(FileContent* fC, NodeId nodeId,
+                      ModuleInstanceFactory* factory, ModuleInstance* parent,
+                      Config* config, LevelContext& context);
+  /* Defparam trie node of the instance, resolved from its parent's */
+  DefParam* defParamScope_(ModuleInstance* instance);
+  /* Whether an instance array is kept as a range (lazy elaboration) */
+  bool compressArray_(ModuleInstance* parent, DesignComponent* def,
+                      VObjectType type, const std::string& instName);
+  /* Key of the shared body of an instance, empty if it cannot be shared */
+  std::string bodyKey_(FileContent* fC, NodeId nodeId, NodeId paramOverride,
+                       ModuleInstance* instance, Config* config);
+  /* Appends the types the instantiation passes as parameters, they are not
+     parameter values. Returns false if one cannot be keyed */
+  bool overrideKey_(std::string& key, ModuleInstance* instance,
+                    NodeId paramOverride);
+  bool replayBody_(const std::string& key, ModuleInstanceFactory* factory,
+                   ModuleInstance* instance, LevelContext& context);
+  void recordBody_(const std::string& key, ModuleInstance* instance,
+                   ModuleInstance::ParamVector& scope,
+                   LevelContext& context, unsigned int pendingStart);
   void recurseInstanceLoop_(std::vector<int>& from, std::vector<int>& to,
                             std::vector<int>& indexes, unsigned int pos,
                             DesignComponent* def, FileContent* fC,
@@ -68,10 +189,12 @@ class DesignElaboration : public TestbenchElaboration {
                             ModuleInstanceFactory* factory,
                             ModuleInstance* parent, Config* config,
                             std::string instanceName, std::string modName,
-                            std::vector<ModuleInstance*>& allSubInstances);
+                            std::vector<ModuleInstance*>& allSubInstances,
+                            LevelContext& context);
   void recurseBuildInstanceClause_(std::string parentPath, Config* config,
                                    std::set<Config*>& stack);
   void reduceUnnamedBlocks_();
+  void reduceUnnamedBlock_(ModuleInstance* current);
   void checkConfigurations_();
   Config* getInstConfig(std::string name);
   Config* getCellConfig(std::string name);
@@ -85,6 +208,23 @@ class DesignElaboration : public TestbenchElaboration {
   std::map<std::string, Config> m_cellConfig;
   std::map<std::string, UseClause> m_instUseClause;
   std::map<std::string, UseClause> m_cellUseClause;
+  std::vector<ExprBuilder*> m_exprBuilders;  // One per pool worker
+  FoldCache m_foldCache;  // Shared by the builders
+  std::map<std::string, DesignComponent*> m_generateDefinitions;
+  std::unordered_map<std::string, InstanceBody*> m_instanceBodies;
+  NetlistElaboration* m_netlistElaboration;
+  std::map<ModuleInstance*, std::vector<PendingInstance>> m_lazyInstances;
+  /* Modules declaring a defparam or instantiating one that does, by name
+     without library */
+  std::set<std::string> m_defParamModules;
+  /* Entries of the elaborated instances, an instance a later defparam sets
+     is elaborated again from them */
+  std::unordered_map<ModuleInstance*, std::vector<PendingInstance>>
+      m_elaborated;
+  /* Messages of the levels with their depth first position */
+  std::vector<std::pair<std::vector<unsigned int>, Error>> m_messages;
+  std::vector<InstanceArray*> m_lazyArrays;
+  std::mutex m_mutex;
 };
 
 };  // namespace SURELOG
@@ -46,6 +46,8 @@
 #include "Common/PortNetHolder.h"
 #include "Design/Netlist.h"
 #include <queue>
+#include <algorithm>
+#include "Utils/ThreadPool.h"
 
 #include "uhdm.h"
 #include "Serializer.h"
@@ -55,53 +57,127 @@ using namespace SURELOG;
 
 NetlistElaboration::NetlistElaboration(CompileDesign* compileDesign)
     : TestbenchElaboration(compileDesign) {
+  m_symbols = m_compileDesign->getCompiler()->getSymbolTable();
   m_exprBuilder.seterrorReporting(
       m_compileDesign->getCompiler()->getErrorContainer(),
       m_compileDesign->getCompiler()->getSymbolTable());
 }
 
 NetlistElaboration::~NetlistElaboration() {
+  for (ExprBuilder* exprBuilder : m_exprBuilders) delete exprBuilder;
 }
 
 
 bool NetlistElaboration::elaborate() {
   Design* design = m_compileDesign->getCompiler()->getDesign();
-  std::vector<ModuleInstance*>& topModules = design->getTopLevelModuleInstances();
-  for (ModuleInstance* inst : topModules) {
-    if (!elaborate_(inst)) 
-      return false;
+  std::vector<ModuleInstance*> instances = design->getTopLevelModuleInstances();
+  // An instance binds its ports in the netlist of its parent: the tree is
+  // elaborated one depth at a time, the instances of a level in parallel
+  while (!instances.empty()) {
+    elaborateLevel_(instances);
+    std::vector<ModuleInstance*> next;
+    for (ModuleInstance* instance : instances) {
+      for (unsigned int i = 0; i < instance->getNbChildren(); i++) {
+        next.push_back(instance->getChildren(i));
+      }
+    }
+    instances.swap(next);
+  }
+  return true;
+}
+
+void NetlistElaboration::elaborateLevel_(std::vector<ModuleInstance*>& instances) {
+  Compiler* compiler = m_compileDesign->getCompiler();
+  SymbolTable* symbols = compiler->getSymbolTable();
+  ThreadPool* pool = compiler->getThreadPool();
+  unsigned int nbWorkers = std::max(1u, pool->getNbThreads());
+  while (m_exprBuilders.size() < nbWorkers)
+    m_exprBuilders.push_back(new ExprBuilder());
+
+  unsigned int chunkSize = instances.size() / (nbWorkers * 4) + 1;
+  unsigned int nbChunks = (instances.size() + chunkSize - 1) / chunkSize;
+  std::vector<ErrorContainer*> errors(nbChunks);
+  std::vector<std::vector<PendingInterface>> pending(nbChunks);
+  for (unsigned int c = 0; c < nbChunks; c++) {
+    errors[c] = new ErrorContainer(symbols);
+    errors[c]->regiterCmdLine(compiler->getCommandLineParser());
+    pool->addJob([this, &instances, &errors, &pending, c, chunkSize,
+                  symbols](unsigned int workerIndex) {
+      ExprBuilder& exprBuilder = *m_exprBuilders[workerIndex];
+      exprBuilder.seterrorReporting(errors[c], symbols);
+      unsigned int end = std::min((c + 1) * chunkSize,
+                                  (unsigned int)instances.size());
+      for (unsigned int i = c * chunkSize; i < end; i++)
+        elaborateInstance_(instances[i], exprBuilder, pending[c]);
+    });
+  }
+  pool->wait();
+
+  // Committed in tree order
+  for (unsigned int c = 0; c < nbChunks; c++) {
+    compiler->getErrorContainer()->appendErrors(*errors[c]);
+    delete errors[c];
+    bindInterfaces_(pending[c], m_exprBuilder);
   }
+  for (ExprBuilder* exprBuilder : m_exprBuilders)
+    exprBuilder->seterrorReporting(compiler->getErrorContainer(), symbols);
+}
+
+bool NetlistElaboration::elaborateInstance(ModuleInstance* instance) {
+  std::vector<PendingInterface> pending;
+  elaborateInstance_(instance, m_exprBuilder, pending);
+  bindInterfaces_(pending, m_exprBuilder);
   return true;
 }
 
-bool NetlistElaboration::elaborate_(ModuleInstance* instance) {
+bool NetlistElaboration::elaborateInstance_(ModuleInstance* instance,
+                                            ExprBuilder& exprBuilder,
+                                            std::vector<PendingInterface>& pending) {
   Netlist* netlist = instance->getNetlist();
   if (netlist == nullptr) {
     netlist = new Netlist(instance);
     instance->setNetlist(netlist);
   }
-  elab_interfaces_(instance);
+  elab_interfaces_(instance, exprBuilder);
   VObjectType insttype = instance->getType();
   if (insttype != VObjectType::slInterface_instantiation) {
-    elab_ports_nets_(instance);
+    elab_ports_nets_(instance, exprBuilder);
   }
-  high_conn_(instance);
+  high_conn_(instance, exprBuilder, pending);
   // Let's not elaborate the logic for now
   //elab_cont_assigns_(instance);
   //elab_processes_(instance);
-  for (unsigned int i = 0; i < instance->getNbChildren(); i++) {
-     elaborate_(instance->getChildren(i));
-  }
   return true;
 }
 
-bool NetlistElaboration::high_conn_(ModuleInstance* instance) {
+void NetlistElaboration::bindInterfaces_(std::vector<PendingInterface>& pending,
+                                         ExprBuilder& exprBuilder) {
+  for (PendingInterface& binding : pending) {
+    ModuleInstance* instance = binding.instance;
+    interface* sm = elab_interface_(instance, binding.interfInstance,
+                                    binding.formalName, binding.interf->getName(),
+                                    binding.interf, instance->getFileName(),
+                                    instance->getLineNb(), exprBuilder);
+    m_compileDesign->lockSerializer();
+    binding.ref->Actual_group(sm);
+    m_compileDesign->unlockSerializer();
+  }
+  pending.clear();
+}
+
+SymbolId NetlistElaboration::nameId_(FileContent* fC, NodeId id) {
+  if (fC->getSymbolTable() == m_symbols) return fC->Name(id);
+  return m_symbols->registerSymbol(fC->SymName(id));
+}
+
+bool NetlistElaboration::high_conn_(ModuleInstance* instance,
+                                    ExprBuilder& exprBuilder,
+                                    std::vector<PendingInterface>& pending) {
   ModuleInstance* parent = instance->getParent();
   FileContent* fC = instance->getFileContent();
   NodeId Udp_instantiation = instance->getNodeId();
   Serializer& s = m_compileDesign->getSerializer();
   Netlist* netlist = instance->getNetlist();
-  std::string instName = instance->getFullPathName();
   VObjectType inst_type = fC->Type(Udp_instantiation);
   std::vector<UHDM::port*>* ports = netlist->ports();
   DesignComponent* comp = instance->getDefinition();
@@ -138,38 +214,36 @@ bool NetlistElaboration::high_conn_(ModuleInstance* instance) {
   n<> u<191> t<Udp_instantiation> p<192> c<178> l<20>
   */
     NodeId modId = fC->Child(Udp_instantiation);
-    const std::string& modName = fC->SymName(modId);
     NodeId Udp_instance = fC->Sibling(modId);
     if (fC->Type(Udp_instance) == VObjectType::slParameter_value_assignment) {
       Udp_instance = fC->Sibling(Udp_instance);
     }
     NodeId Name_of_instance = fC->Child(Udp_instance);
-    NodeId instId = fC->Child(Name_of_instance);
-    const std::string& instName = fC->SymName(instId);
     NodeId Net_lvalue = fC->Sibling(Name_of_instance);
     if (fC->Type(Net_lvalue) == VObjectType::slNet_lvalue) {
       unsigned int index = 0; 
       while (Net_lvalue) {
-        std::string sigName;
+        NodeId sigId = 0;
         if (fC->Type(Net_lvalue) == VObjectType::slNet_lvalue) {
           NodeId Ps_or_hierarchical_identifier = fC->Child(Net_lvalue);
-          NodeId sigId = fC->Child(Ps_or_hierarchical_identifier);
-          sigName = fC->SymName(sigId);
+          sigId = fC->Child(Ps_or_hierarchical_identifier);
         } else if (fC->Type(Net_lvalue) == VObjectType::slExpression) {
           NodeId Primary = fC->Child(Net_lvalue);
           NodeId Primary_literal = fC->Child(Primary);
-          NodeId sigId = fC->Child(Primary_literal);
-          sigName = fC->SymName(sigId);
+          sigId = fC->Child(Primary_literal);
         }
         if (ports) {
           if (index < ports->size()) {
+            const std::string& sigName = sigId ? fC->SymName(sigId) : "";
+            any* net = sigId ? bind_net_(parent, nameId_(fC, sigId)) : nullptr;
+            m_compileDesign->lockSerializer();
             port* p = (*ports)[index];
             p->VpiName(sigName);
             ref_obj* ref = s.MakeRef_obj();
             ref->VpiName(sigName);
             p->High_conn(ref);
-            any* net = bind_net_(parent, sigName);
             ref->Actual_group(net);
+            m_compileDesign->unlockSerializer();
           }
         }
         Net_lvalue = fC->Sibling(Net_lvalue);
@@ -212,7 +286,6 @@ bool NetlistElaboration::high_conn_(ModuleInstance* instance) {
           NodeId Primary_literal = fC->Child(Primary);
           formalId = fC->Child(Primary_literal);
         }
-        std::string formalName = fC->SymName(formalId);
         NodeId sigId = formalId;
         NodeId Expression =  fC->Sibling(formalId);
         if (Expression) {
@@ -220,25 +293,29 @@ bool NetlistElaboration::high_conn_(ModuleInstance* instance) {
           NodeId Primary_literal = fC->Child(Primary);
           sigId = fC->Child(Primary_literal);
         }
+        SymbolId sigNameId = nameId_(fC, sigId);
+        SymbolId selectNameId = 0;
         std::string sigName = fC->SymName(sigId);
-        std::string baseName = sigName;
-        std::string selectName;
         if (NodeId subId = fC->Sibling(sigId)) {
-          selectName = fC->SymName(subId);
-          sigName += std::string(".") + selectName;
+          selectNameId = nameId_(fC, subId);
+          sigName += std::string(".") + fC->SymName(subId);
         }
         
         if (ports) {
           if (index < ports->size()) {
+            SymbolId formalNameId = nameId_(fC, formalId);
             if (orderedConnection) {
-              formalName = ((*signals)[index])->getName();
+              Signal* formal = (*signals)[index];
+              formalNameId = nameId_(formal->getFileContent(), formal->getNodeId());
             }
+            const std::string& formalName = m_symbols->getSymbol(formalNameId);
+            any* net = bind_net_(parent, sigNameId, selectNameId);
+            m_compileDesign->lockSerializer();
             port* p = (*ports)[index];
             ref_obj* ref = s.MakeRef_obj();
             ref->VpiName(sigName);
             p->VpiName(formalName);
             p->High_conn(ref);
-            any* net = bind_net_(parent, sigName);
             ref->Actual_group(net);
             bool lowconn_is_nettype = false;
             if (const any* lc = p->Low_conn()) {
@@ -249,51 +326,58 @@ bool NetlistElaboration::high_conn_(ModuleInstance* instance) {
                   lowconn_is_nettype = true;
                }
             }
+            std::string portFile = p->VpiFile();
+            int portLine = p->VpiLineNo();
+            m_compileDesign->unlockSerializer();
             if (net && (net->UhdmType() == uhdmmodport) && (lowconn_is_nettype)) {
               Netlist* parentNetlist = parent->getNetlist();
               Netlist::ModPortMap::iterator itr;
               modport* mp = nullptr;
               if (orderedConnection) {
-                itr = netlist->getModPortMap().find(formalName);
+                itr = netlist->getModPortMap().find(Netlist::SymbolPath(formalNameId, 0));
                 if (itr != netlist->getModPortMap().end()) {
                   mp = (*itr).second.second;
                 }
               } else {
-                itr = parentNetlist->getModPortMap().find(sigName);
+                itr = parentNetlist->getModPortMap().find(Netlist::SymbolPath(sigNameId, selectNameId));
                 if (itr != parentNetlist->getModPortMap().end()) {
                   ModPort* orig_modport = (*itr).second.first;
                   ModuleDefinition* orig_interf = orig_modport->getParent();
-                  mp = elab_modport_(instance, formalName, orig_interf->getName(), orig_interf, 
-                          p->VpiFile(),p->VpiLineNo(), selectName);
+                  mp = elab_modport_(instance, formalNameId, orig_interf->getName(), orig_interf, 
+                          portFile, portLine, selectNameId, exprBuilder);
                 }
               }
               if (mp) {
+                m_compileDesign->lockSerializer();
                 ref_obj* ref = s.MakeRef_obj();         
                 ref->Actual_group(mp);
                 p->Low_conn(ref);
+                m_compileDesign->unlockSerializer();
               } 
             } else if (net && (net->UhdmType() == uhdminterface) && (lowconn_is_nettype)) {
-              BaseClass* sm = nullptr;
               if (orderedConnection) {
-                Netlist::InstanceMap::iterator itr = netlist->getInstanceMap().find(formalName);
+                Netlist::InstanceMap::iterator itr = netlist->getInstanceMap().find(formalNameId);
                 if (itr != netlist->getInstanceMap().end()) {
-                  sm = (*itr).second.second;
+                  BaseClass* sm = (*itr).second.second;
+                  m_compileDesign->lockSerializer();
+                  ref_obj* ref = s.MakeRef_obj();         
+                  ref->Actual_group(sm);
+                  p->Low_conn(ref);
+                  m_compileDesign->unlockSerializer();
                 }
               } else {
                 Netlist* parentNetlist = parent->getNetlist();
-                Netlist::InstanceMap::iterator itr = parentNetlist->getInstanceMap().find(sigName);
-                if (itr != parentNetlist->getInstanceMap().end()) {
+                Netlist::InstanceMap::iterator itr = parentNetlist->getInstanceMap().find(sigNameId);
+                if ((selectNameId == 0) && (itr != parentNetlist->getInstanceMap().end())) {
                   ModuleInstance* orig_instance = (*itr).second.first;
                   ModuleDefinition* orig_interf = (ModuleDefinition*) orig_instance->getDefinition();
-                  sm = elab_interface_(instance, orig_instance, formalName, orig_interf->getName(), orig_interf, 
-                        instance->getFileName(),instance->getLineNb());   
+                  m_compileDesign->lockSerializer();
+                  ref_obj* ref = s.MakeRef_obj();         
+                  p->Low_conn(ref);
+                  m_compileDesign->unlockSerializer();
+                  pending.push_back({instance, orig_instance, formalNameId, orig_interf, ref});
                 }
               }
-              if (sm) {
-                ref_obj* ref = s.MakeRef_obj();         
-                ref->Actual_group(sm);
-                p->Low_conn(ref);
-              } 
             } 
           }
         }
@@ -305,65 +389,84 @@ bool NetlistElaboration::high_conn_(ModuleInstance* instance) {
   return true;
 }
 
-interface* NetlistElaboration::elab_interface_(ModuleInstance* instance, ModuleInstance* interf_instance, const std::string& instName,  
+interface* NetlistElaboration::elab_interface_(ModuleInstance* instance, ModuleInstance* interf_instance, SymbolId instName,
                        const std::string& defName, ModuleDefinition* mod,
-                       const std::string& fileName, int lineNb) {
+                       const std::string& fileName, int lineNb, ExprBuilder& exprBuilder) {
   Netlist* netlist = instance->getNetlist();
   Serializer& s = m_compileDesign->getSerializer();
+  m_compileDesign->lockSerializer();
   VectorOfinterface* subInterfaces = netlist->interfaces();
   if (subInterfaces == nullptr) {
     subInterfaces = s.MakeInterfaceVec();
     netlist->interfaces(subInterfaces);
   }
   interface* sm = s.MakeInterface();
-  sm->VpiName(instName);
+  sm->VpiName(m_symbols->getSymbol(instName));
   sm->VpiDefName(defName);
   //sm->VpiFullName(??);
   sm->VpiFile(fileName);
   sm->VpiLineNo(lineNb);
   subInterfaces->push_back(sm);
+  m_compileDesign->unlockSerializer();
   netlist->getInstanceMap().insert(std::make_pair(instName, std::make_pair(interf_instance, sm)));
-  netlist->getSymbolTable().insert(std::make_pair(instName, sm));
-  std::string prefix = instName + ".";
-  elab_ports_nets_(instance, instance->getNetlist(), interf_instance->getNetlist(), mod, prefix);
+  netlist->getSymbolTable().insert(std::make_pair(Netlist::SymbolPath(instName, 0), sm));
+  elab_ports_nets_(instance, instance->getNetlist(), interf_instance->getNetlist(), mod, instName, exprBuilder);
 
   // Modports
   ModuleDefinition::ModPortSignalMap& orig_modports = mod->getModPortSignalMap();
+  m_compileDesign->lockSerializer();
   VectorOfmodport* dest_modports = s.MakeModportVec();
+  m_compileDesign->unlockSerializer();
   for (auto& orig_modport : orig_modports ) {
+    SymbolId modportName = m_symbols->registerSymbol(orig_modport.first);
+    m_compileDesign->lockSerializer();
     modport* dest_modport = s.MakeModport();
     dest_modport->Interface(sm);
-    std::string modportfullname = instName + "." + orig_modport.first  ;
+    dest_modport->VpiName(orig_modport.first);
+    m_compileDesign->unlockSerializer();
+    Netlist::SymbolPath modportfullname(instName, modportName);
     netlist->getModPortMap().insert(std::make_pair(modportfullname, std::make_pair(&orig_modport.second,dest_modport)));
     netlist->getSymbolTable().insert(std::make_pair(modportfullname, dest_modport));
-    dest_modport->VpiName(orig_modport.first);
-    VectorOfio_decl* ios = s.MakeIo_declVec();
+    // Member index of the modport
+    Netlist::MemberMap& members = netlist->addMembers(dest_modport);
+    std::vector<std::pair<io_decl*, any*>> ios;
     for (auto& sig : orig_modport.second.getPorts()) {
+      SymbolId sigName = nameId_(sig.getFileContent(), sig.getNodeId());
+      any* net = bind_net_(instance, sigName);
+      m_compileDesign->lockSerializer();
       io_decl* io = s.MakeIo_decl();
       io->VpiName(sig.getName());
       unsigned int direction = UhdmWriter::getVpiDirection(sig.getDirection());
       io->VpiDirection(direction);
-      any* net = bind_net_(instance, sig.getName());
       io->Expr(net);
-      ios->push_back(io);
+      m_compileDesign->unlockSerializer();
+      ios.push_back(std::make_pair(io, net));
+      members.insert(std::make_pair(sigName, (BaseClass*) net));
     }
-    dest_modport->Io_decls(ios);
+    m_compileDesign->lockSerializer();
+    VectorOfio_decl* dest_ios = s.MakeIo_declVec();
+    for (auto& io : ios) dest_ios->push_back(io.first);
+    dest_modport->Io_decls(dest_ios);
     dest_modports->push_back(dest_modport);
+    m_compileDesign->unlockSerializer();
   }
+  m_compileDesign->lockSerializer();
   sm->Modports(dest_modports);
+  m_compileDesign->unlockSerializer();
 
   return sm;
 }
 
 
-modport* NetlistElaboration::elab_modport_(ModuleInstance* instance, const std::string& instName,  
+modport* NetlistElaboration::elab_modport_(ModuleInstance* instance, SymbolId instName,
                        const std::string& defName, ModuleDefinition* mod,
-                       const std::string& fileName, int lineNb, const std::string& modPortName) {
+                       const std::string& fileName, int lineNb, SymbolId modPortName,
+                       ExprBuilder& exprBuilder) {
   Netlist* netlist = instance->getNetlist();
-  std::string fullname = instName + "." + modPortName;
+  Netlist::SymbolPath fullname(instName, modPortName);
   Netlist::ModPortMap::iterator itr = netlist->getModPortMap().find(fullname);
   if (itr == netlist->getModPortMap().end()) {
-    elab_interface_(instance, instance, instName, defName, mod, fileName, lineNb);
+    elab_interface_(instance, instance, instName, defName, mod, fileName, lineNb, exprBuilder);
   }
   itr = netlist->getModPortMap().find(fullname);
   if (itr != netlist->getModPortMap().end()) {
@@ -373,9 +476,10 @@ modport* NetlistElaboration::elab_modport_(ModuleInstance* instance, const std::
 }
 
 
-bool NetlistElaboration::elab_interfaces_(ModuleInstance* instance) {
-  for (unsigned int i = 0; i < instance->getNbChildren(); i++) {
-    ModuleInstance* child = instance->getChildren(i);
+bool NetlistElaboration::elab_interfaces_(ModuleInstance* instance, ExprBuilder& exprBuilder) {
+  // Interface arrays are never compressed
+  for (unsigned int i = 0; i < instance->getNbScalarChildren(); i++) {
+    ModuleInstance* child = instance->getScalarChildren(i);
     Netlist* netlist = child->getNetlist();
     if (netlist == nullptr) {
       netlist = new Netlist(child);
@@ -385,8 +489,8 @@ bool NetlistElaboration::elab_interfaces_(ModuleInstance* instance) {
     if (ModuleDefinition* mm = dynamic_cast<ModuleDefinition*> (childDef)) {
       VObjectType insttype = child->getType();
       if (insttype == VObjectType::slInterface_instantiation) {
-        elab_interface_(instance, child, child->getInstanceName(), child->getModuleName(), mm,
-                        child->getFileName(),child->getLineNb());
+        elab_interface_(instance, child, child->getInstanceId(m_symbols), child->getModuleName(), mm,
+                        child->getFileName(),child->getLineNb(), exprBuilder);
       }
     }
   }
@@ -394,17 +498,18 @@ bool NetlistElaboration::elab_interfaces_(ModuleInstance* instance) {
   return true;
 }
 
-bool NetlistElaboration::elab_ports_nets_(ModuleInstance* instance) {
+bool NetlistElaboration::elab_ports_nets_(ModuleInstance* instance, ExprBuilder& exprBuilder) {
   Netlist* netlist = instance->getNetlist();
   DesignComponent* comp = instance->getDefinition();
   if (comp == nullptr) {
     return true;
   }
-  return elab_ports_nets_(instance, netlist, netlist, comp, "");
+  return elab_ports_nets_(instance, netlist, netlist, comp, 0, exprBuilder);
 }
 
 
-bool NetlistElaboration::elab_ports_nets_(ModuleInstance* instance, Netlist* parentNetlist, Netlist* netlist, DesignComponent* comp, const std::string& prefix) {
+bool NetlistElaboration::elab_ports_nets_(ModuleInstance* instance, Netlist* parentNetlist, Netlist* netlist,
+                                          DesignComponent* comp, SymbolId prefix, ExprBuilder& exprBuilder) {
   Serializer& s = m_compileDesign->getSerializer();
   VObjectType compType = comp->getType();
   std::vector<net*>* nets = netlist->nets();
@@ -433,41 +538,54 @@ bool NetlistElaboration::elab_ports_nets_(ModuleInstance* instance, Netlist* par
       FileContent* fC = sig->getFileContent();
       NodeId id = sig->getNodeId();
       NodeId range = sig->getRange();
+      SymbolId signameId = nameId_(fC, id);
+      const std::string& signame = m_symbols->getSymbol(signameId);
       if (pass == 0) {
-        logic_net* logicn = s.MakeLogic_net();
-        std::string signame = sig->getName();
-        std::string parentSymbol = prefix + signame;
-        parentNetlist->getSymbolTable().insert(std::make_pair(parentSymbol, logicn));
-        netlist->getSymbolTable().insert(std::make_pair(signame, logicn));
-        logicn->VpiName(signame);
-        logicn->VpiLineNo(fC->Line(id));
-        logicn->VpiFile(fC->getFileName());
-        logicn->VpiNetType(UhdmWriter::getVpiNetType(sig->getType()));
+        bool hasRange = false;
+        std::string left;
+        std::string right;
         if (range) {
           VObjectType rangeType = fC->Type(range);
           if (rangeType == VObjectType::slPacked_dimension) {
             NodeId Constant_range = fC->Child(range);
             NodeId Constant_expression_left =  fC->Child(Constant_range);
             NodeId Constant_expression_right =  fC->Sibling(Constant_expression_left);
-            Value* leftV = m_exprBuilder.evalExpr(fC, Constant_expression_left, instance);
-            Value* rightV = m_exprBuilder.evalExpr(fC, Constant_expression_right, instance);
-            UHDM::constant* leftc = s.MakeConstant();
-            leftc->VpiValue(leftV->uhdmValue());
-            UHDM::constant* rightc = s.MakeConstant();
-            rightc->VpiValue(rightV->uhdmValue());
-            logicn->Left_expr(leftc);
-            logicn->Right_expr(rightc);
+            left = exprBuilder.evalView(fC, Constant_expression_left,
+                                        instance)->uhdmValue();
+            right = exprBuilder.evalView(fC, Constant_expression_right,
+                                         instance)->uhdmValue();
+            hasRange = true;
           }
         }
+        m_compileDesign->lockSerializer();
+        logic_net* logicn = s.MakeLogic_net();
+        logicn->VpiName(signame);
+        logicn->VpiLineNo(fC->Line(id));
+        logicn->VpiFile(fC->getFileName());
+        logicn->VpiNetType(UhdmWriter::getVpiNetType(sig->getType()));
+        if (hasRange) {
+          UHDM::constant* leftc = s.MakeConstant();
+          leftc->VpiValue(left);
+          UHDM::constant* rightc = s.MakeConstant();
+          rightc->VpiValue(right);
+          logicn->Left_expr(leftc);
+          logicn->Right_expr(rightc);
+        }
         if (nets == nullptr) {
           nets = s.MakeNetVec();
           netlist->nets(nets);
         } 
         nets->push_back(logicn);
+        m_compileDesign->unlockSerializer();
+        Netlist::SymbolPath parentSymbol = prefix ? Netlist::SymbolPath(prefix, signameId)
+                                                  : Netlist::SymbolPath(signameId, 0);
+        parentNetlist->getSymbolTable().insert(std::make_pair(parentSymbol, logicn));
+        netlist->getSymbolTable().insert(std::make_pair(Netlist::SymbolPath(signameId, 0), logicn));
       } else { 
+        any* n = bind_net_(netlist->getParent(), signameId);
+        m_compileDesign->lockSerializer();
         port* dest_port = s.MakePort();
         dest_port->VpiDirection(UhdmWriter::getVpiDirection(sig->getDirection())); 
-        std::string signame = sig->getName();
         dest_port->VpiName(signame);
         dest_port->VpiLineNo(fC->Line(id));
         dest_port->VpiFile(fC->getFileName());
@@ -477,39 +595,52 @@ bool NetlistElaboration::elab_ports_nets_(ModuleInstance* instance, Netlist* par
         } 
         ports->push_back(dest_port);
 
-        if (any* n = bind_net_(netlist->getParent(), signame)) {
+        if (n) {
           ref_obj* ref = s.MakeRef_obj();          
           ref->Actual_group(n);
           dest_port->Low_conn(ref);
         }
+        m_compileDesign->unlockSerializer();
 
         if (ModPort* orig_modport = sig->getModPort()) {
+          m_compileDesign->lockSerializer();
           ref_obj* ref = s.MakeRef_obj();
           dest_port->Low_conn(ref);
-          Netlist::ModPortMap::iterator itr = netlist->getModPortMap().find(signame);
+          m_compileDesign->unlockSerializer();
+          Netlist::ModPortMap::iterator itr = netlist->getModPortMap().find(Netlist::SymbolPath(signameId, 0));
+          modport* mp = nullptr;
           if (itr == netlist->getModPortMap().end()) {
             ModuleDefinition* orig_interf = orig_modport->getParent();
-            modport* mp =  elab_modport_(instance, signame, orig_interf->getName(), orig_interf, 
-                        instance->getFileName(),instance->getLineNb(), orig_modport->getName());
-            ref->Actual_group(mp);            
+            mp =  elab_modport_(instance, signameId, orig_interf->getName(), orig_interf, 
+                        instance->getFileName(),instance->getLineNb(),
+                        m_symbols->registerSymbol(orig_modport->getName()), exprBuilder);
           } else {
-           ref->Actual_group((*itr).second.second); 
+            mp = (*itr).second.second;
           }
+          m_compileDesign->lockSerializer();
+          ref->Actual_group(mp);
+          m_compileDesign->unlockSerializer();
         } else if (ModuleDefinition* orig_interf = sig->getInterfaceDef()) {
+          m_compileDesign->lockSerializer();
           ref_obj* ref = s.MakeRef_obj();
           dest_port->Low_conn(ref);
-          Netlist::InstanceMap::iterator itr = netlist->getInstanceMap().find(signame);
+          m_compileDesign->unlockSerializer();
+          Netlist::InstanceMap::iterator itr = netlist->getInstanceMap().find(signameId);
+          BaseClass* sm = nullptr;
           if (itr == netlist->getInstanceMap().end()) {
             ModuleInstance* interfaceInstance = new ModuleInstance(orig_interf, sig->getFileContent(),
-                 sig->getNodeId(), instance, signame, orig_interf->getName());
+                 sig->getNodeId(), instance, signame, orig_interf->getName(),
+                 m_symbols);
             Netlist* netlist = new Netlist(interfaceInstance);
             interfaceInstance->setNetlist(netlist);
-            interface* sm =  elab_interface_(instance, interfaceInstance, signame, orig_interf->getName(), orig_interf, 
-                        instance->getFileName(),instance->getLineNb());
-            ref->Actual_group(sm);
+            sm =  elab_interface_(instance, interfaceInstance, signameId, orig_interf->getName(), orig_interf, 
+                        instance->getFileName(),instance->getLineNb(), exprBuilder);
           } else {
-            ref->Actual_group((*itr).second.second);
+            sm = (*itr).second.second;
           }
+          m_compileDesign->lockSerializer();
+          ref->Actual_group(sm);
+          m_compileDesign->unlockSerializer();
         }
       }
     }
@@ -518,67 +649,96 @@ bool NetlistElaboration::elab_ports_nets_(ModuleInstance* instance, Netlist* par
 }
 
 any* NetlistElaboration::bind_net_(ModuleInstance* instance, const std::string& name) {
-  any* result = nullptr;
+  std::string basename = name;
+  std::string subname;
+  if (strstr(basename.c_str(),".")) {
+    subname = basename;
+    StringUtils::ltrim(subname,'.');
+    StringUtils::rtrim(basename,'.');
+  }
+  SymbolId baseId = m_symbols->getId(basename);
+  if (baseId == m_symbols->getBadId()) return nullptr;
+  SymbolId subId = 0;
+  if (!subname.empty()) {
+    subId = m_symbols->getId(subname);
+    if (subId == m_symbols->getBadId()) return nullptr;
+  }
+  return bind_net_(instance, baseId, subId);
+}
+
+any* NetlistElaboration::bind_net_(ModuleInstance* instance, SymbolId name, SymbolId member) {
   Netlist* netlist = instance->getNetlist();
-  if (netlist) {
-    Netlist::SymbolTable& symbols = netlist->getSymbolTable();
-    Netlist::SymbolTable::iterator itr = symbols.find(name);
-    if (itr != symbols.end()) {
-      return (*itr).second;
-    } else {
-      std::string basename = name;
-      std::string subname;
-      if (strstr(basename.c_str(),".")) {
-        subname = basename;
-        StringUtils::ltrim(subname,'.');
-        StringUtils::rtrim(basename,'.');
-      }
-      itr = symbols.find(basename);
-      if (itr != symbols.end()) {
-        BaseClass* baseclass = (*itr).second;
-        port* conn = dynamic_cast<port*> (baseclass);
-        ref_obj* ref1 = nullptr;
-        const interface* interf = nullptr;
-        if (conn) {
-          ref1 = dynamic_cast<ref_obj*> ((BaseClass*) conn->Low_conn());
-        }
-        if (ref1) {
-          interf = dynamic_cast<interface*> ((BaseClass*) ref1->Actual_group());
-        }
-        if (interf == nullptr) {
-          interf = dynamic_cast<interface*> (baseclass);
-        }
-        if ((interf == nullptr) && ref1) {
-          modport* mport = dynamic_cast<modport*> ((BaseClass*) ref1->Actual_group());
-          if (mport) {
-            interf = mport->Interface();
-          }
+  if (netlist == nullptr) {
+    return nullptr;
+  }
+  Netlist::SymbolTable& symbols = netlist->getSymbolTable();
+  Netlist::SymbolTable::iterator itr = symbols.find(Netlist::SymbolPath(name, member));
+  if (itr != symbols.end()) {
+    return (any*) (*itr).second;
+  }
+  if (member == 0) {
+    return nullptr;
+  }
+  itr = symbols.find(Netlist::SymbolPath(name, 0));
+  if (itr == symbols.end()) {
+    return nullptr;
+  }
+  BaseClass* baseclass = (*itr).second;
+  port* conn = dynamic_cast<port*> (baseclass);
+  ref_obj* ref1 = nullptr;
+  const interface* interf = nullptr;
+  if (conn) {
+    ref1 = dynamic_cast<ref_obj*> ((BaseClass*) conn->Low_conn());
+  }
+  if (ref1) {
+    interf = dynamic_cast<interface*> ((BaseClass*) ref1->Actual_group());
+  }
+  if (interf == nullptr) {
+    interf = dynamic_cast<interface*> (baseclass);
+  }
+  if ((interf == nullptr) && ref1) {
+    modport* mport = dynamic_cast<modport*> ((BaseClass*) ref1->Actual_group());
+    if (mport) {
+      interf = mport->Interface();
+    }
+  }
+  const BaseClass* object = interf;
+  if (object == nullptr) {
+    object = dynamic_cast<modport*> (baseclass);
+  }
+  if (object == nullptr) {
+    return nullptr;
+  }
+  if (Netlist::MemberMap* members = netlist->getMembers(object)) {
+    Netlist::MemberMap::iterator mitr = members->find(member);
+    return (mitr == members->end()) ? nullptr : (any*) (*mitr).second;
+  }
+  // Objects without an index (elaborated in another netlist)
+  const std::string& subname = m_symbols->getSymbol(member);
+  any* result = nullptr;
+  m_compileDesign->lockSerializer();
+  if (interf) {
+    VectorOfnet* nets = interf->Nets();
+    if (nets) {
+      for (net* p : *nets) {
+        if (p->VpiName() == subname) {
+          result = p;
+          break;
         }
-        if (interf) {
-          VectorOfnet* nets = interf->Nets();
-          if (nets) {
-            for (net* p : *nets) {
-              if (p->VpiName() == subname) {
-               return p;
-              }
-            }
-          }   
-        } else {
-          modport* mport = dynamic_cast<modport*> (baseclass);
-          if (mport) {
-            VectorOfio_decl* ios = mport->Io_decls();
-            if (ios) {
-              for (io_decl* decl : *ios) {
-                if (decl->VpiName() == subname) {
-                  return (any*) decl->Expr();
-                }
-              }
-            }
-          }
+      }
+    }   
+  } else {
+    VectorOfio_decl* ios = ((modport*) object)->Io_decls();
+    if (ios) {
+      for (io_decl* decl : *ios) {
+        if (decl->VpiName() == subname) {
+          result = (any*) decl->Expr();
+          break;
         }
       }
     }
   }
+  m_compileDesign->unlockSerializer();
   return result;
 }
 
@@ -38,30 +38,53 @@ class NetlistElaboration : public TestbenchElaboration {
   NetlistElaboration(CompileDesign* compileDesign);
   NetlistElaboration(const NetlistElaboration& orig) = delete;
   bool elaborate() override;
+  /* Elaborates the netlist of one instance, not of its sub-instances */
+  bool elaborateInstance(ModuleInstance* instance);
   
   virtual ~NetlistElaboration() override;
 
  private:
-   bool elaborate_(ModuleInstance* instance);
-   bool high_conn_(ModuleInstance* instance);
-   bool elab_interfaces_(ModuleInstance* instance);
-   interface* elab_interface_(ModuleInstance* instance, ModuleInstance* interf_instance, const std::string& instName,  
+   /* A port bound to an interface instance of the parent: the netlist of
+      that interface is shared by the instances connected to it, so the
+      binding is done after the level, in tree order */
+   struct PendingInterface {
+     ModuleInstance* instance;
+     ModuleInstance* interfInstance;
+     SymbolId formalName;
+     ModuleDefinition* interf;
+     ref_obj* ref;
+   };
+   void elaborateLevel_(std::vector<ModuleInstance*>& instances);
+   bool elaborateInstance_(ModuleInstance* instance, ExprBuilder& exprBuilder,
+                           std::vector<PendingInterface>& pending);
+   void bindInterfaces_(std::vector<PendingInterface>& pending,
+                        ExprBuilder& exprBuilder);
+   SymbolId nameId_(FileContent* fC, NodeId id);
+   bool high_conn_(ModuleInstance* instance, ExprBuilder& exprBuilder,
+                   std::vector<PendingInterface>& pending);
+   bool elab_interfaces_(ModuleInstance* instance, ExprBuilder& exprBuilder);
+   interface* elab_interface_(ModuleInstance* instance, ModuleInstance* interf_instance, SymbolId instName,
                        const std::string& defName, ModuleDefinition* mod, 
-                       const std::string& fileName, int lineNb);
-   modport* elab_modport_(ModuleInstance* instance, const std::string& instName,  
+                       const std::string& fileName, int lineNb, ExprBuilder& exprBuilder);
+   modport* elab_modport_(ModuleInstance* instance, SymbolId instName,
                        const std::string& defName, ModuleDefinition* mod,
-                       const std::string& fileName, int lineNb, const std::string& modPortName);                    
-   bool elab_ports_nets_(ModuleInstance* instance);
+                       const std::string& fileName, int lineNb, SymbolId modPortName,
+                       ExprBuilder& exprBuilder);
+   bool elab_ports_nets_(ModuleInstance* instance, ExprBuilder& exprBuilder);
    bool elab_ports_nets_(ModuleInstance* instance, Netlist* parentNetlist, Netlist* netlist,
-                         DesignComponent* comp, const std::string& prefix);
+                         DesignComponent* comp, SymbolId prefix, ExprBuilder& exprBuilder);
    bool elab_processes_(ModuleInstance* instance);
    bool elab_cont_assigns_(ModuleInstance* instance);
    initial* elab_initial_(ModuleInstance* instance, initial* init);
    assignment* elab_assignment_(ModuleInstance* instance, assignment* assign);
+   /* Binds "name" or "name.member" */
+   any* bind_net_(ModuleInstance* instance, SymbolId name, SymbolId member = 0);
    any* bind_net_(ModuleInstance* instance, const std::string& name);
    expr* bind_expr_(ModuleInstance* instance, expr* ep);
 
    ExprBuilder m_exprBuilder;
+   std::vector<ExprBuilder*> m_exprBuilders;
+   SymbolTable* m_symbols;
 };
 
 };  // namespace SURELOG
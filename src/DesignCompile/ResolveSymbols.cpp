@@ -60,7 +60,7 @@ int FunctorResolve::operator()() const {
   return true;
 }
 
-std::string ResolveSymbols::SymName(NodeId index) {
+const std::string& ResolveSymbols::SymName(NodeId index) {
   return m_fileData->getSymbolTable()->getSymbol(Name(index));
 }
 
@@ -168,7 +168,7 @@ void ResolveSymbols::createFastLookup() {
                 m_fileData->sl_collect(subobject, VObjectType::slStringConst,
                                        VObjectType::slAttr_spec);
             if (stId != InvalidNodeId) {
-              std::string name = SymName(stId);
+              const std::string& name = SymName(stId);
               std::string fullSubName = fullName + "::" + name;
               m_fileData->insertObjectLookup(fullSubName, subobject,
                                              m_errorContainer);
@@ -246,7 +246,7 @@ unsigned int ResolveSymbols::Line(NodeId index) {
   return Object(index).m_line;
 }
 
-std::string ResolveSymbols::Symbol(SymbolId id) {
+const std::string& ResolveSymbols::Symbol(SymbolId id) {
   return m_fileData->getSymbolTable()->getSymbol(id);
 }
 
@@ -302,16 +302,16 @@ bool ResolveSymbols::bindDefinition_(unsigned int objIndex,
         m_fileData->SetDefinitionFile(objIndex, fileId);
         switch (actualType) {
           case VObjectType::slUdp_declaration:
-            Type(objIndex) = VObjectType::slUdp_instantiation;
+            m_fileData->setType(objIndex, VObjectType::slUdp_instantiation);
             break;
           case VObjectType::slModule_declaration:
-            Type(objIndex) = VObjectType::slModule_instantiation;
+            m_fileData->setType(objIndex, VObjectType::slModule_instantiation);
             break;
           case VObjectType::slInterface_declaration:
-            Type(objIndex) = VObjectType::slInterface_instantiation;
+            m_fileData->setType(objIndex, VObjectType::slInterface_instantiation);
             break;
           case VObjectType::slProgram_declaration:
-            Type(objIndex) = VObjectType::slProgram_instantiation;
+            m_fileData->setType(objIndex, VObjectType::slProgram_instantiation);
             break;
           default:
             break;
@@ -362,6 +362,5 @@ bool ResolveSymbols::resolve() {
       */
     }
   }
-
   return true;
 }
@@ -94,9 +94,9 @@ class ResolveSymbols : public CompileStep {
 
   unsigned int Line(NodeId index) override;
 
-  std::string Symbol(SymbolId id) override;
+  const std::string& Symbol(SymbolId id) override;
 
-  std::string SymName(NodeId index) override;
+  const std::string& SymName(NodeId index) override;
 
   NodeId sl_get(NodeId parent, VObjectType type) override;  // Get first item of type
 
@@ -479,13 +479,14 @@ void writeInstance(ModuleDefinition* mod, ModuleInstance* instance, module* m,
         ModPortMap& modPortMap,
         InstanceMap& instanceMap) {
   VectorOfmodule* subModules = nullptr; 
+  VectorOfmodule_array* subModuleArrays = nullptr;
   VectorOfprogram* subPrograms = nullptr;
   VectorOfinterface* subInterfaces = nullptr;
   writeElabModule(instance, m);
  
   // Parameters
-  for (auto& param : instance->getMappedValues()) {
-    const std::string& name = param.first;
+  for (auto& param : instance->getParamValues()) {
+    const std::string& name = *param.first;
     Value* val = param.second;
     VectorOfparameters* params = m->Parameters();
     if (params == nullptr) {
@@ -498,8 +499,8 @@ void writeInstance(ModuleDefinition* mod, ModuleInstance* instance, module* m,
     m->Parameters(params);
   }
 
-  for (unsigned int i = 0; i < instance->getNbChildren(); i++) {
-    ModuleInstance* child = instance->getChildren(i);
+  for (unsigned int i = 0; i < instance->getNbScalarChildren(); i++) {
+    ModuleInstance* child = instance->getScalarChildren(i);
     DesignComponent* childDef = child->getDefinition();
     if (ModuleDefinition* mm = dynamic_cast<ModuleDefinition*> (childDef)) {
       VObjectType insttype = child->getType();
@@ -554,6 +555,41 @@ void writeInstance(ModuleDefinition* mod, ModuleInstance* instance, module* m,
       writeElabProgram(child, sm);     
     }
   }
+
+  // Instance arrays are written as such, with the elements accessed so far
+  for (unsigned int i = 0; i < instance->getNbInstanceArrays(); i++) {
+    InstanceArray* array = instance->getInstanceArray(i);
+    ModuleDefinition* mm =
+        dynamic_cast<ModuleDefinition*>(array->getDefinition());
+    if (mm == nullptr) continue;
+    if (subModuleArrays == nullptr)
+      subModuleArrays = s.MakeModule_arrayVec();
+    module_array* sa = s.MakeModule_array();
+    sa->VpiName(array->getInstanceName());
+    sa->VpiFullName(array->getFullPathName());
+    sa->VpiSize(array->getSize());
+    sa->VpiFile(array->getFileContent()->getFileName(array->getNodeId()));
+    sa->VpiLineNo(array->getFileContent()->Line(array->getNodeId()));
+    VectorOfmodule* elements = nullptr;
+    for (auto& element : array->getElaboratedElements()) {
+      ModuleInstance* child = element.second;
+      if (elements == nullptr)
+        elements = s.MakeModuleVec();
+      module* sm = s.MakeModule();
+      sm->VpiName(child->getInstanceName());
+      sm->VpiDefName(child->getModuleName());
+      sm->VpiFullName(child->getFullPathName());
+      sm->VpiFile(child->getFileName());
+      sm->VpiLineNo(child->getLineNb());
+      elements->push_back(sm);
+      sm->Instance(m);
+      sm->Module(m);
+      writeInstance(mm, child, sm, s, componentMap, modPortMap,instanceMap);
+    }
+    if (elements) sa->Modules(elements);
+    subModuleArrays->push_back(sa);
+    m->Module_arrays(subModuleArrays);
+  }
 }
 
 bool UhdmWriter::write(std::string uhdmFile) {
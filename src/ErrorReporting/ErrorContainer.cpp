@@ -109,15 +109,18 @@ Error& ErrorContainer::addError(Error& error, bool showDuplicates,
 void ErrorContainer::appendErrors(ErrorContainer& rhs) {
   for (unsigned int i = 0; i < rhs.m_errors.size(); i++) {
     Error err = rhs.m_errors[i];
-    // Translate IDs to master symbol table
-    for (unsigned int locItr = 0; locItr < err.m_locations.size(); locItr++) {
-      Location& loc = err.m_locations[locItr];
-      if (loc.m_fileId)
-        loc.m_fileId = m_symbolTable->registerSymbol(
-            rhs.m_symbolTable->getSymbol(loc.m_fileId));
-      if (loc.m_object) {
-        loc.m_object = m_symbolTable->registerSymbol(
-            rhs.m_symbolTable->getSymbol(loc.m_object));
+    // Translate IDs to master symbol table, unless the table is shared
+    if (rhs.m_symbolTable != m_symbolTable) {
+      for (unsigned int locItr = 0; locItr < err.m_locations.size();
+           locItr++) {
+        Location& loc = err.m_locations[locItr];
+        if (loc.m_fileId)
+          loc.m_fileId = m_symbolTable->registerSymbol(
+              rhs.m_symbolTable->getSymbol(loc.m_fileId));
+        if (loc.m_object) {
+          loc.m_object = m_symbolTable->registerSymbol(
+              rhs.m_symbolTable->getSymbol(loc.m_object));
+        }
       }
     }
     if (!err.m_reported) addError(err);
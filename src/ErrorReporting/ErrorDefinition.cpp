@@ -187,6 +187,11 @@ bool ErrorDefinition::init() {
   rec(CMD_SPLIT_FILE_MISSING_SIZE, FATAL, CMD, "Missing file splitting size");
   rec(CMD_UNDEFINED_CONFIG, ERROR, CMD, "Undefined configuration: \"%s\"");
   rec(CMD_USING_GLOBAL_TIMESCALE, INFO, CMD, "Using global timescale: \"%s\"");
+  rec(CMD_PREFETCH_MISSING_SIZE, ERROR, CMD,
+      "Option -prefetch is missing the number of files <nb>, at least 1");
+  rec(CMD_PRECOMPILED_MISSING_PACKAGE, ERROR, CMD,
+      "Precompiled package declaration \"%s\" is missing the package or "
+      "file name");
   rec(PP_CANNOT_OPEN_FILE, ERROR, PP, "Cannot open file \"%s\"");
   rec(PP_CANNOT_OPEN_INCLUDE_FILE, ERROR, PP,
       "Cannot open include file \"%s\"");
@@ -249,6 +254,10 @@ bool ErrorDefinition::init() {
   rec(PA_SYNTAX_ERROR, SYNTAX, PARSE, "Syntax error: %s", "%exobj");
   rec(PA_RESERVED_KEYWORD, ERROR, PARSE, "Reserved keyword: %s");
   rec(PA_UNSUPPORTED_KEYWORD_LIST, ERROR, PARSE, "Unsupported keyword set: %s");
+  rec(PA_TOO_MANY_FILES, ERROR, PARSE,
+      "More than 65536 files contribute to \"%s\"");
+  rec(PA_TOO_MANY_SYMBOLS, ERROR, PARSE,
+      "More than 2^32 symbols, nodes of \"%s\" lose their names");
   rec(COMP_COMPILE, INFO, COMP, "Compilation..");
   rec(COMP_COMPILE_PACKAGE, INFO, COMP, "Compile package \"%s\"");
   rec(COMP_COMPILE_CLASS, INFO, COMP, "Compile class \"%s\"");
@@ -354,6 +363,8 @@ bool ErrorDefinition::init() {
       "Undefined imported package: \"%s\"");
   rec(ELAB_OUT_OF_RANGE_PARAM_INDEX, ERROR, ELAB,
       "Out of range parameter index: \"%s\"");
+  rec(ELAB_UNDEFINED_INSTANCE_PATH, WARNING, ELAB,
+      "Elaboration path does not match any instance: \"%s\"");
   rec(LIB_FILE_MAPS_TO_MULTIPLE_LIBS, ERROR, LIB,
       "File \"%exobj\" maps to multiple libraries: \"%s\"");
   return true;
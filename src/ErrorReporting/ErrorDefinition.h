@@ -76,6 +76,8 @@ class ErrorDefinition {
     CMD_SPLIT_FILE_MISSING_SIZE = 27,
     CMD_UNDEFINED_CONFIG = 28,
     CMD_USING_GLOBAL_TIMESCALE = 29,
+    CMD_PREFETCH_MISSING_SIZE = 30,
+    CMD_PRECOMPILED_MISSING_PACKAGE = 31,
     PP_CANNOT_OPEN_FILE = 100,
     PP_CANNOT_OPEN_INCLUDE_FILE = 101,
     PP_UNKOWN_MACRO = 102,
@@ -113,6 +115,8 @@ class ErrorDefinition {
     PA_SYNTAX_ERROR = 207,
     PA_RESERVED_KEYWORD = 208,
     PA_UNSUPPORTED_KEYWORD_LIST = 209,
+    PA_TOO_MANY_FILES = 210,
+    PA_TOO_MANY_SYMBOLS = 211,
     COMP_COMPILE = 300,
     COMP_COMPILE_PACKAGE = 301,
     COMP_COMPILE_CLASS = 302,
@@ -180,6 +184,7 @@ class ErrorDefinition {
     ELAB_ELABORATING_TESTBENCH = 527,
     ELAB_UNDEFINED_PACKAGE = 528,
     ELAB_OUT_OF_RANGE_PARAM_INDEX = 530,
+    ELAB_UNDEFINED_INSTANCE_PATH = 531,
     LIB_FILE_MAPS_TO_MULTIPLE_LIBS = 600,
   };
 
@@ -28,6 +28,7 @@
 #include <math.h>
 #include "ErrorReporting/ErrorContainer.h"
 #include "Expression/ExprBuilder.h"
+#include "Expression/FoldCache.h"
 #include "SourceCompile/VObjectTypes.h"
 
 using namespace SURELOG;
@@ -35,9 +36,10 @@ using namespace SURELOG;
 ExprBuilder::ExprBuilder() {
   m_symbols = NULL;
   m_errors = NULL;
+  m_foldCache = NULL;
 }
 
-ExprBuilder::ExprBuilder(const ExprBuilder& orig) {}
+ExprBuilder::ExprBuilder(const ExprBuilder& orig) { m_foldCache = NULL; }
 
 ExprBuilder::~ExprBuilder() {}
 
@@ -56,256 +58,142 @@ Value* ExprBuilder::clone(Value* val) {
 
 Value* ExprBuilder::evalExpr(FileContent* fC, NodeId parent,
                              ValuedComponentI* instance, bool muteErrors) {
-  Value* value = m_valueFactory.newLValue();
+  return clone(evalView(fC, parent, instance, muteErrors));
+}
+
+Value* ExprBuilder::evalView(FileContent* fC, NodeId parent,
+                             ValuedComponentI* instance, bool muteErrors) {
+  Plan& plan = getPlan_(fC, parent);
+  // Unresolved parameters are reported by run_, they are not memoized
+  if (!resolve_(fC, plan, instance) || m_foldCache == NULL ||
+      plan.m_nbReads == 0)
+    return run_(fC, plan, muteErrors);
+  foldKey_(fC, parent);
+  if (m_foldCache->find(m_foldKey, m_result)) return &m_result;
+  Value* result = run_(fC, plan, muteErrors);
+  if (result->isLValue()) m_foldCache->insert(m_foldKey, *(LValue*)result);
+  return result;
+}
+
+bool ExprBuilder::resolve_(FileContent* fC, Plan& plan,
+                           ValuedComponentI* instance) {
+  m_reads.clear();
+  bool resolved = true;
+  for (const Instr& instr : plan.m_instrs) {
+    if (instr.m_op != Op::Load && instr.m_op != Op::LoadIncDec) continue;
+    Value* sval = NULL;
+    if (instance) sval = instance->getValue(fC->SymName(instr.m_node));
+    if (sval == NULL) resolved = false;
+    m_reads.push_back(sval);
+  }
+  return resolved;
+}
+
+void ExprBuilder::foldKey_(FileContent* fC, NodeId id) {
+  std::string& key = m_foldKey;
+  key.clear();
+  key.append((const char*)&fC, sizeof(fC));
+  key.append((const char*)&id, sizeof(id));
+  for (Value* read : m_reads) FoldCache::appendValueKey(key, read);
+}
+
+ExprBuilder::Plan& ExprBuilder::getPlan_(FileContent* fC, NodeId id) {
+  PlanMap& plans = m_plans[fC];
+  PlanMap::iterator itr = plans.find(id);
+  if (itr != plans.end()) return (*itr).second;
+  Plan& plan = plans[id];
+  compile_(fC, id, plan);
+  plan.m_nbReads = 0;
+  for (const Instr& instr : plan.m_instrs) {
+    if (instr.m_op == Op::Load || instr.m_op == Op::LoadIncDec)
+      plan.m_nbReads++;
+  }
+  return plan;
+}
+
+void ExprBuilder::emit_(Plan& plan, Op op, NodeId node) {
+  Instr instr;
+  instr.m_op = op;
+  instr.m_node = node;
+  instr.m_unsigned = 0;
+  plan.m_instrs.push_back(instr);
+}
+
+void ExprBuilder::compile_(FileContent* fC, NodeId parent, Plan& plan) {
   NodeId child = fC->Child(parent);
   if (child) {
     VObjectType childType = fC->Type(child);
     switch (childType) {
-      case VObjectType::slIncDec_PlusPlus:  {
-        // Pre increment
-        NodeId sibling = fC->Sibling(child);
-        Value* tmp = evalExpr(fC, sibling, instance, muteErrors);
-        value->u_plus(tmp);
-        value->incr();
-        m_valueFactory.deleteValue(tmp);
+      case VObjectType::slIncDec_PlusPlus:
+        compile_(fC, fC->Sibling(child), plan);
+        emit_(plan, Op::PreIncr);
         break;
-      }
-      case VObjectType::slIncDec_MinusMinus:  {
-        // Pre decrement
-        NodeId sibling = fC->Sibling(child);
-        Value* tmp = evalExpr(fC, sibling, instance, muteErrors);
-        value->u_plus(tmp);
-        value->decr();
-        m_valueFactory.deleteValue(tmp);
+      case VObjectType::slIncDec_MinusMinus:
+        compile_(fC, fC->Sibling(child), plan);
+        emit_(plan, Op::PreDecr);
         break;
-      }
-      case VObjectType::slUnary_Minus: {
-        NodeId sibling = fC->Sibling(child);
-        Value* tmp = evalExpr(fC, sibling, instance, muteErrors);
-        value->u_minus(tmp);
-        m_valueFactory.deleteValue(tmp);
+      case VObjectType::slUnary_Minus:
+        compile_(fC, fC->Sibling(child), plan);
+        emit_(plan, Op::UMinus);
         break;
-      }
-      case VObjectType::slUnary_Plus: {
-        NodeId sibling = fC->Sibling(child);
-        Value* tmp = evalExpr(fC, sibling, instance, muteErrors);
-        value->u_plus(tmp);
-        m_valueFactory.deleteValue(tmp);
+      case VObjectType::slUnary_Plus:
+        compile_(fC, fC->Sibling(child), plan);
+        emit_(plan, Op::UPlus);
         break;
-      }
-      case VObjectType::slUnary_Not: {
-        NodeId sibling = fC->Sibling(child);
-        Value* tmp = evalExpr(fC, sibling, instance, muteErrors);
-        value->u_not(tmp);
-        m_valueFactory.deleteValue(tmp);
+      case VObjectType::slUnary_Not:
+        compile_(fC, fC->Sibling(child), plan);
+        emit_(plan, Op::UNot);
         break;
-      }
-      case VObjectType::slUnary_Tilda: {
-        NodeId sibling = fC->Sibling(child);
-        Value* tmp = evalExpr(fC, sibling, instance, muteErrors);
-        value->u_tilda(tmp);
-        m_valueFactory.deleteValue(tmp);
+      case VObjectType::slUnary_Tilda:
+        compile_(fC, fC->Sibling(child), plan);
+        emit_(plan, Op::UTilda);
         break;
-      }
       case VObjectType::slConstant_primary:
-        m_valueFactory.deleteValue(value);
-        value = evalExpr(fC, child, instance, muteErrors);
-        break;
       case VObjectType::slPrimary_literal:
-        m_valueFactory.deleteValue(value);
-        value = evalExpr(fC, child, instance, muteErrors);
-        break;
       case VObjectType::slPrimary:
-        m_valueFactory.deleteValue(value);
-        value = evalExpr(fC, child, instance, muteErrors);
-        break;
       case VObjectType::slExpression:
-        m_valueFactory.deleteValue(value);
-        value = evalExpr(fC, child, instance, muteErrors);
-        break;
       case VObjectType::slInc_or_dec_expression:
-        m_valueFactory.deleteValue(value);
-        value = evalExpr(fC, child, instance, muteErrors);
-        break;
       case VObjectType::slConstant_mintypmax_expression:
-        m_valueFactory.deleteValue(value);
-        value = evalExpr(fC, child, instance, muteErrors);
-        break;
       case VObjectType::slMintypmax_expression:
-        m_valueFactory.deleteValue(value);
-        value = evalExpr(fC, child, instance, muteErrors);
-        break;
       case VObjectType::slParam_expression:
-        m_valueFactory.deleteValue(value);
-        value = evalExpr(fC, child, instance, muteErrors);
+      case VObjectType::slHierarchical_identifier:
+        compile_(fC, child, plan);
         break;
-      case VObjectType::slHierarchical_identifier:  {
-        m_valueFactory.deleteValue(value);
-        value = evalExpr(fC, child, instance, muteErrors);
-        break; 
-      }
       case VObjectType::slConstant_expression: {
-        Value* valueL = evalExpr(fC, child, instance, muteErrors);
+        compile_(fC, child, plan);
         NodeId op = fC->Sibling(child);
-        if (!op) {
-          m_valueFactory.deleteValue(value);
-          value = valueL;
-          break;
-        }
-        VObjectType opType = fC->Type(op);
-        switch (opType) {
-          case VObjectType::slBinOp_Plus: {
-            NodeId rval = fC->Sibling(op);
-            Value* valueR = evalExpr(fC, rval, instance, muteErrors);
-            value->plus(valueL, valueR);
-            m_valueFactory.deleteValue(valueL);
-            m_valueFactory.deleteValue(valueR);
-            break;
-          }
-          case VObjectType::slBinOp_Minus: {
-            NodeId rval = fC->Sibling(op);
-            Value* valueR = evalExpr(fC, rval, instance, muteErrors);
-            value->minus(valueL, valueR);
-            m_valueFactory.deleteValue(valueL);
-            m_valueFactory.deleteValue(valueR);
-            break;
-          }
-          case VObjectType::slBinOp_Mult: {
-            NodeId rval = fC->Sibling(op);
-            Value* valueR = evalExpr(fC, rval, instance, muteErrors);
-            value->mult(valueL, valueR);
-            m_valueFactory.deleteValue(valueL);
-            m_valueFactory.deleteValue(valueR);
-            break;
-          }
-          case VObjectType::slBinOp_Div: {
-            NodeId rval = fC->Sibling(op);
-            Value* valueR = evalExpr(fC, rval, instance, muteErrors);
-            value->div(valueL, valueR);
-            m_valueFactory.deleteValue(valueL);
-            m_valueFactory.deleteValue(valueR);
-            break;
-          }
-          case VObjectType::slBinOp_Great: {
-            NodeId rval = fC->Sibling(op);
-            Value* valueR = evalExpr(fC, rval, instance, muteErrors);
-            value->greater(valueL, valueR);
-            m_valueFactory.deleteValue(valueL);
-            m_valueFactory.deleteValue(valueR);
-            break;
-          }
-          case VObjectType::slBinOp_GreatEqual: {
-            NodeId rval = fC->Sibling(op);
-            Value* valueR = evalExpr(fC, rval, instance, muteErrors);
-            value->greater_equal(valueL, valueR);
-            m_valueFactory.deleteValue(valueL);
-            m_valueFactory.deleteValue(valueR);
-            break;
-          }
-          case VObjectType::slBinOp_Less: {
-            NodeId rval = fC->Sibling(op);
-            Value* valueR = evalExpr(fC, rval, instance, muteErrors);
-            value->lesser(valueL, valueR);
-            m_valueFactory.deleteValue(valueL);
-            m_valueFactory.deleteValue(valueR);
-            break;
-          }
-          case VObjectType::slBinOp_LessEqual: {
-            NodeId rval = fC->Sibling(op);
-            Value* valueR = evalExpr(fC, rval, instance, muteErrors);
-            value->lesser_equal(valueL, valueR);
-            m_valueFactory.deleteValue(valueL);
-            m_valueFactory.deleteValue(valueR);
-            break;
-          }
-          case VObjectType::slBinOp_Equiv: {
-            NodeId rval = fC->Sibling(op);
-            Value* valueR = evalExpr(fC, rval, instance, muteErrors);
-            value->equiv(valueL, valueR);
-            m_valueFactory.deleteValue(valueL);
-            m_valueFactory.deleteValue(valueR);
-            break;
-          }
-          case VObjectType::slBinOp_Not: {
-            NodeId rval = fC->Sibling(op);
-            Value* valueR = evalExpr(fC, rval, instance, muteErrors);
-            value->notEqual(valueL, valueR);
-            m_valueFactory.deleteValue(valueL);
-            m_valueFactory.deleteValue(valueR);
-            break;
-          }
-          case VObjectType::slBinOp_Percent: {
-            NodeId rval = fC->Sibling(op);
-            Value* valueR = evalExpr(fC, rval, instance, muteErrors);
-            value->mod(valueL, valueR);
-            m_valueFactory.deleteValue(valueL);
-            m_valueFactory.deleteValue(valueR);
-            break;
-          }
-          case VObjectType::slBinOp_LogicAnd: {
-            NodeId rval = fC->Sibling(op);
-            Value* valueR = evalExpr(fC, rval, instance, muteErrors);
-            value->logAnd(valueL, valueR);
-            m_valueFactory.deleteValue(valueL);
-            m_valueFactory.deleteValue(valueR);
-            break;
-          }
-          case VObjectType::slBinOp_LogicOr: {
-            NodeId rval = fC->Sibling(op);
-            Value* valueR = evalExpr(fC, rval, instance, muteErrors);
-            value->logOr(valueL, valueR);
-            m_valueFactory.deleteValue(valueL);
-            m_valueFactory.deleteValue(valueR);
-            break;
-          }
-          case VObjectType::slBinOp_BitwAnd: {
-            NodeId rval = fC->Sibling(op);
-            Value* valueR = evalExpr(fC, rval, instance, muteErrors);
-            value->bitwAnd(valueL, valueR);
-            m_valueFactory.deleteValue(valueL);
-            m_valueFactory.deleteValue(valueR);
-            break;
-          }
-          case VObjectType::slBinOp_BitwOr: {
-            NodeId rval = fC->Sibling(op);
-            Value* valueR = evalExpr(fC, rval, instance, muteErrors);
-            value->bitwOr(valueL, valueR);
-            m_valueFactory.deleteValue(valueL);
-            m_valueFactory.deleteValue(valueR);
-            break;
-          }
-          case VObjectType::slBinOp_BitwXor: {
-            NodeId rval = fC->Sibling(op);
-            Value* valueR = evalExpr(fC, rval, instance, muteErrors);
-            value->bitwXor(valueL, valueR);
-            m_valueFactory.deleteValue(valueL);
-            m_valueFactory.deleteValue(valueR);
-            break;
-          }
-          case VObjectType::slBinOp_ShiftLeft: {
-            NodeId rval = fC->Sibling(op);
-            Value* valueR = evalExpr(fC, rval, instance, muteErrors);
-            value->shiftLeft(valueL, valueR);
-            m_valueFactory.deleteValue(valueL);
-            m_valueFactory.deleteValue(valueR);
-            break;
-          }
-          case VObjectType::slBinOp_ShiftRight: {
-            NodeId rval = fC->Sibling(op);
-            Value* valueR = evalExpr(fC, rval, instance, muteErrors);
-            value->shiftRight(valueL, valueR);
-            m_valueFactory.deleteValue(valueL);
-            m_valueFactory.deleteValue(valueR);
-            break;
-          }
+        if (!op) break;
+        Op binOp = Op::Invalid;
+        switch (fC->Type(op)) {
+          case VObjectType::slBinOp_Plus: binOp = Op::Plus; break;
+          case VObjectType::slBinOp_Minus: binOp = Op::Minus; break;
+          case VObjectType::slBinOp_Mult: binOp = Op::Mult; break;
+          case VObjectType::slBinOp_Div: binOp = Op::Div; break;
+          case VObjectType::slBinOp_Great: binOp = Op::Greater; break;
+          case VObjectType::slBinOp_GreatEqual: binOp = Op::GreaterEqual; break;
+          case VObjectType::slBinOp_Less: binOp = Op::Lesser; break;
+          case VObjectType::slBinOp_LessEqual: binOp = Op::LesserEqual; break;
+          case VObjectType::slBinOp_Equiv: binOp = Op::Equiv; break;
+          case VObjectType::slBinOp_Not: binOp = Op::NotEqual; break;
+          case VObjectType::slBinOp_Percent: binOp = Op::Mod; break;
+          case VObjectType::slBinOp_LogicAnd: binOp = Op::LogAnd; break;
+          case VObjectType::slBinOp_LogicOr: binOp = Op::LogOr; break;
+          case VObjectType::slBinOp_BitwAnd: binOp = Op::BitwAnd; break;
+          case VObjectType::slBinOp_BitwOr: binOp = Op::BitwOr; break;
+          case VObjectType::slBinOp_BitwXor: binOp = Op::BitwXor; break;
+          case VObjectType::slBinOp_ShiftLeft: binOp = Op::ShiftLeft; break;
+          case VObjectType::slBinOp_ShiftRight: binOp = Op::ShiftRight; break;
           default:
-            m_valueFactory.deleteValue(value);
-            value = valueL;
+            // Unsupported operator, the value is the left operand
             break;
         }
-      } break;
+        if (binOp == Op::Invalid) break;
+        compile_(fC, fC->Sibling(op), plan);
+        emit_(plan, binOp);
+        break;
+      }
       case VObjectType::slIntConst: {
-        std::string val = fC->SymName(child);
+        const std::string& val = fC->SymName(child);
         if (strstr(val.c_str(), "'")) {
           uint64_t hex_value = 0;
           char base = 'h';
@@ -333,127 +221,329 @@ Value* ExprBuilder::evalExpr(FileContent* fC, NodeId parent,
             default:
               break;
           }
-          value->set(hex_value);
+          emit_(plan, Op::Unsigned);
+          plan.m_instrs.back().m_unsigned = hex_value;
         } else {
-          value->set((int64_t)atol(val.c_str()));
+          emit_(plan, Op::Int);
+          plan.m_instrs.back().m_int = (int64_t)atol(val.c_str());
         }
         break;
       }
       case VObjectType::slRealConst: {
-        std::string real = fC->SymName(child).c_str();
-        std::istringstream os(real);
+        std::istringstream os(fC->SymName(child));
         double d;
         os >> d;
-        value->set(d);
+        emit_(plan, Op::Real);
+        plan.m_instrs.back().m_real = d;
         break;
       }
-      case VObjectType::slNull_keyword: {
-        value->set((uint64_t)0);
+      case VObjectType::slNull_keyword:
+        emit_(plan, Op::Unsigned);
         break;
-      }
-      case VObjectType::slStringConst: {
-        std::string name = fC->SymName(child).c_str();
-        Value* sval = NULL;
-        if (instance) 
-          sval = instance->getValue(name);
-        
-        if (sval == NULL) {
-          if (muteErrors == false) {
-            Location loc(fC->getFileId(child), fC->Line(child), 0,
-                         m_symbols->registerSymbol(name));
-            Error err(ErrorDefinition::ELAB_UNDEF_VARIABLE, loc);
-            m_errors->addError(err);
-          }
-          value->setInvalid();
-          break;
-        }
-        if (sval->getType() == Value::Type::String) {
-          m_valueFactory.deleteValue(value);
-          value = sval;
-        } else {
-          value->u_plus(sval);
-        }
+      case VObjectType::slStringConst:
+        emit_(plan, Op::Load, child);
         break;
-      }
-      case VObjectType::slStringLiteral: {
-        std::string name = fC->SymName(child).c_str();
-        m_valueFactory.deleteValue(value);
-        value = m_valueFactory.newStValue();
-        value->set(name);
+      case VObjectType::slStringLiteral:
+        emit_(plan, Op::String);
+        plan.m_instrs.back().m_unsigned = plan.m_strings.size();
+        plan.m_strings.push_back(StValue(fC->SymName(child)));
         break;
-      }
       case VObjectType::slNumber_1Tickb0:
       case VObjectType::slNumber_1TickB0:
       case VObjectType::slNumber_Tickb0:
       case VObjectType::slNumber_TickB0:
-      case VObjectType::slNumber_Tick0:  {
-        value->set(0,Value::Type::Scalar, 1);
+      case VObjectType::slNumber_Tick0:
+        emit_(plan, Op::Scalar);
         break;
-      }
       case VObjectType::slNumber_1Tickb1:
       case VObjectType::slNumber_1TickB1:
       case VObjectType::slNumber_Tickb1:
       case VObjectType::slNumber_TickB1:
-      case VObjectType::slNumber_Tick1:  {
-        value->set(1,Value::Type::Scalar, 1);
+      case VObjectType::slNumber_Tick1:
+        emit_(plan, Op::Scalar);
+        plan.m_instrs.back().m_unsigned = 1;
         break;
-      }
       case VObjectType::slVariable_lvalue: {
-        Value* variableVal = evalExpr(fC, child, instance, muteErrors);
+        compile_(fC, child, plan);
         NodeId sibling = fC->Sibling(child);
         if (sibling) {
           VObjectType opType = fC->Type(sibling);
           if (opType == VObjectType::slIncDec_PlusPlus)
-            variableVal->incr();
+            emit_(plan, Op::PostIncr);
           else if (opType == VObjectType::slIncDec_MinusMinus)
-            variableVal->decr();
-        } 
-        m_valueFactory.deleteValue(value);
-        value = variableVal;
+            emit_(plan, Op::PostDecr);
+        }
         break;
       }
       default:
-        value->setInvalid();
+        emit_(plan, Op::Invalid);
         break;
     }
+  } else if (fC->Type(parent) == VObjectType::slStringConst) {
+    // Only a post incremented or decremented variable has a value
+    emit_(plan, Op::LoadIncDec, parent);
+    VObjectType op_type = fC->Type(fC->Sibling(parent));
+    if (op_type == VObjectType::slIncDec_PlusPlus)
+      plan.m_instrs.back().m_int = 1;
+    else if (op_type == VObjectType::slIncDec_MinusMinus)
+      plan.m_instrs.back().m_int = -1;
   } else {
-    VObjectType type = fC->Type(parent);
-    switch (type) {
-      case VObjectType::slStringConst: {
-        std::string name = fC->SymName(parent).c_str();
-        Value* sval = NULL;
-        if (instance) sval = instance->getValue(name);
+    emit_(plan, Op::Invalid);
+  }
+}
+
+void ExprBuilder::undefVariable_(FileContent* fC, NodeId id, NodeId locId) {
+  Location loc(fC->getFileId(locId), fC->Line(locId), 0,
+               m_symbols->registerSymbol(fC->SymName(id)));
+  Error err(ErrorDefinition::ELAB_UNDEF_VARIABLE, loc);
+  m_errors->addError(err);
+}
+
+void ExprBuilder::load_(Operand& operand, Value* value) {
+  if (value->getNbWords() > 1 || value->getType() == Value::Type::String) {
+    operand.m_wide = value;
+    return;
+  }
+  operand.m_wide = NULL;
+  operand.m_value = value->getNbWords() ? value->getValueUL(0) : 0;
+  operand.m_type = value->getType();
+  operand.m_size = value->getSize();
+  operand.m_valid = value->isValid();
+}
+
+Value* ExprBuilder::widen_(Operand& operand, LValue& scratch) {
+  if (operand.m_wide) return operand.m_wide;
+  scratch.set(operand.m_value, operand.m_type, operand.m_size);
+  if (!operand.m_valid) scratch.setInvalid();
+  return &scratch;
+}
+
+void ExprBuilder::unary_(Op op, Operand& result, const Operand& a) {
+  result.m_wide = NULL;
+  result.m_type = a.m_type;
+  result.m_size = a.m_size;
+  result.m_valid = a.m_valid;
+  result.m_value = a.m_value;
+  switch (op) {
+    case Op::PreIncr:
+      result.m_value++;
+      break;
+    case Op::PreDecr:
+      result.m_value--;
+      break;
+    case Op::UMinus:
+      result.m_value = ~a.m_value + 1;
+      break;
+    case Op::UNot:
+      if (a.m_valid) result.m_value = !a.m_value;
+      break;
+    case Op::UTilda:
+      if (a.m_valid) result.m_value = ~a.m_value;
+      break;
+    default:
+      break;
+  }
+}
+
+void ExprBuilder::binary_(Op op, Operand& result, const Operand& a,
+                          const Operand& b) {
+  result.m_wide = NULL;
+  result.m_type = b.m_type;
+  result.m_size = (a.m_size > b.m_size) ? a.m_size : b.m_size;
+  result.m_valid = a.m_valid && b.m_valid;
+  result.m_value = 0;
+  if (!result.m_valid) return;
+  // Wrapping arithmetic on the unsigned words, the signed view is only used
+  // for divisions and comparisons
+  uint64_t l = a.m_value;
+  uint64_t r = b.m_value;
+  int64_t sl = (int64_t)l;
+  int64_t sr = (int64_t)r;
+  switch (op) {
+    case Op::Plus: result.m_value = l + r; break;
+    case Op::Minus: result.m_value = l - r; break;
+    case Op::Mult: result.m_value = l * r; break;
+    case Op::Div:
+    case Op::Mod:
+      if (sr == 0) {
+        result.m_valid = false;
+        break;
+      }
+      // INT64_MIN / -1 overflows, the quotient wraps around
+      if (sr == -1) {
+        result.m_value = (op == Op::Div) ? (~l + 1) : 0;
+        break;
+      }
+      result.m_value = (op == Op::Div) ? (uint64_t)(sl / sr)
+                                       : (uint64_t)(sl % sr);
+      break;
+    case Op::Greater: result.m_value = sl > sr; break;
+    case Op::GreaterEqual: result.m_value = sl >= sr; break;
+    case Op::Lesser: result.m_value = sl < sr; break;
+    case Op::LesserEqual: result.m_value = sl <= sr; break;
+    case Op::Equiv: result.m_value = l == r; break;
+    case Op::NotEqual: result.m_value = l != r; break;
+    case Op::LogAnd: result.m_value = l && r; break;
+    case Op::LogOr: result.m_value = l || r; break;
+    case Op::BitwAnd: result.m_value = l & r; break;
+    case Op::BitwOr: result.m_value = l | r; break;
+    case Op::BitwXor: result.m_value = l ^ r; break;
+    // Every bit is shifted out by 64 positions or more
+    case Op::ShiftLeft: result.m_value = (r < 64) ? (l << r) : 0; break;
+    default: result.m_value = (r < 64) ? (l >> r) : 0; break;
+  }
+}
+
+Value* ExprBuilder::run_(FileContent* fC, Plan& plan, bool muteErrors) {
+  unsigned int size = plan.m_instrs.size();
+  unsigned int read = 0;
+  if (m_scratch.size() < 3 * size) m_scratch.resize(3 * size);
+  m_stack.clear();
+  for (unsigned int i = 0; i < size; i++) {
+    const Instr& instr = plan.m_instrs[i];
+    LValue& value = m_scratch[3 * i];
+    Operand result;
+    result.m_wide = NULL;
+    result.m_value = 0;
+    result.m_type = Value::Type::None;
+    result.m_size = 0;
+    result.m_valid = true;
+    switch (instr.m_op) {
+      case Op::Int:
+        result.m_value = (uint64_t)instr.m_int;
+        result.m_type = Value::Type::Integer;
+        result.m_size = 64;
+        break;
+      case Op::Unsigned:
+        result.m_value = instr.m_unsigned;
+        result.m_type = Value::Type::Unsigned;
+        result.m_size = 64;
+        break;
+      case Op::Real:
+        result.m_value = (uint64_t)instr.m_real;
+        result.m_type = Value::Type::Double;
+        result.m_size = 64;
+        break;
+      case Op::Scalar:
+        result.m_value = instr.m_unsigned;
+        result.m_type = Value::Type::Scalar;
+        result.m_size = 1;
+        break;
+      case Op::String:
+        result.m_wide = &plan.m_strings[instr.m_unsigned];
+        break;
+      case Op::Load: {
+        Value* sval = m_reads[read++];
         if (sval == NULL) {
-          if (muteErrors == false) {
-            Location loc(fC->getFileId(child), fC->Line(child), 0,
-                         m_symbols->registerSymbol(name));
-            Error err(ErrorDefinition::ELAB_UNDEF_VARIABLE, loc);
-            m_errors->addError(err);
-          }
-          value->setInvalid();
+          if (muteErrors == false)
+            undefVariable_(fC, instr.m_node, instr.m_node);
+          result.m_valid = false;
+        } else if (sval->getType() != Value::Type::String &&
+                   sval->getNbWords() > 1) {
+          value.u_plus(sval);
+          result.m_wide = &value;
+        } else {
+          load_(result, sval);
+        }
+        break;
+      }
+      case Op::LoadIncDec: {
+        Value* sval = m_reads[read++];
+        if (sval == NULL) {
+          if (muteErrors == false) undefVariable_(fC, instr.m_node, 0);
+          result.m_valid = false;
+        } else if (instr.m_int) {
+          value.u_plus(sval);
+          if (instr.m_int > 0)
+            value.incr();
+          else
+            value.decr();
+          load_(result, &value);
+        } else {
+          result.m_valid = false;
+        }
+        break;
+      }
+      case Op::Invalid:
+        result.m_valid = false;
+        break;
+      case Op::PostIncr:
+      case Op::PostDecr: {
+        Operand& top = m_stack.back();
+        if (top.m_wide == NULL)
+          top.m_value += (instr.m_op == Op::PostIncr) ? 1 : -1;
+        else if (instr.m_op == Op::PostIncr)
+          top.m_wide->incr();
+        else
+          top.m_wide->decr();
+        continue;
+      }
+      case Op::PreIncr:
+      case Op::PreDecr:
+      case Op::UPlus:
+      case Op::UMinus:
+      case Op::UNot:
+      case Op::UTilda: {
+        Operand a = m_stack.back();
+        m_stack.pop_back();
+        if (a.m_wide == NULL) {
+          unary_(instr.m_op, result, a);
           break;
         }
-        NodeId op = fC->Sibling(parent);
-        VObjectType op_type = fC->Type(op);
-        switch (op_type) {
-          case VObjectType::slIncDec_PlusPlus:
-            value->u_plus(sval);
-            value->incr();
-            return value;
-          case VObjectType::slIncDec_MinusMinus:
-            value->u_plus(sval);
-            value->decr();
-            return value;
-          default:
-            break;
+        switch (instr.m_op) {
+          case Op::PreIncr: value.u_plus(a.m_wide); value.incr(); break;
+          case Op::PreDecr: value.u_plus(a.m_wide); value.decr(); break;
+          case Op::UPlus: value.u_plus(a.m_wide); break;
+          case Op::UMinus: value.u_minus(a.m_wide); break;
+          case Op::UNot: value.u_not(a.m_wide); break;
+          default: value.u_tilda(a.m_wide); break;
         }
+        result.m_wide = &value;
         break;
       }
-      default:
+      default: {
+        Operand b = m_stack.back();
+        m_stack.pop_back();
+        Operand a = m_stack.back();
+        m_stack.pop_back();
+        if (a.m_wide == NULL && b.m_wide == NULL) {
+          binary_(instr.m_op, result, a, b);
+          break;
+        }
+        Value* wa = widen_(a, m_scratch[3 * i + 1]);
+        Value* wb = widen_(b, m_scratch[3 * i + 2]);
+        switch (instr.m_op) {
+          case Op::Plus: value.plus(wa, wb); break;
+          case Op::Minus: value.minus(wa, wb); break;
+          case Op::Mult: value.mult(wa, wb); break;
+          case Op::Div: value.div(wa, wb); break;
+          case Op::Mod: value.mod(wa, wb); break;
+          case Op::Greater: value.greater(wa, wb); break;
+          case Op::GreaterEqual: value.greater_equal(wa, wb); break;
+          case Op::Lesser: value.lesser(wa, wb); break;
+          case Op::LesserEqual: value.lesser_equal(wa, wb); break;
+          case Op::Equiv: value.equiv(wa, wb); break;
+          case Op::NotEqual: value.notEqual(wa, wb); break;
+          case Op::LogAnd: value.logAnd(wa, wb); break;
+          case Op::LogOr: value.logOr(wa, wb); break;
+          case Op::BitwAnd: value.bitwAnd(wa, wb); break;
+          case Op::BitwOr: value.bitwOr(wa, wb); break;
+          case Op::BitwXor: value.bitwXor(wa, wb); break;
+          case Op::ShiftLeft: value.shiftLeft(wa, wb); break;
+          default: value.shiftRight(wa, wb); break;
+        }
+        result.m_wide = &value;
         break;
+      }
     }
-
-    value->setInvalid();
+    m_stack.push_back(result);
   }
-  return value;
+
+  // Nothing is allocated: a wide result is a scratch value, a literal of
+  // the plan or a string parameter of the instance
+  Operand& top = m_stack.back();
+  if (top.m_wide) return top.m_wide;
+  m_result.set(top.m_value, top.m_type, top.m_size);
+  if (!top.m_valid) m_result.setInvalid();
+  return &m_result;
 }
@@ -23,6 +23,8 @@
 
 #ifndef EXPRBUILDER_H
 #define EXPRBUILDER_H
+#include <unordered_map>
+#include <vector>
 #include "SourceCompile/SymbolTable.h"
 
 #include "Expression/Expr.h"
@@ -33,6 +35,7 @@
 namespace SURELOG {
 
 class ErrorContainer;
+class FoldCache;
 
 class ExprBuilder {
  public:
@@ -41,18 +44,83 @@ class ExprBuilder {
   virtual ~ExprBuilder();
   Value* evalExpr(FileContent*, NodeId id, ValuedComponentI* instance = NULL,
                   bool muteErrors = false);
+  /* Same evaluation without allocating the result: it belongs to the
+     builder and is only valid until its next evaluation */
+  Value* evalView(FileContent*, NodeId id, ValuedComponentI* instance = NULL,
+                  bool muteErrors = false);
   Value* clone(Value* val);
   void seterrorReporting(ErrorContainer* errors, SymbolTable* symbols) {
     m_errors = errors;
     m_symbols = symbols;
   }
+  /* Results of the expressions reading parameters are memoized there */
+  void setFoldCache(FoldCache* cache) { m_foldCache = cache; }
   void deleteValue(Value* value) { m_valueFactory.deleteValue(value); }
   ValueFactory& getValueFactory() { return m_valueFactory; }
 
  private:
+  /* A constant expression compiled in postfix order: the pass-through nodes
+     of the parse tree are dropped and the literals are parsed once. The
+     plan only depends on the parse tree, it is reused for every instance. */
+  enum class Op : unsigned char {
+    Int, Unsigned, Real, Scalar, String, Load, LoadIncDec, Invalid,
+    PreIncr, PreDecr, PostIncr, PostDecr,
+    UPlus, UMinus, UNot, UTilda,
+    Plus, Minus, Mult, Div, Mod, Greater, GreaterEqual, Lesser, LesserEqual,
+    Equiv, NotEqual, LogAnd, LogOr, BitwAnd, BitwOr, BitwXor,
+    ShiftLeft, ShiftRight
+  };
+  struct Instr {
+    Op m_op;
+    NodeId m_node;
+    union {
+      uint64_t m_unsigned;
+      int64_t m_int;
+      double m_real;
+    };
+  };
+  struct Plan {
+    std::vector<Instr> m_instrs;
+    std::vector<StValue> m_strings;
+    unsigned int m_nbReads;
+  };
+  typedef std::unordered_map<NodeId, Plan> PlanMap;
+  /* Operand of a running plan: values of at most 64 bits are held inline
+     and computed without virtual calls, wider values and strings are kept
+     behind their Value */
+  struct Operand {
+    uint64_t m_value;
+    Value* m_wide;
+    Value::Type m_type;
+    unsigned short m_size;
+    bool m_valid;
+  };
+
+  Plan& getPlan_(FileContent* fC, NodeId id);
+  void compile_(FileContent* fC, NodeId parent, Plan& plan);
+  void emit_(Plan& plan, Op op, NodeId node = 0);
+  bool resolve_(FileContent* fC, Plan& plan, ValuedComponentI* instance);
+  void foldKey_(FileContent* fC, NodeId id);
+  Value* run_(FileContent* fC, Plan& plan, bool muteErrors);
+  void undefVariable_(FileContent* fC, NodeId id, NodeId locId);
+  void load_(Operand& operand, Value* value);
+  Value* widen_(Operand& operand, LValue& scratch);
+  void unary_(Op op, Operand& result, const Operand& a);
+  void binary_(Op op, Operand& result, const Operand& a, const Operand& b);
+
   ValueFactory m_valueFactory;
   ErrorContainer* m_errors;
   SymbolTable* m_symbols;
+  std::unordered_map<FileContent*, PlanMap> m_plans;
+  FoldCache* m_foldCache;
+  // Parameters read by the running plan, in instruction order
+  std::vector<Value*> m_reads;
+  std::string m_foldKey;
+  // Wide operands of the running plan, three scratch values per instruction
+  std::vector<LValue> m_scratch;
+  std::vector<Operand> m_stack;
+  // Narrow result of the last evaluation
+  LValue m_result;
 };
 
 };  // namespace SURELOG
@@ -0,0 +1,563 @@
+/*
+ Copyright 2026 The Surelog contributors
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+/*
+ * File:   ExprBuilder_test.cpp
+ *
+ * Created on October 19, 2026
+ */
+
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "SourceCompile/SymbolTable.h"
+#include "Design/FileContent.h"
+#include "Expression/ExprBuilder.h"
+#include "Expression/FoldCache.h"
+#include "gtest/gtest.h"
+
+using namespace SURELOG;
+
+namespace {
+
+/* Parameters of an instance */
+class Scope : public ValuedComponentI {
+ public:
+  Scope() : ValuedComponentI(NULL) {}
+  ~Scope() override {
+    for (auto& value : m_values) delete value.second;
+  }
+  Value* getValue(const std::string& name) override {
+    auto itr = m_values.find(name);
+    return (itr == m_values.end()) ? NULL : (*itr).second;
+  }
+  void setValue(const std::string& name, Value* val,
+                ExprBuilder& exprBuilder) override {
+    delete m_values[name];
+    m_values[name] = val;
+  }
+  void copyValue(const std::string& name, Value* val,
+                 ExprBuilder& exprBuilder) override {
+    delete m_values[name];
+    m_values[name] = new LValue(*(LValue*)val);
+  }
+  void setInt(const std::string& name, int64_t value,
+              unsigned short size = 64, bool valid = true) {
+    LValue* val = new LValue();
+    val->set((uint64_t)value, Value::Type::Integer, size);
+    if (!valid) val->setInvalid();
+    delete m_values[name];
+    m_values[name] = val;
+  }
+
+ private:
+  std::map<std::string, Value*> m_values;
+};
+
+/* The 64 bits result of an expression, as the elaboration computes it */
+struct Result {
+  int64_t m_value;
+  bool m_valid;
+};
+
+/* Constant expressions built as the parser shapes them: an expression node
+   whose children are a literal, a parameter, a unary operator and its
+   operand, or two operands around a binary operator */
+class ExprTree {
+ public:
+  ExprTree() : m_fC(0, NULL, &m_symbols, NULL, NULL, 0) {
+    m_fC.getVObjects().push_back(VObject(0, 0, VObjectType::slNoType, 0, 0));
+  }
+  FileContent* fileContent() { return &m_fC; }
+
+  NodeId literal(int64_t value) {
+    NodeId id = node_(VObjectType::slConstant_expression);
+    link_(id, {leaf_(VObjectType::slIntConst, std::to_string(value))});
+    return id;
+  }
+  NodeId param(const std::string& name) {
+    NodeId id = node_(VObjectType::slConstant_expression);
+    link_(id, {leaf_(VObjectType::slStringConst, name)});
+    return id;
+  }
+  NodeId unary(VObjectType op, NodeId operand) {
+    NodeId id = node_(VObjectType::slConstant_expression);
+    link_(id, {leaf_(op, ""), operand});
+    return id;
+  }
+  NodeId binary(VObjectType op, NodeId left, NodeId right) {
+    NodeId id = node_(VObjectType::slConstant_expression);
+    link_(id, {left, leaf_(op, ""), right});
+    return id;
+  }
+  /* Pass-through nodes the plan drops */
+  NodeId wrap(NodeId expr) {
+    NodeId primary = node_(VObjectType::slConstant_primary);
+    link_(primary, {expr});
+    NodeId id = node_(VObjectType::slConstant_expression);
+    link_(id, {primary});
+    return id;
+  }
+
+ private:
+  NodeId node_(VObjectType type) {
+    std::vector<VObject>& objects = m_fC.getVObjects();
+    objects.push_back(VObject(0, 0, type, 1, 0));
+    return objects.size() - 1;
+  }
+  NodeId leaf_(VObjectType type, const std::string& name) {
+    NodeId id = node_(type);
+    if (!name.empty())
+      m_fC.getVObjects()[id].m_name = m_symbols.registerSymbol(name);
+    return id;
+  }
+  void link_(NodeId parent, const std::vector<NodeId>& children) {
+    std::vector<VObject>& objects = m_fC.getVObjects();
+    objects[parent].m_child = children[0];
+    for (unsigned int i = 0; i < children.size(); i++) {
+      objects[children[i]].m_parent = parent;
+      if (i + 1 < children.size())
+        objects[children[i]].m_sibling = children[i + 1];
+    }
+  }
+
+  SymbolTable m_symbols;
+  FileContent m_fC;
+};
+
+const std::vector<VObjectType> BinaryOps = {
+    VObjectType::slBinOp_Plus,      VObjectType::slBinOp_Minus,
+    VObjectType::slBinOp_Mult,      VObjectType::slBinOp_Div,
+    VObjectType::slBinOp_Percent,   VObjectType::slBinOp_Great,
+    VObjectType::slBinOp_GreatEqual, VObjectType::slBinOp_Less,
+    VObjectType::slBinOp_LessEqual, VObjectType::slBinOp_Equiv,
+    VObjectType::slBinOp_Not,       VObjectType::slBinOp_LogicAnd,
+    VObjectType::slBinOp_LogicOr,   VObjectType::slBinOp_BitwAnd,
+    VObjectType::slBinOp_BitwOr,    VObjectType::slBinOp_BitwXor,
+    VObjectType::slBinOp_ShiftLeft, VObjectType::slBinOp_ShiftRight};
+
+const std::vector<VObjectType> UnaryOps = {
+    VObjectType::slUnary_Minus, VObjectType::slUnary_Plus,
+    VObjectType::slUnary_Not, VObjectType::slUnary_Tilda};
+
+const std::vector<std::string> Params = {"A", "B", "C"};
+
+/* Random expression with its value computed on the side, the arithmetic
+   wraps around on 64 bits */
+class RandomExpr {
+ public:
+  RandomExpr(unsigned int seed) : m_random(seed) {}
+
+  NodeId build(ExprTree& tree, Scope& scope, unsigned int depth,
+               Result& result) {
+    unsigned int kind = (depth == 0) ? m_random() % 2 : m_random() % 8;
+    if (kind == 0) {
+      int64_t value = m_random() % 100;
+      result = {value, true};
+      return tree.literal(value);
+    }
+    if (kind == 1) {
+      const std::string& name = Params[m_random() % Params.size()];
+      result = {scope.getValue(name)->getValueL(), true};
+      return tree.param(name);
+    }
+    if (kind == 2) {
+      Result a;
+      NodeId operand = build(tree, scope, depth - 1, a);
+      VObjectType op = UnaryOps[m_random() % UnaryOps.size()];
+      result = unary_(op, a);
+      return tree.unary(op, operand);
+    }
+    if (kind == 3) return tree.wrap(build(tree, scope, depth - 1, result));
+    Result a, b;
+    VObjectType op = BinaryOps[m_random() % BinaryOps.size()];
+    NodeId left = build(tree, scope, depth - 1, a);
+    NodeId right;
+    if (op == VObjectType::slBinOp_ShiftLeft ||
+        op == VObjectType::slBinOp_ShiftRight) {
+      b = {(int64_t)(m_random() % 70), true};
+      right = tree.literal(b.m_value);
+    } else {
+      right = build(tree, scope, depth - 1, b);
+    }
+    result = binary_(op, a, b);
+    return tree.binary(op, left, right);
+  }
+
+ private:
+  static Result unary_(VObjectType op, Result a) {
+    uint64_t v = a.m_value;
+    switch (op) {
+      case VObjectType::slUnary_Minus: v = ~v + 1; break;
+      case VObjectType::slUnary_Not: v = !v; break;
+      case VObjectType::slUnary_Tilda: v = ~v; break;
+      default: break;
+    }
+    return {(int64_t)v, a.m_valid};
+  }
+
+  static Result binary_(VObjectType op, Result a, Result b) {
+    Result result = {0, a.m_valid && b.m_valid};
+    if (!result.m_valid) return result;
+    uint64_t l = a.m_value;
+    uint64_t r = b.m_value;
+    uint64_t v = 0;
+    switch (op) {
+      case VObjectType::slBinOp_Plus: v = l + r; break;
+      case VObjectType::slBinOp_Minus: v = l - r; break;
+      case VObjectType::slBinOp_Mult: v = l * r; break;
+      case VObjectType::slBinOp_Div:
+      case VObjectType::slBinOp_Percent:
+        if (r == 0) {
+          result.m_valid = false;
+          break;
+        }
+        if (b.m_value == -1) {
+          v = (op == VObjectType::slBinOp_Div) ? ~l + 1 : 0;
+          break;
+        }
+        v = (op == VObjectType::slBinOp_Div) ? a.m_value / b.m_value
+                                             : a.m_value % b.m_value;
+        break;
+      case VObjectType::slBinOp_Great: v = a.m_value > b.m_value; break;
+      case VObjectType::slBinOp_GreatEqual: v = a.m_value >= b.m_value; break;
+      case VObjectType::slBinOp_Less: v = a.m_value < b.m_value; break;
+      case VObjectType::slBinOp_LessEqual: v = a.m_value <= b.m_value; break;
+      case VObjectType::slBinOp_Equiv: v = l == r; break;
+      case VObjectType::slBinOp_Not: v = l != r; break;
+      case VObjectType::slBinOp_LogicAnd: v = l && r; break;
+      case VObjectType::slBinOp_LogicOr: v = l || r; break;
+      case VObjectType::slBinOp_BitwAnd: v = l & r; break;
+      case VObjectType::slBinOp_BitwOr: v = l | r; break;
+      case VObjectType::slBinOp_BitwXor: v = l ^ r; break;
+      case VObjectType::slBinOp_ShiftLeft: v = (r < 64) ? l << r : 0; break;
+      default: v = (r < 64) ? l >> r : 0; break;
+    }
+    if (!result.m_valid) return result;
+    result.m_value = (int64_t)v;
+    return result;
+  }
+
+  std::mt19937 m_random;
+};
+
+void expectResult(ExprBuilder& builder, FileContent* fC, NodeId id,
+                  Scope& scope, const Result& expected) {
+  Value* value = builder.evalExpr(fC, id, &scope, true);
+  ASSERT_NE(value, nullptr);
+  EXPECT_EQ(value->isValid(), expected.m_valid);
+  if (expected.m_valid) {
+    EXPECT_EQ(value->getValueL(), expected.m_value);
+  }
+  builder.deleteValue(value);
+}
+
+void setParams(Scope& scope, std::mt19937& random) {
+  for (const std::string& name : Params)
+    scope.setInt(name, (int64_t)(random() % 200) - 100);
+}
+
+}  // namespace
+
+TEST(ExprBuilderTest, PlansMatchTheExpressionValues) {
+  std::mt19937 random(7);
+  for (unsigned int seed = 0; seed < 500; seed++) {
+    ExprTree tree;
+    Scope scope;
+    setParams(scope, random);
+    RandomExpr expr(seed);
+    Result expected;
+    NodeId id = expr.build(tree, scope, 1 + seed % 5, expected);
+    ExprBuilder builder;
+    expectResult(builder, tree.fileContent(), id, scope, expected);
+  }
+}
+
+TEST(ExprBuilderTest, PlansAreReusedAcrossInstances) {
+  // One plan per expression node, run against each instance's parameters
+  ExprTree tree;
+  std::vector<NodeId> ids;
+  for (unsigned int seed = 0; seed < 50; seed++) {
+    Scope scope;
+    std::mt19937 random(seed);
+    setParams(scope, random);
+    RandomExpr expr(seed);
+    Result expected;
+    ids.push_back(expr.build(tree, scope, 4, expected));
+  }
+  ExprBuilder builder;
+  std::mt19937 random(11);
+  for (unsigned int instance = 0; instance < 20; instance++) {
+    Scope scope;
+    setParams(scope, random);
+    for (unsigned int seed = 0; seed < ids.size(); seed++) {
+      // Same expression, rebuilt in a scratch tree to know its value
+      ExprTree check;
+      RandomExpr expr(seed);
+      Result expected;
+      expr.build(check, scope, 4, expected);
+      expectResult(builder, tree.fileContent(), ids[seed], scope, expected);
+    }
+  }
+}
+
+TEST(ExprBuilderTest, UndefinedParametersAreInvalid) {
+  ExprTree tree;
+  NodeId id = tree.binary(VObjectType::slBinOp_Plus, tree.param("A"),
+                          tree.param("D"));
+  Scope scope;
+  scope.setInt("A", 3);
+  ExprBuilder builder;
+  expectResult(builder, tree.fileContent(), id, scope, {0, false});
+  // The plan does not keep the failed lookup
+  scope.setInt("D", 4);
+  expectResult(builder, tree.fileContent(), id, scope, {7, true});
+}
+
+TEST(ExprBuilderTest, DivisionByZeroIsInvalid) {
+  ExprTree tree;
+  NodeId div = tree.binary(VObjectType::slBinOp_Div, tree.literal(5),
+                           tree.param("A"));
+  NodeId mod = tree.binary(VObjectType::slBinOp_Percent, tree.literal(5),
+                           tree.param("A"));
+  Scope scope;
+  scope.setInt("A", 0);
+  ExprBuilder builder;
+  expectResult(builder, tree.fileContent(), div, scope, {0, false});
+  expectResult(builder, tree.fileContent(), mod, scope, {0, false});
+  scope.setInt("A", -2);
+  expectResult(builder, tree.fileContent(), div, scope, {-2, true});
+  expectResult(builder, tree.fileContent(), mod, scope, {1, true});
+}
+
+TEST(ExprBuilderTest, OverflowsWrapAround) {
+  ExprTree tree;
+  Scope scope;
+  scope.setInt("A", INT64_MIN);
+  scope.setInt("B", -1);
+  scope.setInt("C", INT64_MAX);
+  FileContent* fC = tree.fileContent();
+  ExprBuilder builder;
+  expectResult(builder, fC,
+               tree.binary(VObjectType::slBinOp_Div, tree.param("A"),
+                           tree.param("B")),
+               scope, {INT64_MIN, true});
+  expectResult(builder, fC,
+               tree.binary(VObjectType::slBinOp_Percent, tree.param("A"),
+                           tree.param("B")),
+               scope, {0, true});
+  expectResult(builder, fC,
+               tree.binary(VObjectType::slBinOp_Plus, tree.param("C"),
+                           tree.literal(1)),
+               scope, {INT64_MIN, true});
+  expectResult(builder, fC,
+               tree.binary(VObjectType::slBinOp_Minus, tree.param("A"),
+                           tree.literal(1)),
+               scope, {INT64_MAX, true});
+  expectResult(builder, fC,
+               tree.binary(VObjectType::slBinOp_Mult, tree.param("C"),
+                           tree.literal(2)),
+               scope, {-2, true});
+  expectResult(builder, fC, tree.unary(VObjectType::slUnary_Minus,
+                                       tree.param("A")),
+               scope, {INT64_MIN, true});
+}
+
+TEST(ExprBuilderTest, LongShiftsClearTheValue) {
+  ExprTree tree;
+  Scope scope;
+  scope.setInt("A", -1);
+  scope.setInt("B", -1);
+  FileContent* fC = tree.fileContent();
+  ExprBuilder builder;
+  for (int64_t count : {63, 64, 65, 100}) {
+    int64_t expected = (count < 64) ? INT64_MIN : 0;
+    expectResult(builder, fC,
+                 tree.binary(VObjectType::slBinOp_ShiftLeft, tree.param("A"),
+                             tree.literal(count)),
+                 scope, {expected, true});
+    expected = (count < 64) ? 1 : 0;
+    expectResult(builder, fC,
+                 tree.binary(VObjectType::slBinOp_ShiftRight, tree.param("A"),
+                             tree.literal(count)),
+                 scope, {expected, true});
+  }
+  // A negative count is a very large one
+  expectResult(builder, fC,
+               tree.binary(VObjectType::slBinOp_ShiftLeft, tree.literal(1),
+                           tree.param("B")),
+               scope, {0, true});
+}
+
+TEST(ExprBuilderTest, WideDivisions) {
+  ExprTree tree;
+  Scope scope;
+  uint64_t words[2] = {7, 1};
+  ExprBuilder builder;
+  scope.setValue("W", new LValue(Value::Type::Unsigned, words, 2, 128),
+                 builder);
+  FileContent* fC = tree.fileContent();
+  // (2^64 + 7) / 2 = 2^63 + 3, the low word of the quotient
+  expectResult(builder, fC,
+               tree.binary(VObjectType::slBinOp_Div, tree.param("W"),
+                           tree.literal(2)),
+               scope, {(int64_t)0x8000000000000003, true});
+  expectResult(builder, fC,
+               tree.binary(VObjectType::slBinOp_Percent, tree.param("W"),
+                           tree.literal(2)),
+               scope, {1, true});
+  expectResult(builder, fC,
+               tree.binary(VObjectType::slBinOp_Div, tree.param("W"),
+                           tree.literal(0)),
+               scope, {0, false});
+  expectResult(builder, fC,
+               tree.binary(VObjectType::slBinOp_Plus, tree.param("W"),
+                           tree.literal(2)),
+               scope, {9, true});
+}
+
+TEST(ExprBuilderTest, ValueDivisionsWrapAround) {
+  LValue a, b, result;
+  a.set((uint64_t)INT64_MIN, Value::Type::Integer, 64);
+  b.set((uint64_t)-1, Value::Type::Integer, 64);
+  result.div(&a, &b);
+  EXPECT_TRUE(result.isValid());
+  EXPECT_EQ(result.getValueL(), INT64_MIN);
+  result.mod(&a, &b);
+  EXPECT_TRUE(result.isValid());
+  EXPECT_EQ(result.getValueL(), 0);
+  b.set((uint64_t)0, Value::Type::Integer, 64);
+  result.div(&a, &b);
+  EXPECT_FALSE(result.isValid());
+  // The result can be an operand
+  a.set((uint64_t)-7, Value::Type::Integer, 64);
+  b.set((uint64_t)2, Value::Type::Integer, 64);
+  a.div(&a, &b);
+  EXPECT_TRUE(a.isValid());
+  EXPECT_EQ(a.getValueL(), -3);
+}
+
+TEST(ExprBuilderTest, FoldedResultsMatchTheExpressionValues) {
+  // Two builders share the cache, as the elaboration threads do: the second
+  // one mostly gets the values folded by the first
+  ExprTree tree;
+  std::vector<NodeId> ids;
+  for (unsigned int seed = 0; seed < 50; seed++) {
+    Scope scope;
+    std::mt19937 random(seed);
+    setParams(scope, random);
+    RandomExpr expr(seed);
+    Result expected;
+    ids.push_back(expr.build(tree, scope, 4, expected));
+  }
+  FoldCache cache;
+  ExprBuilder first, second;
+  first.setFoldCache(&cache);
+  second.setFoldCache(&cache);
+  std::mt19937 random(3);
+  std::vector<Scope> scopes(10);
+  for (Scope& scope : scopes) setParams(scope, random);
+  for (unsigned int pass = 0; pass < 2; pass++) {
+    ExprBuilder& builder = pass ? second : first;
+    for (Scope& scope : scopes) {
+      for (unsigned int seed = 0; seed < ids.size(); seed++) {
+        ExprTree check;
+        RandomExpr expr(seed);
+        Result expected;
+        expr.build(check, scope, 4, expected);
+        expectResult(builder, tree.fileContent(), ids[seed], scope, expected);
+      }
+    }
+  }
+}
+
+TEST(ExprBuilderTest, FoldKeysHoldSizesAndValidity) {
+  // Same words, different sizes or validity: the folded values differ
+  ExprTree tree;
+  FileContent* fC = tree.fileContent();
+  NodeId id = tree.binary(VObjectType::slBinOp_BitwAnd, tree.param("A"),
+                          tree.param("B"));
+  Scope narrow, wide, invalid;
+  narrow.setInt("A", 3, 8);
+  narrow.setInt("B", 7, 8);
+  wide.setInt("A", 3, 16);
+  wide.setInt("B", 7, 16);
+  invalid.setInt("A", 3, 8, false);
+  invalid.setInt("B", 7, 8);
+  FoldCache cache;
+  ExprBuilder folding, plain;
+  folding.setFoldCache(&cache);
+  for (unsigned int pass = 0; pass < 2; pass++) {
+    for (Scope* scope : {&narrow, &wide, &invalid}) {
+      Value* folded = folding.evalExpr(fC, id, scope, true);
+      Value* value = plain.evalExpr(fC, id, scope, true);
+      EXPECT_EQ(folded->getSize(), value->getSize());
+      EXPECT_EQ(folded->isValid(), value->isValid());
+      EXPECT_EQ(folded->getValueUL(), value->getValueUL());
+      folding.deleteValue(folded);
+      plain.deleteValue(value);
+    }
+  }
+}
+
+TEST(ExprBuilderTest, UndefinedParametersAreNotFolded) {
+  ExprTree tree;
+  NodeId id = tree.binary(VObjectType::slBinOp_Plus, tree.param("A"),
+                          tree.param("D"));
+  FoldCache cache;
+  ExprBuilder builder;
+  builder.setFoldCache(&cache);
+  Scope scope;
+  scope.setInt("A", 3);
+  expectResult(builder, tree.fileContent(), id, scope, {0, false});
+  scope.setInt("D", 4);
+  expectResult(builder, tree.fileContent(), id, scope, {7, true});
+  scope.setInt("D", 5);
+  expectResult(builder, tree.fileContent(), id, scope, {8, true});
+}
+
+TEST(ExprBuilderTest, ViewsMatchTheAllocatedValues) {
+  // The view of a narrow result is the builder's, folded or not
+  ExprTree tree;
+  FileContent* fC = tree.fileContent();
+  NodeId plus = tree.binary(VObjectType::slBinOp_Plus, tree.param("A"),
+                            tree.param("B"));
+  NodeId div = tree.binary(VObjectType::slBinOp_Div, tree.param("A"),
+                           tree.literal(0));
+  FoldCache cache;
+  ExprBuilder folding, plain;
+  folding.setFoldCache(&cache);
+  Scope scope;
+  scope.setInt("A", 3);
+  scope.setInt("B", 4);
+  for (ExprBuilder* builder : {&plain, &folding}) {
+    for (unsigned int pass = 0; pass < 2; pass++) {
+      Value* view = builder->evalView(fC, plus, &scope, true);
+      Value* value = builder->evalExpr(fC, plus, &scope, true);
+      EXPECT_NE(view, value);
+      EXPECT_EQ(view->getValueL(), 7);
+      EXPECT_EQ(value->getValueL(), 7);
+      builder->deleteValue(value);
+      // The same storage, the previous view is overwritten
+      Value* invalid = builder->evalView(fC, div, &scope, true);
+      EXPECT_EQ(invalid, view);
+      EXPECT_FALSE(invalid->isValid());
+      EXPECT_TRUE(builder->evalView(fC, plus, &scope, true)->isValid());
+    }
+  }
+}
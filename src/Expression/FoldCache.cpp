@@ -0,0 +1,93 @@
+/*
+ Copyright 2026 The Surelog contributors
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+/*
+ * File:   FoldCache.cpp
+ *
+ * Created on October 19, 2026
+ */
+#include "Expression/FoldCache.h"
+
+using namespace SURELOG;
+
+FoldCache::FoldCache() {}
+
+FoldCache::~FoldCache() {
+  for (unsigned int i = 0; i < NbShards; i++) {
+    for (auto& value : m_shards[i].m_values) delete value.second;
+  }
+}
+
+FoldCache::Shard& FoldCache::getShard_(const std::string& key) {
+  return m_shards[std::hash<std::string>()(key) % NbShards];
+}
+
+bool FoldCache::find(const std::string& key, ValueFactory& factory,
+                     Value*& result) {
+  Shard& shard = getShard_(key);
+  shard.m_mutex.lock();
+  auto itr = shard.m_values.find(key);
+  if (itr == shard.m_values.end()) {
+    shard.m_mutex.unlock();
+    return false;
+  }
+  result = factory.newValue(*(*itr).second);
+  shard.m_mutex.unlock();
+  return true;
+}
+
+bool FoldCache::find(const std::string& key, LValue& result) {
+  Shard& shard = getShard_(key);
+  shard.m_mutex.lock();
+  auto itr = shard.m_values.find(key);
+  if (itr == shard.m_values.end()) {
+    shard.m_mutex.unlock();
+    return false;
+  }
+  result.u_plus((*itr).second);
+  shard.m_mutex.unlock();
+  return true;
+}
+
+void FoldCache::insert(const std::string& key, const LValue& value) {
+  Shard& shard = getShard_(key);
+  shard.m_mutex.lock();
+  if (shard.m_values.find(key) == shard.m_values.end())
+    shard.m_values.insert(std::make_pair(key, new LValue(value)));
+  shard.m_mutex.unlock();
+}
+
+void FoldCache::appendValueKey(std::string& key, Value* value) {
+  Value::Type type = value->getType();
+  key.append((const char*)&type, sizeof(type));
+  if (type == Value::Type::String) {
+    std::string str = value->getValueS();
+    unsigned int size = str.size();
+    key.append((const char*)&size, sizeof(size));
+    key += str;
+    return;
+  }
+  unsigned short size = value->getSize();
+  unsigned short nbWords = value->getNbWords();
+  char valid = value->isValid();
+  key.append((const char*)&size, sizeof(size));
+  key.append((const char*)&nbWords, sizeof(nbWords));
+  key += valid;
+  for (unsigned short i = 0; i < nbWords; i++) {
+    uint64_t word = value->getValueUL(i);
+    key.append((const char*)&word, sizeof(word));
+  }
+}
@@ -0,0 +1,70 @@
+/*
+ Copyright 2026 The Surelog contributors
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+/*
+ * File:   FoldCache.h
+ *
+ * Created on October 19, 2026
+ */
+
+#ifndef FOLDCACHE_H
+#define FOLDCACHE_H
+
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include "Expression/Value.h"
+
+namespace SURELOG {
+
+/* Results of constant expressions shared by the ExprBuilders of all the
+   elaboration threads. The key is the expression node and the values of
+   the parameters it reads, so an expression is folded once per distinct
+   set of inputs whatever the instance.
+   Lookups and inserts lock one of NbShards shards selected by the key. */
+class FoldCache {
+ public:
+  FoldCache();
+  virtual ~FoldCache();
+
+  /* On a hit, result is a copy of the folded value allocated by factory */
+  bool find(const std::string& key, ValueFactory& factory, Value*& result);
+  /* On a hit, the folded value is copied into result */
+  bool find(const std::string& key, LValue& result);
+  void insert(const std::string& key, const LValue& value);
+  /* Appends the type, size, validity and words of a value to a key: values
+     printing the same are not the same. Also keys the shared instance
+     bodies of the elaboration */
+  static void appendValueKey(std::string& key, Value* value);
+
+ private:
+  FoldCache(const FoldCache& orig);
+  static const unsigned int NbShards = 16;
+
+  class Shard {
+   public:
+    std::mutex m_mutex;
+    std::unordered_map<std::string, LValue*> m_values;
+  };
+
+  Shard& getShard_(const std::string& key);
+
+  Shard m_shards[NbShards];
+};
+
+};  // namespace SURELOG
+
+#endif /* FOLDCACHE_H */
@@ -0,0 +1,171 @@
+/*
+ Copyright 2026 The Surelog contributors
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+/*
+ * File:   FoldCache_test.cpp
+ *
+ * Created on October 19, 2026
+ */
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Expression/FoldCache.h"
+#include "gtest/gtest.h"
+
+using namespace SURELOG;
+
+namespace {
+
+LValue makeValue(uint64_t value, Value::Type type, unsigned short size,
+                 bool valid = true) {
+  LValue result;
+  result.set(value, type, size);
+  if (!valid) result.setInvalid();
+  return result;
+}
+
+void expectSame(const Value* value, const LValue& expected) {
+  ASSERT_NE(value, nullptr);
+  EXPECT_EQ(value->getType(), expected.getType());
+  EXPECT_EQ(value->getSize(), expected.getSize());
+  EXPECT_EQ(value->isValid(), expected.isValid());
+  EXPECT_EQ(value->getValueUL(), expected.getValueUL());
+}
+
+}  // namespace
+
+TEST(FoldCacheTest, HitsReturnCopies) {
+  FoldCache cache;
+  ValueFactory factory;
+  Value* result = NULL;
+  EXPECT_FALSE(cache.find("a", factory, result));
+
+  LValue value = makeValue(42, Value::Type::Integer, 32);
+  cache.insert("a", value);
+  ASSERT_TRUE(cache.find("a", factory, result));
+  expectSame(result, value);
+  // The caller owns the copy
+  Value* other = NULL;
+  ASSERT_TRUE(cache.find("a", factory, other));
+  EXPECT_NE(result, other);
+  factory.deleteValue(result);
+  factory.deleteValue(other);
+  EXPECT_FALSE(cache.find("b", factory, result));
+}
+
+TEST(FoldCacheTest, InvalidValuesAreKept) {
+  FoldCache cache;
+  ValueFactory factory;
+  LValue value = makeValue(0, Value::Type::Unsigned, 64, false);
+  cache.insert("div0", value);
+  Value* result = NULL;
+  ASSERT_TRUE(cache.find("div0", factory, result));
+  expectSame(result, value);
+  factory.deleteValue(result);
+}
+
+TEST(FoldCacheTest, FirstInsertWins) {
+  // Two threads folding the same expression insert the same value, the
+  // entry is never replaced under a reader
+  FoldCache cache;
+  ValueFactory factory;
+  LValue first = makeValue(1, Value::Type::Integer, 64);
+  cache.insert("k", first);
+  cache.insert("k", makeValue(2, Value::Type::Integer, 64));
+  Value* result = NULL;
+  ASSERT_TRUE(cache.find("k", factory, result));
+  expectSame(result, first);
+  factory.deleteValue(result);
+}
+
+TEST(FoldCacheTest, KeysWithZerosAreDistinct) {
+  // The keys are raw words
+  FoldCache cache;
+  ValueFactory factory;
+  std::string a("\0\1", 2);
+  std::string b("\0\2", 2);
+  cache.insert(a, makeValue(1, Value::Type::Integer, 64));
+  cache.insert(b, makeValue(2, Value::Type::Integer, 64));
+  Value* result = NULL;
+  ASSERT_TRUE(cache.find(a, factory, result));
+  EXPECT_EQ(result->getValueUL(), 1u);
+  factory.deleteValue(result);
+  ASSERT_TRUE(cache.find(b, factory, result));
+  EXPECT_EQ(result->getValueUL(), 2u);
+  factory.deleteValue(result);
+}
+
+TEST(FoldCacheTest, ConcurrentInsertsAndFinds) {
+  FoldCache cache;
+  const unsigned int NbThreads = 8;
+  const unsigned int NbKeys = 2000;
+  std::vector<unsigned int> errors(NbThreads, 0);
+  std::vector<std::thread> threads;
+  for (unsigned int t = 0; t < NbThreads; t++) {
+    threads.push_back(std::thread([&cache, &errors, t, NbKeys]() {
+      ValueFactory factory;
+      for (unsigned int i = 0; i < NbKeys; i++) {
+        // Each thread walks the keys in its own order
+        unsigned int k = (i * (2 * t + 1)) % NbKeys;
+        std::string key = "key" + std::to_string(k);
+        Value* result = NULL;
+        if (cache.find(key, factory, result)) {
+          if (result->getValueUL() != 3 * k) errors[t]++;
+          factory.deleteValue(result);
+        } else {
+          cache.insert(key, makeValue(3 * k, Value::Type::Unsigned, 64));
+        }
+      }
+    }));
+  }
+  for (std::thread& thread : threads) thread.join();
+  for (unsigned int t = 0; t < NbThreads; t++) EXPECT_EQ(errors[t], 0u);
+
+  ValueFactory factory;
+  for (unsigned int k = 0; k < NbKeys; k++) {
+    Value* result = NULL;
+    ASSERT_TRUE(cache.find("key" + std::to_string(k), factory, result));
+    EXPECT_EQ(result->getValueUL(), 3 * k);
+    factory.deleteValue(result);
+  }
+}
+
+TEST(FoldCacheTest, ValueKeys) {
+  // Equal values have equal keys, values with the same words but another
+  // type, size or validity do not
+  auto keyOf = [](const LValue& value) {
+    std::string key;
+    FoldCache::appendValueKey(key, (Value*)&value);
+    return key;
+  };
+  LValue value = makeValue(5, Value::Type::Integer, 32);
+  EXPECT_EQ(keyOf(value), keyOf(makeValue(5, Value::Type::Integer, 32)));
+  EXPECT_NE(keyOf(value), keyOf(makeValue(6, Value::Type::Integer, 32)));
+  EXPECT_NE(keyOf(value), keyOf(makeValue(5, Value::Type::Unsigned, 32)));
+  EXPECT_NE(keyOf(value), keyOf(makeValue(5, Value::Type::Integer, 64)));
+  EXPECT_NE(keyOf(value),
+            keyOf(makeValue(5, Value::Type::Integer, 32, false)));
+
+  StValue a("ab");
+  StValue b("abc");
+  std::string keyA;
+  std::string keyB;
+  FoldCache::appendValueKey(keyA, &a);
+  FoldCache::appendValueKey(keyB, &b);
+  EXPECT_NE(keyA, keyB);
+}
@@ -24,6 +24,7 @@
 #include <cmath>
 #include <cstdint>
 #include <cstring>
+#include <vector>
 #include "Expression/Value.h"
 #include <math.h>    
 using namespace SURELOG;
@@ -96,10 +97,13 @@ Value* ValueFactory::newValue(LValue& initVal) {
     }
     ret->m_prev = nullptr;
     ret->m_next = nullptr;
-    ret->adjust(&initVal);
+    ret->m_type = initVal.m_type;
+    ret->resize_(initVal.m_nbWords);
     for (unsigned int i = 0; i < ret->m_nbWords; i++) {
       ret->m_valueArray[i] = initVal.m_valueArray[i];
     }
+    ret->m_size = initVal.m_size;
+    ret->m_valid = initVal.m_valid;
 
     return ret;
   }
@@ -336,14 +340,6 @@ void SValue::shiftRight(const Value* a, const Value* b) {
   m_valid = a->isValid() && b->isValid();
 }
 
-unsigned short LValue::getSize() const {
-  unsigned short size = 0;
-  for (int i = 0; i < m_nbWords; i++) {
-    size += m_valueArray[i].m_size;
-  }
-  return size;
-}
-
 std::string LValue::uhdmValue() {
   std::string result = "INT:";
   if (m_type == Type::Binary)
@@ -357,14 +353,14 @@ std::string LValue::uhdmValue() {
   else if (m_type == Type::Scalar)
     result = "SCAL:";  
   for (int i = 0; i < m_nbWords; i++) {
-    result += std::to_string(m_valueArray[i].m_value);
+    result += std::to_string(m_valueArray[i]);
   }
   return result;
 }
 
 LValue::LValue(const LValue& val)
-  : m_type(val.m_type), m_nbWords(val.m_nbWords),
-    m_valueArray(new SValue[val.m_nbWords]),
+  : m_type(val.m_type), m_nbWords(val.m_nbWords), m_capacity(val.m_nbWords),
+    m_size(val.m_size), m_valueArray(new uint64_t[val.m_nbWords]),
     m_valid(val.isValid()),
     m_prev(nullptr), m_next(nullptr) {
   for (int i = 0; i < val.m_nbWords; i++) {
@@ -372,320 +368,521 @@ LValue::LValue(const LValue& val)
   }
 }
 
+LValue::LValue(Type type, const uint64_t* words, unsigned short nbWords,
+               unsigned short size)
+  : m_type(type), m_nbWords(nbWords), m_capacity(nbWords), m_size(size),
+    m_valueArray(new uint64_t[nbWords]), m_valid(1),
+    m_prev(nullptr), m_next(nullptr) {
+  for (int i = 0; i < nbWords; i++) {
+    m_valueArray[i] = words[i];
+  }
+}
+
 LValue::LValue(uint64_t val)
-  : m_type(Type::Unsigned), m_nbWords(1),
-    m_valueArray(new SValue[1]), m_valid(1), m_prev(nullptr), m_next(nullptr) {
-  m_valueArray[0].m_value = val;
-  m_valueArray[0].m_size = 64;
-  m_valid = 1;
+  : m_type(Type::Unsigned), m_nbWords(1), m_capacity(1), m_size(64),
+    m_valueArray(new uint64_t[1]), m_valid(1), m_prev(nullptr), m_next(nullptr) {
+  m_valueArray[0] = val;
 }
 
 LValue::LValue(int64_t val)
-  : m_type(Type::Integer), m_nbWords(1), m_valueArray(new SValue[1]), m_valid(1),
-    m_prev(nullptr), m_next(nullptr) {
-  m_valueArray[0].m_value = (uint64_t)val;
-  m_valueArray[0].m_size = 64;
-  m_valid = 1;
+  : m_type(Type::Integer), m_nbWords(1), m_capacity(1), m_size(64),
+    m_valueArray(new uint64_t[1]), m_valid(1), m_prev(nullptr), m_next(nullptr) {
+  m_valueArray[0] = (uint64_t)val;
 }
 
 LValue::LValue(double val)
-  : m_type(Type::Double), m_nbWords(1), m_valueArray(new SValue[1]), m_valid(1),
-    m_prev(nullptr), m_next(nullptr) {
-  m_valueArray[0].m_value = (uint64_t)val;
-  m_valueArray[0].m_size = 64;
-  m_valid = 1;
+  : m_type(Type::Double), m_nbWords(1), m_capacity(1), m_size(64),
+    m_valueArray(new uint64_t[1]), m_valid(1), m_prev(nullptr), m_next(nullptr) {
+  m_valueArray[0] = (uint64_t)val;
 }
 
 LValue::LValue(uint64_t val, Type type, unsigned short size)
-  : m_type(type), m_nbWords(1), m_valueArray(new SValue[1]), m_valid(1),
-    m_prev(nullptr), m_next(nullptr) {
-  m_valueArray[0].m_value = val;
-  m_valueArray[0].m_size = size;
-  m_valid = 1;
+  : m_type(type), m_nbWords(1), m_capacity(1), m_size(size),
+    m_valueArray(new uint64_t[1]), m_valid(1), m_prev(nullptr), m_next(nullptr) {
+  m_valueArray[0] = val;
+}
+
+void LValue::resize_(unsigned short nbWords) {
+  if (nbWords > m_capacity) {
+    uint64_t* words = new uint64_t[nbWords];
+    for (unsigned short i = 0; i < m_nbWords; i++) words[i] = m_valueArray[i];
+    for (unsigned short i = m_nbWords; i < nbWords; i++) words[i] = 0;
+    delete[] m_valueArray;
+    m_valueArray = words;
+    m_capacity = nbWords;
+  } else {
+    for (unsigned short i = m_nbWords; i < nbWords; i++) m_valueArray[i] = 0;
+  }
+  m_nbWords = nbWords;
+}
+
+const uint64_t* LValue::words_(const Value* a, uint64_t& word,
+                               unsigned short& nbWords) {
+  if (a->isLValue()) {
+    const LValue* la = (const LValue*)a;
+    nbWords = la->m_nbWords;
+    return la->m_valueArray;
+  }
+  word = a->getValueUL(0);
+  nbWords = 1;
+  return &word;
+}
+
+bool LValue::binary_(const Value* a, const Value* b, unsigned short nbWords) {
+  m_type = b->getType();
+  m_valid = a->isValid() && b->isValid();
+  if (!m_valid) return false;
+  unsigned short sizeA = a->getSize();
+  unsigned short sizeB = b->getSize();
+  m_size = (sizeA > sizeB) ? sizeA : sizeB;
+  resize_(nbWords);
+  return true;
 }
 
 void LValue::set(uint64_t val) {
   m_type = Type::Unsigned;
-  m_nbWords = 1;
-  if (!m_valueArray) m_valueArray = new SValue[1];
-  m_valueArray[0].m_value = val;
-  m_valueArray[0].m_size = 64;
+  resize_(1);
+  m_valueArray[0] = val;
+  m_size = 64;
   m_valid = 1;
 }
 
 void LValue::set(int64_t val) {
   m_type = Type::Integer;
-  m_nbWords = 1;
-  if (!m_valueArray) m_valueArray = new SValue[1];
-  m_valueArray[0].m_value = (uint64_t)val;
-  m_valueArray[0].m_size = 64;
+  resize_(1);
+  m_valueArray[0] = (uint64_t)val;
+  m_size = 64;
   m_valid = 1;
 }
 
 void LValue::set(double val) {
   m_type = Type::Double;
-  m_nbWords = 1;
-  if (!m_valueArray) m_valueArray = new SValue[1];
-  m_valueArray[0].m_value = (uint64_t)val;
-  m_valueArray[0].m_size = 64;
+  resize_(1);
+  m_valueArray[0] = (uint64_t)val;
+  m_size = 64;
   m_valid = 1;
 }
 
 void LValue::set(uint64_t val, Type type, unsigned short size) {
   m_type = type;
-  m_nbWords = 1;
-  if (!m_valueArray) m_valueArray = new SValue[1];
-  m_valueArray[0].m_value = val;
-  m_valueArray[0].m_size = size;
+  resize_(1);
+  m_valueArray[0] = val;
+  m_size = size;
   m_valid = 1;
 }
 
 void LValue::adjust(const Value* a) {
   m_type = a->getType();
   if (a->getNbWords() > getNbWords()) {
-    if (m_valueArray) delete[] m_valueArray;
-    m_nbWords = a->getNbWords();
-    m_valueArray = new SValue[m_nbWords];
+    resize_(a->getNbWords());
   }
 }
 
+/* Multi-word values are packed words, least significant first. Words past
+   the end of an operand read as 0. The bitwise loops only index plain
+   arrays so that the compiler can vectorize them. */
+
 void LValue::u_plus(const Value* a) {
-  adjust(a);
-  for (unsigned int i = 0; i < m_nbWords; i++) {
-    m_valueArray[i].m_value = a->getValueUL(i);
-  }
+  m_type = a->getType();
   m_valid = a->isValid();
+  m_size = a->getSize();
+  uint64_t word;
+  unsigned short n;
+  const uint64_t* aw = words_(a, word, n);
+  resize_(n);
+  aw = words_(a, word, n);
+  for (unsigned short i = 0; i < n; i++) m_valueArray[i] = aw[i];
 }
 
-void LValue::incr() { m_valueArray[0].m_value++; }
-
-void LValue::decr() { m_valueArray[0].m_value--; }
+void LValue::incr() {
+  for (unsigned short i = 0; i < m_nbWords; i++) {
+    if (++m_valueArray[i] != 0) break;
+  }
+}
 
-void LValue::u_minus(const Value* a) {
-  adjust(a);
+void LValue::decr() {
   for (unsigned short i = 0; i < m_nbWords; i++) {
-    m_valueArray[i].m_value = a->getValueUL(i);
-    if (i == (m_nbWords - 1)) {
-      m_valueArray[i].m_value = ~m_valueArray[i].m_value + 1;
-    }
+    if (m_valueArray[i]-- != 0) break;
   }
-  m_valid = a->isValid();
+}
+
+void LValue::u_minus(const Value* a) {
+  u_plus(a);
+  for (unsigned short i = 0; i < m_nbWords; i++)
+    m_valueArray[i] = ~m_valueArray[i];
+  incr();
 }
 
 void LValue::u_not(const Value* a) {
-  adjust(a);
+  m_type = a->getType();
   m_valid = a->isValid();
+  m_size = a->getSize();
   if (!m_valid)
     return;
-  for (unsigned int i = 0; i < m_nbWords; i++) {
-    m_valueArray[0].m_value |= a->getValueUL(i);
-  }
-  m_valueArray[0].m_value = !m_valueArray[0].m_value;
+  uint64_t word;
+  unsigned short n;
+  const uint64_t* aw = words_(a, word, n);
+  uint64_t any = 0;
+  for (unsigned short i = 0; i < n; i++) any |= aw[i];
+  resize_(n ? n : 1);
+  for (unsigned short i = 1; i < m_nbWords; i++) m_valueArray[i] = 0;
+  m_valueArray[0] = !any;
 }
 
 void LValue::u_tilda(const Value* a) {
-  adjust(a);
-  m_valid = a->isValid();
+  u_plus(a);
   if (!m_valid)
     return;
-  for (unsigned int i = 0; i < m_nbWords; i++) {
-    m_valueArray[i].m_value = ~a->getValueUL(i);
-  }
+  for (unsigned short i = 0; i < m_nbWords; i++)
+    m_valueArray[i] = ~m_valueArray[i];
 }
 
+#define LVALUE_OPERANDS(a, b)                                \
+  uint64_t wordA, wordB;                                     \
+  unsigned short nA, nB;                                     \
+  words_(a, wordA, nA);                                      \
+  words_(b, wordB, nB);                                      \
+  unsigned short n = (nA > nB) ? nA : nB;                    \
+  if (!binary_(a, b, n ? n : 1)) return;                     \
+  n = m_nbWords;                                             \
+  const uint64_t* aw = words_(a, wordA, nA);                 \
+  const uint64_t* bw = words_(b, wordB, nB);
+
 void LValue::plus(const Value* a, const Value* b) {
-  adjust(a);
-  adjust(b);
-  m_valid = a->isValid() && b->isValid();
-  if (!m_valid)
-    return;
-  m_valueArray[0].m_value = a->getValueL(0) + b->getValueL(0);
+  LVALUE_OPERANDS(a, b)
+  uint64_t carry = 0;
+  for (unsigned short i = 0; i < n; i++) {
+    uint64_t x = (i < nA) ? aw[i] : 0;
+    uint64_t y = (i < nB) ? bw[i] : 0;
+    uint64_t sum = x + y;
+    uint64_t c = (sum < x);
+    sum += carry;
+    c |= (sum < carry);
+    m_valueArray[i] = sum;
+    carry = c;
+  }
 }
 
 void LValue::minus(const Value* a, const Value* b) {
-  adjust(a);
-  adjust(b);
-  m_valid = a->isValid() && b->isValid();
-  if (!m_valid)
-    return;
-  m_valueArray[0].m_value = a->getValueL(0) - b->getValueL(0);
+  LVALUE_OPERANDS(a, b)
+  uint64_t borrow = 0;
+  for (unsigned short i = 0; i < n; i++) {
+    uint64_t x = (i < nA) ? aw[i] : 0;
+    uint64_t y = (i < nB) ? bw[i] : 0;
+    uint64_t diff = x - y;
+    uint64_t c = (x < y);
+    c |= (diff < borrow);
+    m_valueArray[i] = diff - borrow;
+    borrow = c;
+  }
+}
+
+// 64x64 -> 128 bits product, in 32 bits halves to stay portable
+static void mult64(uint64_t x, uint64_t y, uint64_t& lo, uint64_t& hi) {
+  uint64_t x0 = x & 0xFFFFFFFF, x1 = x >> 32;
+  uint64_t y0 = y & 0xFFFFFFFF, y1 = y >> 32;
+  uint64_t p00 = x0 * y0, p01 = x0 * y1, p10 = x1 * y0, p11 = x1 * y1;
+  uint64_t mid = (p00 >> 32) + (p01 & 0xFFFFFFFF) + (p10 & 0xFFFFFFFF);
+  lo = (p00 & 0xFFFFFFFF) | (mid << 32);
+  hi = p11 + (p01 >> 32) + (p10 >> 32) + (mid >> 32);
 }
 
 void LValue::mult(const Value* a, const Value* b) {
-  adjust(a);
-  adjust(b);
-  m_valid = a->isValid() && b->isValid();
-  if (!m_valid)
+  LVALUE_OPERANDS(a, b)
+  if (n == 1) {
+    m_valueArray[0] = aw[0] * bw[0];
     return;
-  m_valueArray[0].m_value = a->getValueL(0) * b->getValueL(0);
+  }
+  // Truncated to the widest operand
+  uint64_t* product = new uint64_t[n];
+  for (unsigned short i = 0; i < n; i++) product[i] = 0;
+  for (unsigned short i = 0; i < nA; i++) {
+    uint64_t carry = 0;
+    for (unsigned short j = 0; (j < nB) && (i + j < n); j++) {
+      uint64_t lo, hi;
+      mult64(aw[i], bw[j], lo, hi);
+      uint64_t sum = product[i + j] + lo;
+      hi += (sum < product[i + j]);
+      sum += carry;
+      hi += (sum < carry);
+      product[i + j] = sum;
+      carry = hi;
+    }
+    if (i + nB < n) product[i + nB] += carry;
+  }
+  for (unsigned short i = 0; i < n; i++) m_valueArray[i] = product[i];
+  delete[] product;
+}
+
+// Signed division of single words, false on a division by zero
+static bool divide(uint64_t x, uint64_t y, bool modulo, uint64_t& result) {
+  int64_t sx = (int64_t)x;
+  int64_t sy = (int64_t)y;
+  result = 0;
+  if (sy == 0) return false;
+  // INT64_MIN / -1 overflows, the quotient wraps around
+  if (sy == -1) {
+    if (!modulo) result = ~x + 1;
+    return true;
+  }
+  result = modulo ? (uint64_t)(sx % sy) : (uint64_t)(sx / sy);
+  return true;
 }
 
-void LValue::div(const Value* a, const Value* b) {
-  adjust(a);
-  adjust(b);
-  m_valid = a->isValid() && b->isValid();
-  if (!m_valid)
-    return;
-  if (b->getValueL(0))
-    m_valueArray[0].m_value = a->getValueL(0) / b->getValueL(0);
-  else {
-    m_valueArray[0].m_value = 0;
-    m_valid = 0;
+// Unsigned long division of multi-word values, false on a division by zero.
+// Knuth's algorithm D on 32 bits digits, so that a digit product and a two
+// digits dividend fit in a word. The n words of result are the quotient, or
+// the remainder when modulo, and can be the operands.
+static bool divideWords(const uint64_t* aw, unsigned short nA,
+                        const uint64_t* bw, unsigned short nB,
+                        unsigned short n, bool modulo, uint64_t* result) {
+  std::vector<uint32_t> u;
+  std::vector<uint32_t> v;
+  for (unsigned short i = 0; i < nA; i++) {
+    u.push_back((uint32_t)aw[i]);
+    u.push_back((uint32_t)(aw[i] >> 32));
   }
+  for (unsigned short i = 0; i < nB; i++) {
+    v.push_back((uint32_t)bw[i]);
+    v.push_back((uint32_t)(bw[i] >> 32));
+  }
+  while (!u.empty() && u.back() == 0) u.pop_back();
+  while (!v.empty() && v.back() == 0) v.pop_back();
+  for (unsigned short i = 0; i < n; i++) result[i] = 0;
+  if (v.empty()) return false;
+  size_t nu = u.size();
+  size_t nv = v.size();
+  std::vector<uint32_t> q;
+  std::vector<uint32_t> r;
+  if (nu < nv) {
+    r = u;
+  } else if (nv == 1) {
+    q.resize(nu);
+    uint64_t rem = 0;
+    for (size_t j = nu; j > 0; j--) {
+      uint64_t num = (rem << 32) | u[j - 1];
+      q[j - 1] = (uint32_t)(num / v[0]);
+      rem = num % v[0];
+    }
+    r.push_back((uint32_t)rem);
+  } else {
+    // Normalized so that the top digit of the divisor has its high bit set,
+    // the estimated quotient digit is then at most 2 too large
+    unsigned int s = 0;
+    while (!((v[nv - 1] << s) & 0x80000000)) s++;
+    std::vector<uint32_t> vn(nv);
+    std::vector<uint32_t> un(nu + 1);
+    for (size_t i = nv - 1; i > 0; i--)
+      vn[i] = (v[i] << s) | (s ? v[i - 1] >> (32 - s) : 0);
+    vn[0] = v[0] << s;
+    un[nu] = s ? u[nu - 1] >> (32 - s) : 0;
+    for (size_t i = nu - 1; i > 0; i--)
+      un[i] = (u[i] << s) | (s ? u[i - 1] >> (32 - s) : 0);
+    un[0] = u[0] << s;
+    q.resize(nu - nv + 1);
+    for (size_t j = nu - nv + 1; j > 0; j--) {
+      size_t k = j - 1;
+      uint64_t num = ((uint64_t)un[k + nv] << 32) | un[k + nv - 1];
+      uint64_t qhat = num / vn[nv - 1];
+      uint64_t rhat = num % vn[nv - 1];
+      while ((qhat >> 32) ||
+             (qhat * vn[nv - 2] > ((rhat << 32) | un[k + nv - 2]))) {
+        qhat--;
+        rhat += vn[nv - 1];
+        if (rhat >> 32) break;
+      }
+      // Multiply and subtract
+      int64_t borrow = 0;
+      int64_t t;
+      for (size_t i = 0; i < nv; i++) {
+        uint64_t p = qhat * vn[i];
+        t = (int64_t)un[i + k] - borrow - (int64_t)(p & 0xFFFFFFFF);
+        un[i + k] = (uint32_t)t;
+        borrow = (int64_t)(p >> 32) - (t >> 32);
+      }
+      t = (int64_t)un[k + nv] - borrow;
+      un[k + nv] = (uint32_t)t;
+      q[k] = (uint32_t)qhat;
+      if (t < 0) {
+        // The estimate was one too large, add the divisor back
+        q[k]--;
+        uint64_t carry = 0;
+        for (size_t i = 0; i < nv; i++) {
+          uint64_t sum = (uint64_t)un[i + k] + vn[i] + carry;
+          un[i + k] = (uint32_t)sum;
+          carry = sum >> 32;
+        }
+        un[k + nv] += (uint32_t)carry;
+      }
+    }
+    r.resize(nv);
+    for (size_t i = 0; i < nv; i++)
+      r[i] = (un[i] >> s) | (s ? un[i + 1] << (32 - s) : 0);
+  }
+  // The quotient and the remainder are not wider than the operands
+  const std::vector<uint32_t>& digits = modulo ? r : q;
+  for (size_t i = 0; i < digits.size(); i++)
+    result[i / 2] |= (uint64_t)digits[i] << (32 * (i % 2));
+  return true;
+}
+
+// Single words divide signed, wider values unsigned as they compare
+#define LVALUE_DIVIDE(a, b, modulo)                                   \
+  LVALUE_OPERANDS(a, b)                                               \
+  bool divided;                                                       \
+  if (n == 1) {                                                       \
+    uint64_t x = nA ? aw[0] : 0;                                      \
+    uint64_t y = nB ? bw[0] : 0;                                      \
+    divided = divide(x, y, modulo, m_valueArray[0]);                  \
+  } else {                                                            \
+    divided = divideWords(aw, nA, bw, nB, n, modulo, m_valueArray);   \
+  }                                                                   \
+  if (!divided) m_valid = 0;
+
+void LValue::div(const Value* a, const Value* b) {
+  LVALUE_DIVIDE(a, b, false)
 }
 
 void LValue::mod(const Value* a, const Value* b) {
-  adjust(a);
-  adjust(b);
-  m_valid = a->isValid() && b->isValid();
-  if (!m_valid)
-    return;
-  m_valueArray[0].m_value = a->getValueL(0) % b->getValueL(0);
+  LVALUE_DIVIDE(a, b, true)
 }
 
+// -1, 0 or 1. Single words compare signed, wider values unsigned.
+static int compare(const uint64_t* aw, unsigned short nA, const uint64_t* bw,
+                   unsigned short nB) {
+  if (nA <= 1 && nB <= 1) {
+    int64_t x = nA ? (int64_t)aw[0] : 0;
+    int64_t y = nB ? (int64_t)bw[0] : 0;
+    return (x < y) ? -1 : ((x > y) ? 1 : 0);
+  }
+  unsigned short n = (nA > nB) ? nA : nB;
+  for (unsigned short i = n; i > 0; i--) {
+    uint64_t x = (i - 1 < nA) ? aw[i - 1] : 0;
+    uint64_t y = (i - 1 < nB) ? bw[i - 1] : 0;
+    if (x != y) return (x < y) ? -1 : 1;
+  }
+  return 0;
+}
+
+#define LVALUE_COMPARE(a, b, test)                           \
+  LVALUE_OPERANDS(a, b)                                      \
+  int cmp = compare(aw, nA, bw, nB);                         \
+  for (unsigned short i = 1; i < n; i++) m_valueArray[i] = 0; \
+  m_valueArray[0] = (test);
+
 void LValue::greater(const Value* a, const Value* b) {
-  adjust(a);
-  adjust(b);
-  m_valid = a->isValid() && b->isValid();
-  if (!m_valid)
-    return;
-  m_valueArray[0].m_value = a->getValueL(0) > b->getValueL(0);
+  LVALUE_COMPARE(a, b, cmp > 0)
 }
 
 void LValue::greater_equal(const Value* a, const Value* b) {
-  adjust(a);
-  adjust(b);
-  m_valid = a->isValid() && b->isValid();
-  if (!m_valid)
-    return;
-  m_valueArray[0].m_value = a->getValueL(0) >= b->getValueL(0);
+  LVALUE_COMPARE(a, b, cmp >= 0)
 }
 
 void LValue::lesser(const Value* a, const Value* b) {
-  adjust(a);
-  adjust(b);
-  m_valid = a->isValid() && b->isValid();
-  if (!m_valid)
-    return;
-  m_valueArray[0].m_value = a->getValueL(0) < b->getValueL(0);
+  LVALUE_COMPARE(a, b, cmp < 0)
 }
 
 void LValue::lesser_equal(const Value* a, const Value* b) {
-  adjust(a);
-  adjust(b);
-  m_valid = a->isValid() && b->isValid();
-  if (!m_valid)
-    return;
-  m_valueArray[0].m_value = a->getValueL(0) <= b->getValueL(0);
+  LVALUE_COMPARE(a, b, cmp <= 0)
 }
 
 void LValue::equiv(const Value* a, const Value* b) {
-  adjust(a);
-  adjust(b);
-  m_valid = a->isValid() && b->isValid();
-  if (!m_valid)
-    return;
-  for (unsigned int i = 0; i < m_nbWords; i++) {
-    if (a->getValueUL(i) != b->getValueUL(i)) {
-      m_valueArray[0].m_value = 0;
-      return;
-    }
-  }
-  m_valueArray[0].m_value = 1;
+  LVALUE_COMPARE(a, b, cmp == 0)
+}
+
+void LValue::notEqual(const Value* a, const Value* b) {
+  LVALUE_COMPARE(a, b, cmp != 0)
 }
 
 void LValue::logAnd(const Value* a, const Value* b) {
-  adjust(a);
-  adjust(b);
-  m_valid = a->isValid() && b->isValid();
-  if (!m_valid)
-    return;
+  LVALUE_OPERANDS(a, b)
   uint64_t tmp1 = 0;
   uint64_t tmp2 = 0;
-  for (unsigned int i = 0; i < m_nbWords; i++) {
-    tmp1 |= a->getValueUL(i);
-    tmp2 |= b->getValueUL(i);
-  }
-  m_valueArray[0].m_value = tmp1 && tmp2;
+  for (unsigned short i = 0; i < nA; i++) tmp1 |= aw[i];
+  for (unsigned short i = 0; i < nB; i++) tmp2 |= bw[i];
+  for (unsigned short i = 1; i < n; i++) m_valueArray[i] = 0;
+  m_valueArray[0] = tmp1 && tmp2;
 }
 
 void LValue::logOr(const Value* a, const Value* b) {
-  adjust(a);
-  adjust(b);
-  m_valid = a->isValid() && b->isValid();
-  if (!m_valid)
-    return;
+  LVALUE_OPERANDS(a, b)
   uint64_t tmp1 = 0;
   uint64_t tmp2 = 0;
-  for (unsigned int i = 0; i < m_nbWords; i++) {
-    tmp1 |= a->getValueUL(i);
-    tmp2 |= b->getValueUL(i);
-  }
-  m_valueArray[0].m_value = tmp1 || tmp2;
+  for (unsigned short i = 0; i < nA; i++) tmp1 |= aw[i];
+  for (unsigned short i = 0; i < nB; i++) tmp2 |= bw[i];
+  for (unsigned short i = 1; i < n; i++) m_valueArray[i] = 0;
+  m_valueArray[0] = tmp1 || tmp2;
 }
 
+#define LVALUE_BITWISE(a, b, op)                                          \
+  LVALUE_OPERANDS(a, b)                                                   \
+  unsigned short common = (nA < nB) ? nA : nB;                            \
+  uint64_t* r = m_valueArray;                                             \
+  for (unsigned short i = 0; i < common; i++) r[i] = aw[i] op bw[i];      \
+  for (unsigned short i = common; i < nA; i++) r[i] = aw[i] op 0;         \
+  for (unsigned short i = common; i < nB; i++) r[i] = 0 op bw[i];
+
 void LValue::bitwAnd(const Value* a, const Value* b) {
-  adjust(a);
-  adjust(b);
-  m_valid = a->isValid() && b->isValid();
-  if (!m_valid)
-    return;
-  for (unsigned int i = 0; i < m_nbWords; i++) {
-    m_valueArray[i].m_value = a->getValueUL(i) & b->getValueUL(i);
-  }
+  LVALUE_BITWISE(a, b, &)
 }
 
 void LValue::bitwOr(const Value* a, const Value* b) {
-  adjust(a);
-  adjust(b);
-  m_valid = a->isValid() && b->isValid();
-  if (!m_valid)
-    return;
-  for (unsigned int i = 0; i < m_nbWords; i++) {
-    m_valueArray[i].m_value = a->getValueUL(i) | b->getValueUL(i);
-  }
+  LVALUE_BITWISE(a, b, |)
 }
 
 void LValue::bitwXor(const Value* a, const Value* b) {
-  adjust(a);
-  adjust(b);
-  m_valid = a->isValid() && b->isValid();
-  if (!m_valid)
-    return;
-  for (unsigned int i = 0; i < m_nbWords; i++) {
-    m_valueArray[i].m_value = a->getValueUL(i) ^ b->getValueUL(i);
-  }
+  LVALUE_BITWISE(a, b, ^)
 }
 
-void LValue::notEqual(const Value* a, const Value* b) {
-  adjust(a);
-  adjust(b);
-  m_valid = a->isValid() && b->isValid();
-  if (!m_valid)
-    return;
-  equiv(a, b);
-  m_valueArray[0].m_value = !m_valueArray[0].m_value;
+// Shift amount in bits, saturated past the width of the value
+static uint64_t shiftAmount(const uint64_t* bw, unsigned short nB,
+                            unsigned short n) {
+  for (unsigned short i = 1; i < nB; i++) {
+    if (bw[i]) return 64 * (uint64_t)n;
+  }
+  return nB ? bw[0] : 0;
 }
 
 void LValue::shiftLeft(const Value* a, const Value* b) {
-  adjust(a);
-  adjust(b);
-  m_valid = a->isValid() && b->isValid();
-  if (!m_valid)
-    return;
-  m_valueArray[0].m_value = a->getValueUL(0) << b->getValueUL(0);
+  LVALUE_OPERANDS(a, b)
+  uint64_t shift = shiftAmount(bw, nB, n);
+  unsigned int ws = (shift >= 64 * (uint64_t)n) ? n : (unsigned int)(shift / 64);
+  unsigned int bs = shift % 64;
+  // Descending, so that the operand can be the result
+  for (unsigned int i = n; i > 0; i--) {
+    unsigned int k = i - 1;
+    uint64_t word = 0;
+    if (k >= ws) {
+      uint64_t x = (k - ws < nA) ? aw[k - ws] : 0;
+      word = x << bs;
+      if (bs && (k > ws)) {
+        uint64_t y = (k - ws - 1 < nA) ? aw[k - ws - 1] : 0;
+        word |= y >> (64 - bs);
+      }
+    }
+    m_valueArray[k] = word;
+  }
 }
 
 void LValue::shiftRight(const Value* a, const Value* b) {
-  adjust(a);
-  adjust(b);
-  m_valid = a->isValid() && b->isValid();
-  if (!m_valid)
-    return;
-  m_valueArray[0].m_value = a->getValueUL(0) >> b->getValueUL(0);
+  LVALUE_OPERANDS(a, b)
+  uint64_t shift = shiftAmount(bw, nB, n);
+  unsigned int ws = (shift >= 64 * (uint64_t)n) ? n : (unsigned int)(shift / 64);
+  unsigned int bs = shift % 64;
+  for (unsigned int k = 0; k < n; k++) {
+    uint64_t word = 0;
+    if (k + ws < n) {
+      uint64_t x = (k + ws < nA) ? aw[k + ws] : 0;
+      word = x >> bs;
+      if (bs && (k + ws + 1 < n)) {
+        uint64_t y = (k + ws + 1 < nA) ? aw[k + ws + 1] : 0;
+        word |= y << (64 - bs);
+      }
+    }
+    m_valueArray[k] = word;
+  }
 }
 
-
 std::string StValue::uhdmValue() {
   std::string result = "STRING:";
   if (m_type == Type::Binary)
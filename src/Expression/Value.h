@@ -219,16 +219,17 @@ class LValue : public Value {
 
  public:
   LValue(const LValue&);
-  LValue() : m_type(Type::None), m_nbWords(0), m_valueArray(nullptr), m_valid(1) {}
-  LValue(Type type, SValue* values, unsigned short nbWords)
-    : m_type(type), m_nbWords(nbWords), m_valueArray(values), m_valid(1) {}
+  LValue() : m_type(Type::None), m_nbWords(0), m_capacity(0), m_size(0),
+             m_valueArray(nullptr), m_valid(1) {}
+  LValue(Type type, const uint64_t* words, unsigned short nbWords,
+         unsigned short size);
   LValue(uint64_t val);
   LValue(int64_t val);
   LValue(double val);
   LValue(uint64_t val, Type type, unsigned short size);
   ~LValue() final;
 
-  unsigned short getSize() const final;
+  unsigned short getSize() const final { return m_size; }
   unsigned short getNbWords() const final { return m_nbWords; }
   bool isLValue() const final { return true; }
   Type getType() const final { return m_type; }
@@ -244,13 +245,13 @@ class LValue : public Value {
   bool operator==(const Value& rhs) const final;
 
   uint64_t getValueUL(unsigned short index = 0) const final {
-    return ((index < m_nbWords) ? m_valueArray[index].m_value : 0);
+    return ((index < m_nbWords) ? m_valueArray[index] : 0);
   }
   int64_t getValueL(unsigned short index = 0) const final {
-    return ((index < m_nbWords) ? (int64_t)m_valueArray[index].m_value : 0);
+    return ((index < m_nbWords) ? (int64_t)m_valueArray[index] : 0);
   }
   double getValueD(unsigned short index = 0) const final {
-    return ((index < m_nbWords) ? (double)m_valueArray[index].m_value : 0);
+    return ((index < m_nbWords) ? (double)m_valueArray[index] : 0);
   }
   std::string getValueS() const final { return "NOT_A_STRING_VALUE"; }
 
@@ -284,9 +285,17 @@ class LValue : public Value {
   void adjust(const Value* a);
 
  private:
+  void resize_(unsigned short nbWords);
+  bool binary_(const Value* a, const Value* b, unsigned short nbWords);
+  static const uint64_t* words_(const Value* a, uint64_t& word,
+                                unsigned short& nbWords);
+
   Type m_type;
   unsigned short m_nbWords;
-  SValue* m_valueArray;
+  unsigned short m_capacity;
+  unsigned short m_size;
+  // Packed 64 bits words, least significant first
+  uint64_t* m_valueArray;
   unsigned short m_valid;
   LValue* m_prev;
   LValue* m_next;
@@ -0,0 +1,205 @@
+/*
+ Copyright 2026 The Surelog contributors
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+/*
+ * File:   Value_test.cpp
+ *
+ * Created on October 19, 2026
+ */
+
+#include <random>
+
+#include "Expression/Value.h"
+#include "gtest/gtest.h"
+
+using namespace SURELOG;
+
+namespace {
+
+typedef unsigned __int128 uint128;
+
+/* Operands of edge and random 32 bits digits, so that the long division
+   meets short divisors, normalized divisors and corrected estimates */
+class Operands {
+ public:
+  explicit Operands(unsigned int seed) : m_random(seed) {}
+
+  uint64_t word() { return digit() | ((uint64_t)digit() << 32); }
+
+  uint128 wide() {
+    uint128 value = 0;
+    unsigned int nbDigits = m_random() % 5;
+    for (unsigned int i = 0; i < nbDigits; i++)
+      value = (value << 32) | digit();
+    return value;
+  }
+
+ private:
+  uint32_t digit() {
+    static const uint32_t Edges[] = {0, 1, 2, 0x7FFFFFFF, 0x80000000,
+                                     0xFFFFFFFE, 0xFFFFFFFF};
+    unsigned int pick = m_random() % 10;
+    if (pick < 7) return Edges[pick];
+    return (uint32_t)m_random();
+  }
+
+  std::mt19937_64 m_random;
+};
+
+void setWide(LValue& value, uint128 x) {
+  uint64_t words[2] = {(uint64_t)x, (uint64_t)(x >> 64)};
+  LValue copy(Value::Type::Unsigned, words, 2, 128);
+  value.u_plus(&copy);
+}
+
+uint128 wideOf(const LValue& value) {
+  EXPECT_EQ(value.getNbWords(), 2);
+  return ((uint128)value.getValueUL(1) << 64) | value.getValueUL(0);
+}
+
+}  // namespace
+
+TEST(ValueTest, WideKernelsMatchInt128) {
+  Operands operands(3);
+  for (unsigned int i = 0; i < 20000; i++) {
+    uint128 x = operands.wide();
+    uint128 y = operands.wide();
+    LValue a, b, r;
+    setWide(a, x);
+    setWide(b, y);
+    r.plus(&a, &b);
+    EXPECT_TRUE(wideOf(r) == x + y);
+    r.minus(&a, &b);
+    EXPECT_TRUE(wideOf(r) == x - y);
+    r.mult(&a, &b);
+    EXPECT_TRUE(wideOf(r) == x * y);
+    r.bitwAnd(&a, &b);
+    EXPECT_TRUE(wideOf(r) == (x & y));
+    r.bitwOr(&a, &b);
+    EXPECT_TRUE(wideOf(r) == (x | y));
+    r.bitwXor(&a, &b);
+    EXPECT_TRUE(wideOf(r) == (x ^ y));
+    r.lesser(&a, &b);
+    EXPECT_EQ(r.getValueUL(), (uint64_t)(x < y));
+    r.greater_equal(&a, &b);
+    EXPECT_EQ(r.getValueUL(), (uint64_t)(x >= y));
+    r.equiv(&a, &b);
+    EXPECT_EQ(r.getValueUL(), (uint64_t)(x == y));
+    r.div(&a, &b);
+    EXPECT_EQ(r.isValid(), y != 0);
+    if (y) {
+      EXPECT_TRUE(wideOf(r) == x / y);
+    }
+    r.mod(&a, &b);
+    EXPECT_EQ(r.isValid(), y != 0);
+    if (y) {
+      EXPECT_TRUE(wideOf(r) == x % y);
+    }
+    unsigned int shift = operands.word() % 140;
+    LValue s;
+    s.set((uint64_t)shift, Value::Type::Unsigned, 64);
+    r.shiftLeft(&a, &s);
+    EXPECT_TRUE(wideOf(r) == (shift < 128 ? x << shift : 0));
+    r.shiftRight(&a, &s);
+    EXPECT_TRUE(wideOf(r) == (shift < 128 ? x >> shift : 0));
+  }
+}
+
+TEST(ValueTest, WideResultsCanBeOperands) {
+  Operands operands(5);
+  for (unsigned int i = 0; i < 5000; i++) {
+    uint128 x = operands.wide();
+    uint128 y = operands.wide();
+    if (y == 0) y = 3;
+    LValue a, b;
+    setWide(a, x);
+    setWide(b, y);
+    a.div(&a, &b);
+    EXPECT_TRUE(wideOf(a) == x / y);
+    setWide(a, x);
+    b.mod(&a, &b);
+    EXPECT_TRUE(wideOf(b) == x % y);
+    setWide(b, y);
+    a.mult(&a, &b);
+    EXPECT_TRUE(wideOf(a) == x * y);
+    setWide(a, x);
+    a.minus(&a, &a);
+    EXPECT_TRUE(wideOf(a) == 0);
+    setWide(a, x);
+    a.plus(&a, &a);
+    EXPECT_TRUE(wideOf(a) == x + x);
+    setWide(a, x);
+    LValue s;
+    s.set((uint64_t)(y % 130), Value::Type::Unsigned, 64);
+    a.shiftLeft(&a, &s);
+    EXPECT_TRUE(wideOf(a) == (y % 130 < 128 ? x << (y % 130) : 0));
+  }
+}
+
+TEST(ValueTest, SingleWordsDivideSigned) {
+  Operands operands(7);
+  for (unsigned int i = 0; i < 20000; i++) {
+    int64_t x = (int64_t)operands.word();
+    int64_t y = (int64_t)operands.word();
+    LValue a, b, r;
+    a.set((uint64_t)x, Value::Type::Integer, 64);
+    b.set((uint64_t)y, Value::Type::Integer, 64);
+    r.div(&a, &b);
+    EXPECT_EQ(r.isValid(), y != 0);
+    // Checked in 128 bits, where INT64_MIN / -1 does not overflow
+    if (y) {
+      EXPECT_EQ(r.getValueL(), (int64_t)((__int128)x / y));
+    }
+    r.mod(&a, &b);
+    EXPECT_EQ(r.isValid(), y != 0);
+    if (y) {
+      EXPECT_EQ(r.getValueL(), (int64_t)((__int128)x % y));
+    }
+    r.lesser(&a, &b);
+    EXPECT_EQ(r.getValueUL(), (uint64_t)(x < y));
+    if (y) {
+      a.div(&a, &b);
+      EXPECT_EQ(a.getValueL(), (int64_t)((__int128)x / y));
+    }
+  }
+}
+
+TEST(ValueTest, WiderDivisionsInvertTheProduct) {
+  // Past 128 bits the quotient q and the remainder r of x / y satisfy
+  // q * y + r = x with r < y
+  std::mt19937_64 random(11);
+  for (unsigned int i = 0; i < 2000; i++) {
+    uint64_t xw[4];
+    uint64_t yw[4] = {0, 0, 0, 0};
+    for (unsigned int k = 0; k < 4; k++) xw[k] = random();
+    unsigned int nbY = 1 + random() % 4;
+    for (unsigned int k = 0; k < nbY; k++) yw[k] = random() >> (random() % 64);
+    if (yw[0] == 0) yw[0] = 1;
+    LValue x(Value::Type::Unsigned, xw, 4, 256);
+    LValue y(Value::Type::Unsigned, yw, 4, 256);
+    LValue q, r, check;
+    q.div(&x, &y);
+    r.mod(&x, &y);
+    ASSERT_TRUE(q.isValid());
+    ASSERT_TRUE(r.isValid());
+    check.lesser(&r, &y);
+    EXPECT_EQ(check.getValueUL(), 1u);
+    check.mult(&q, &y);
+    check.plus(&check, &r);
+    check.equiv(&check, &x);
+    EXPECT_EQ(check.getValueUL(), 1u);
+  }
+}
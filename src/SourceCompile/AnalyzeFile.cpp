@@ -199,7 +199,7 @@ void AnalyzeFile::analyze() {
               if (line[j] == ';') break;
               if (line[j] != ' ') packageName += line[j];
             }
-            m_design->addOrderedPackage(packageName);
+            m_packageNames.push_back(packageName);
             inPackage = true;
             startLine = lineNb;
             startChar = charNb;
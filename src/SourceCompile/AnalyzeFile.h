@@ -62,6 +62,9 @@ class AnalyzeFile {
   void analyze();
   std::vector<std::string>& getSplitFiles() { return m_splitFiles; }
   std::vector<unsigned int>& getLineOffsets() { return m_lineOffsets; }
+  // Packages in file order, the caller adds them to the design ordered
+  // package list (files can be analyzed concurrently)
+  std::vector<std::string>& getPackageNames() { return m_packageNames; }
 
   AnalyzeFile(const AnalyzeFile& orig) = delete;
   virtual ~AnalyzeFile() {}
@@ -78,6 +81,7 @@ class AnalyzeFile {
   std::vector<FileChunk> m_fileChunks;
   std::vector<std::string> m_splitFiles;
   std::vector<unsigned int> m_lineOffsets;
+  std::vector<std::string> m_packageNames;
   int m_nbChunks;
   std::stack<IncludeFileInfo> m_includeFileInfo;
 };
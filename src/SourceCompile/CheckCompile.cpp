@@ -53,11 +53,17 @@ bool CheckCompile::mergeSymbolTables_() {
       m_compiler->getDesign()->getAllFileContents();
   for (auto fitr = all_files.begin(); fitr != all_files.end(); fitr++) {
     auto fileContent = (*fitr).second;
+    // Files compiled against the shared table need no translation
+    if (fileContent->getSymbolTable() == m_compiler->getSymbolTable())
+      continue;
     m_compiler->getSymbolTable()->registerSymbol(fileContent->getFileName());
-    for (NodeId id : fileContent->getNodeIds()) {
-      fileContent->getFileId(id) = m_compiler->getSymbolTable()->registerSymbol(
-          fileContent->getSymbolTable()->getSymbol(fileContent->getFileId(id)));
+    // The nodes only hold an index in the file table
+    std::vector<SymbolId> fileIds = fileContent->getFileIdTable();
+    for (SymbolId& fileId : fileIds) {
+      fileId = m_compiler->getSymbolTable()->registerSymbol(
+          fileContent->getSymbolTable()->getSymbol(fileId));
     }
+    fileContent->setFileIdTable(fileIds);
     for (DesignElement& elem : fileContent->getDesignElements()) {
       elem.m_name = m_compiler->getSymbolTable()->registerSymbol(
           fileContent->getSymbolTable()->getSymbol(elem.m_name));
@@ -63,7 +63,7 @@ NodeId CommonListenerHelper::UniqueId(NodeId index) {
   return index;
 }
 
-SymbolId& CommonListenerHelper::Name(NodeId index) {
+SymbolId CommonListenerHelper::Name(NodeId index) {
   return m_fileContent->getVObjects()[index].m_name;
 }
 
@@ -95,7 +95,9 @@ int CommonListenerHelper::addVObject(ParserRuleContext* ctx, SymbolId sym, VObje
   SymbolId fileId;
   const unsigned int line = getFileLine(ctx, fileId);
 
-  m_fileContent->getVObjects().emplace_back(sym, fileId, objtype, line, 0);
+  m_fileContent->getVObjects().emplace_back(
+      m_fileContent->getNameId(sym), m_fileContent->getFileIndex(fileId),
+      objtype, line, 0);
   int objectIndex = m_fileContent->getVObjects().size() - 1;
   m_contextToObjectMap.insert(std::make_pair(ctx, objectIndex));
   addParentChildRelations(objectIndex, ctx);
@@ -104,7 +106,7 @@ int CommonListenerHelper::addVObject(ParserRuleContext* ctx, SymbolId sym, VObje
     if (it->m_context == ctx) {
       // Use the file and line number of the design object (package, module),
       // true file/line when splitting
-      m_fileContent->getVObjects().back().m_fileId = it->m_fileId;
+      m_fileContent->setFileId(objectIndex, it->m_fileId);
       m_fileContent->getVObjects().back().m_line = it->m_line;
       it->m_node = objectIndex;
       break;
@@ -126,6 +128,8 @@ int CommonListenerHelper::addVObject(ParserRuleContext* ctx,
 
 void CommonListenerHelper::addParentChildRelations(int indexParent,
                                                    ParserRuleContext* ctx) {
+  // Relinks nodes a search might have indexed already
+  m_fileContent->clearIndex();
   int currentIndex = indexParent;
   for (tree::ParseTree* child : ctx->children) {
     int childIndex = ObjectIndexFromContext(child);
@@ -55,7 +55,7 @@ public:
 
   NodeId UniqueId(NodeId index);
 
-  SymbolId& Name(NodeId index);
+  SymbolId Name(NodeId index);
 
   NodeId& Child(NodeId index);
 
@@ -250,6 +250,8 @@ bool CompileSourceFile::preprocess_() {
   return true;
 }
 
+std::mutex CompileSourceFile::m_ppDirMutex;
+
 bool CompileSourceFile::postPreprocess_() {
   SymbolTable* symbolTable = getCompiler()->getSymbolTable();
   if (m_commandLineParser->parseOnly()) {
@@ -276,7 +278,11 @@ bool CompileSourceFile::postPreprocess_() {
     m_ppResultFileId = m_symbolTable->registerSymbol(ppFileName);
     SymbolId ppDirId = symbolTable->registerSymbol(dirPpFile);
 
-    if (FileUtils::mkDir(dirPpFile.c_str()) != 0) {
+    // Files of the same library share their output directory
+    m_ppDirMutex.lock();
+    int status = FileUtils::mkDir(dirPpFile.c_str());
+    m_ppDirMutex.unlock();
+    if (status != 0) {
       Location loc(ppDirId);
       Error err(ErrorDefinition::PP_CANNOT_CREATE_DIRECTORY, loc);
       m_errors->addError(err);
@@ -24,6 +24,7 @@
 #ifndef COMPILESOURCEFILE_H
 #define COMPILESOURCEFILE_H
 #include "Python.h"
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -113,6 +114,7 @@ class CompileSourceFile {
   PythonListen* m_pythonListener;
   AnalyzeFile* m_fileAnalyzer;
   Library* m_library;
+  static std::mutex m_ppDirMutex;  // Serializes the output directory creation
 };
 
 };  // namespace SURELOG
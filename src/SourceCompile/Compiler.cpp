@@ -39,6 +39,10 @@
 #include "Package/Precompiled.h"
 #include "Utils/StringUtils.h"
 #include "Utils/Timer.h"
+#include "Utils/ThreadPool.h"
+#include "Cache/Cache.h"
+#include "Cache/PPCache.h"
+#include "Cache/CachePrefetcher.h"
 #include <math.h>
 using namespace antlr4;
 
@@ -47,6 +51,8 @@ using namespace antlr4;
 #include <mutex>
 #include <thread>
 #include <vector>
+#include <algorithm>
+#include <functional>
 #include <iostream>
 #include <fstream>
 using namespace SURELOG;
@@ -56,7 +62,8 @@ Compiler::Compiler(CommandLineParser* commandLineParser, ErrorContainer* errors,
     : m_commandLineParser(commandLineParser),
       m_errors(errors),
       m_symbolTable(symbolTable),
-      m_commonCompilationUnit(NULL) {
+      m_commonCompilationUnit(NULL),
+      m_threadPool(NULL) {
   m_design = NULL;
 #ifdef USETBB
   if (getCommandLineParser()->useTbb() &&
@@ -76,6 +83,13 @@ Compiler::~Compiler() {
     delete m_commonCompilationUnit;
   }
   cleanup_();
+  delete m_threadPool;
+}
+
+ThreadPool* Compiler::getThreadPool() {
+  if (m_threadPool == NULL)
+    m_threadPool = new ThreadPool(m_commandLineParser->getNbMaxTreads());
+  return m_threadPool;
 }
 
 struct FunctorCompileOneFile {
@@ -127,8 +141,6 @@ bool Compiler::ppinit_() {
     if (m_commandLineParser->fileunit()) {
       comp_unit = new CompilationUnit(true);
       m_compilationUnits.push_back(comp_unit);
-      symbols = new SymbolTable(*m_commandLineParser->getSymbolTable());
-      m_symbolTables.push_back(symbols);
     }
     ErrorContainer* errors = new ErrorContainer(symbols);
     m_errorContainers.push_back(errors);
@@ -172,8 +184,6 @@ bool Compiler::ppinit_() {
     if (m_commandLineParser->fileunit()) {
       comp_unit = new CompilationUnit(true);
       m_compilationUnits.push_back(comp_unit);
-      symbols = new SymbolTable(*m_commandLineParser->getSymbolTable());
-      m_symbolTables.push_back(symbols);
     }
     ErrorContainer* errors = new ErrorContainer(symbols);
     m_errorContainers.push_back(errors);
@@ -215,8 +225,6 @@ bool Compiler::ppinit_() {
       if (m_commandLineParser->fileunit()) {
         comp_unit = new CompilationUnit(true);
         m_compilationUnits.push_back(comp_unit);
-        symbols = new SymbolTable(*m_commandLineParser->getSymbolTable());
-        m_symbolTables.push_back(symbols);
       }
       ErrorContainer* errors = new ErrorContainer(symbols);
       m_errorContainers.push_back(errors);
@@ -385,120 +393,237 @@ bool Compiler::createMultiProcess_() {
 }
   
 bool Compiler::parseinit_() {
-  Precompiled* prec = Precompiled::getSingleton();
   // Single out the large files.
   // Small files are going to be scheduled in multiple threads based on size.
   // Large files are going to be compiled in a different batch in multithread
   
   if (!m_commandLineParser->fileunit()) {
-    unsigned int size = m_symbolTables.size();
-    for (unsigned int i = 0; i < size; i++) {
-      delete m_symbolTables[i];
-    }
-    size = m_errorContainers.size();
+    unsigned int size = m_errorContainers.size();
     for (unsigned int i = 0; i < size; i++) {
       delete m_errorContainers[i];
     }
-    m_symbolTables.clear();
     m_errorContainers.clear();
   }
 
-  std::vector<CompileSourceFile*> tmp_compilers;
+  // The files are analyzed in parallel, the shared lists are updated after
+  // in file order
   unsigned int size = m_compilers.size();
-  for (unsigned int i = 0; i < size; i++) {
-    std::string fileName = m_compilers[i]->getSymbolTable()->getSymbol(
-        m_compilers[i]->getPpOutputFileId());
-    std::string origFile = m_compilers[i]->getSymbolTable()->getSymbol(
-        m_compilers[i]->getFileId());
-    unsigned int nbThreads = m_commandLineParser->getNbMaxTreads();
-    std::string root = fileName;
-    root = StringUtils::getRootFileName(root);
-    if (prec->isFilePrecompiled(root)) {
-      nbThreads = 0;
+  std::vector<std::vector<CompileSourceFile*>> jobs(size);
+  std::vector<char> isParent(size, 0);
+  if (m_commandLineParser->getNbMaxTreads()) {
+    ThreadPool* pool = getThreadPool();
+    for (unsigned int i = 0; i < size; i++) {
+      pool->addJob([&, i](unsigned int) {
+        isParent[i] = splitFile_(m_compilers[i], jobs[i]);
+      });
     }
-    int effectiveNbThreads = 0;
+    pool->wait();
+  } else {
+    for (unsigned int i = 0; i < size; i++)
+      isParent[i] = splitFile_(m_compilers[i], jobs[i]);
+  }
+  std::vector<CompileSourceFile*> tmp_compilers;
+  for (unsigned int i = 0; i < size; i++)
+    registerSplitFile_(m_compilers[i], isParent[i], jobs[i], tmp_compilers);
+  m_compilers = tmp_compilers;
 
-    if (nbThreads > 4)
-      effectiveNbThreads = (int) (log(((float) nbThreads + 1.0) / 4.0) * 10.0);
-    else
-      effectiveNbThreads = nbThreads;
-    
-    AnalyzeFile* fileAnalyzer = new AnalyzeFile(
-        m_commandLineParser, m_design, fileName, origFile, effectiveNbThreads);
-    fileAnalyzer->analyze();
-    m_compilers[i]->setFileAnalyzer(fileAnalyzer);
-    if (fileAnalyzer->getSplitFiles().size() > 1) {
-      // Schedule parent
-      m_compilersParentFiles.push_back(m_compilers[i]);
-      m_compilers[i]->initParser();
-
-      if (!m_commandLineParser->fileunit()) {
-        SymbolTable* symbols =
-            new SymbolTable(*m_commandLineParser->getSymbolTable());
-        m_symbolTables.push_back(symbols);
-        m_compilers[i]->setSymbolTable(symbols);
-        // fileContent->setSymbolTable(symbols);
-        ErrorContainer* errors = new ErrorContainer(symbols);
-        m_errorContainers.push_back(errors);
-        errors->regiterCmdLine(m_commandLineParser);
-        m_compilers[i]->setErrorContainer(errors);
-      }
+  return true;
+}
+
+bool Compiler::splitFile_(CompileSourceFile* compiler,
+                          std::vector<CompileSourceFile*>& jobs) {
+  Precompiled* prec = Precompiled::getSingleton();
+  std::string fileName = compiler->getSymbolTable()->getSymbol(
+      compiler->getPpOutputFileId());
+  std::string origFile =
+      compiler->getSymbolTable()->getSymbol(compiler->getFileId());
+  unsigned int nbThreads = m_commandLineParser->getNbMaxTreads();
+  std::string root = fileName;
+  root = StringUtils::getRootFileName(root);
+  if (prec->isFilePrecompiled(root)) {
+    nbThreads = 0;
+  }
+  int effectiveNbThreads = 0;
+
+  if (nbThreads > 4)
+    effectiveNbThreads = (int) (log(((float) nbThreads + 1.0) / 4.0) * 10.0);
+  else
+    effectiveNbThreads = nbThreads;
+  
+  AnalyzeFile* fileAnalyzer = new AnalyzeFile(
+      m_commandLineParser, m_design, fileName, origFile, effectiveNbThreads);
+  fileAnalyzer->analyze();
+  compiler->setFileAnalyzer(fileAnalyzer);
+  if (fileAnalyzer->getSplitFiles().size() > 1) {
+    // Schedule parent
+    compiler->initParser();
+
+    if (!m_commandLineParser->fileunit()) {
+      ErrorContainer* errors = new ErrorContainer(m_symbolTable);
+      errors->regiterCmdLine(m_commandLineParser);
+      compiler->setErrorContainer(errors);
+    }
+
+    FileContent* fileContent =
+        new FileContent(compiler->getParser()->getFileId(0),
+                        compiler->getParser()->getLibrary(),
+                        compiler->getSymbolTable(),
+                        compiler->getErrorContainer(), NULL, 0);
+    compiler->getParser()->setFileContent(fileContent);
+
+    int j = 0;
+    for (auto chunk : fileAnalyzer->getSplitFiles()) {
+      SymbolTable* symbols = m_symbolTable;
+      SymbolId ppId = symbols->registerSymbol(chunk);
+      CompileSourceFile* chunkCompiler = new CompileSourceFile(
+          compiler, ppId, fileAnalyzer->getLineOffsets()[j]);
+      // Schedule chunk
+      jobs.push_back(chunkCompiler);
+
+      chunkCompiler->setSymbolTable(symbols);
+      ErrorContainer* errors = new ErrorContainer(symbols);
+      errors->regiterCmdLine(m_commandLineParser);
+      chunkCompiler->setErrorContainer(errors);
+      // chunkCompiler->getParser ()->setFileContent (fileContent);
 
       FileContent* fileContent =
-          new FileContent(m_compilers[i]->getParser()->getFileId(0),
-                          m_compilers[i]->getParser()->getLibrary(),
-                          m_compilers[i]->getSymbolTable(),
-                          m_compilers[i]->getErrorContainer(), NULL, 0);
-      m_compilers[i]->getParser()->setFileContent(fileContent);
-
-      int j = 0;
-      for (auto chunk : fileAnalyzer->getSplitFiles()) {
-        SymbolTable* symbols =
-            new SymbolTable(*m_commandLineParser->getSymbolTable());
-        m_symbolTables.push_back(symbols);
-        SymbolId ppId = symbols->registerSymbol(chunk);
-        symbols->registerSymbol(
-            m_compilers[i]->getParser()->getFileName(LINE1));
-        CompileSourceFile* chunkCompiler = new CompileSourceFile(
-            m_compilers[i], ppId, fileAnalyzer->getLineOffsets()[j]);
-        // Schedule chunk
-        tmp_compilers.push_back(chunkCompiler);
-
-        chunkCompiler->setSymbolTable(symbols);
-        ErrorContainer* errors = new ErrorContainer(symbols);
-        m_errorContainers.push_back(errors);
-        errors->regiterCmdLine(m_commandLineParser);
-        chunkCompiler->setErrorContainer(errors);
-        // chunkCompiler->getParser ()->setFileContent (fileContent);
-
-        FileContent* fileContent =
-            new FileContent(m_compilers[i]->getParser()->getFileId(0),
-                            m_compilers[i]->getParser()->getLibrary(), symbols,
-                            errors, NULL, ppId);
-        chunkCompiler->getParser()->setFileContent(fileContent);
-        getDesign()->addFileContent(m_compilers[i]->getParser()->getFileId(0),
-                                    fileContent);
-
-        j++;
+          new FileContent(compiler->getParser()->getFileId(0),
+                          compiler->getParser()->getLibrary(), symbols,
+                          errors, NULL, ppId);
+      chunkCompiler->getParser()->setFileContent(fileContent);
+
+      j++;
+    }
+    return true;
+  }
+  if (!m_commandLineParser->fileunit()) {
+    ErrorContainer* errors = new ErrorContainer(m_symbolTable);
+    errors->regiterCmdLine(m_commandLineParser);
+    compiler->setErrorContainer(errors);
+  }
+
+  // Created here rather than by the parser, so that registerSplitFile_ adds
+  // it to the design in file order with the chunks of the split files
+  compiler->initParser();
+  FileContent* fileContent =
+      new FileContent(compiler->getParser()->getFileId(0),
+                      compiler->getParser()->getLibrary(),
+                      compiler->getSymbolTable(),
+                      compiler->getErrorContainer(), NULL, 0);
+  compiler->getParser()->setFileContent(fileContent);
+
+  jobs.push_back(compiler);
+  return false;
+}
+
+void Compiler::registerSplitFile_(CompileSourceFile* compiler, bool isParent,
+                                  std::vector<CompileSourceFile*>& jobs,
+                                  std::vector<CompileSourceFile*>& compilers) {
+  if (isParent) m_compilersParentFiles.push_back(compiler);
+  if (!m_commandLineParser->fileunit())
+    m_errorContainers.push_back(compiler->getErrorContainer());
+  // File contents are added in file order whether the file is split or not
+  for (CompileSourceFile* job : jobs) {
+    if (job != compiler)
+      m_errorContainers.push_back(job->getErrorContainer());
+    getDesign()->addFileContent(compiler->getParser()->getFileId(0),
+                                job->getParser()->getFileContent());
+    compilers.push_back(job);
+  }
+  for (auto& packageName : compiler->getFileAnalyzer()->getPackageNames())
+    m_design->addOrderedPackage(packageName);
+}
+
+bool Compiler::parsePipeline_() {
+  // Each file goes through post preprocessing, splitting, chunk parsing and
+  // chunk recombination as soon as its previous stage is done, there is no
+  // barrier between the stages.
+  unsigned int size = m_compilers.size();
+  std::vector<ErrorContainer*> ppErrorContainers;
+  if (!m_commandLineParser->fileunit()) {
+    ppErrorContainers = m_errorContainers;
+    m_errorContainers.clear();
+  }
+  std::vector<ErrorContainer*> ppErrors(size);
+  std::vector<std::vector<CompileSourceFile*>> jobs(size);
+  std::vector<char> ppStatus(size, 1);
+  std::vector<char> isParent(size, 0);
+  std::vector<unsigned int> remainingChunks(size, 0);
+  std::mutex chunkMutex;
+  bool python = getCommandLineParser()->pythonListener() ||
+                getCommandLineParser()->pythonEvalScriptPerFile();
+  ThreadPool* pool = getThreadPool();
+
+  std::function<void(CompileSourceFile*)> parse =
+      [python](CompileSourceFile* job) {
+        if (python) job->setPythonInterp(PythonAPI::initNewInterp());
+        job->compile(CompileSourceFile::Parse);
+        if (python) job->shutdownPythonInterp();
+      };
+
+  for (unsigned int i = 0; i < size; i++) {
+    CompileSourceFile* compiler = m_compilers[i];
+    ppErrors[i] = compiler->getErrorContainer();
+    pool->addJob([&, i, compiler](unsigned int) {
+      if (!compiler->compile(CompileSourceFile::PostPreprocess) ||
+          compiler->getErrorContainer()->hasFatalErrors()) {
+        ppStatus[i] = 0;
+        return;
       }
-    } else {
-      if (!m_commandLineParser->fileunit()) {
-        SymbolTable* symbols =
-            new SymbolTable(*m_commandLineParser->getSymbolTable());
-        m_symbolTables.push_back(symbols);
-        m_compilers[i]->setSymbolTable(symbols);
-        ErrorContainer* errors = new ErrorContainer(symbols);
-        m_errorContainers.push_back(errors);
-        errors->regiterCmdLine(m_commandLineParser);
-        m_compilers[i]->setErrorContainer(errors);
+      isParent[i] = splitFile_(compiler, jobs[i]);
+      remainingChunks[i] = jobs[i].size();
+      for (CompileSourceFile* job : jobs[i]) {
+        pool->addJob([&, i, compiler, job](unsigned int) {
+          parse(job);
+          if (!isParent[i]) return;
+          // The last parsed chunk schedules the recombination
+          chunkMutex.lock();
+          bool last = (--remainingChunks[i] == 0);
+          chunkMutex.unlock();
+          if (last) pool->addJob([&, compiler](unsigned int) {
+            parse(compiler);
+          });
+        });
       }
+    });
+  }
+  pool->wait();
+
+  // Post preprocessing report, in file order
+  bool fatalErrors = false;
+  for (unsigned int i = 0; i < size; i++) {
+    m_errors->appendErrors(*ppErrors[i]);
+    if (!ppStatus[i]) fatalErrors = true;
+  }
+  m_errors->printMessages(m_commandLineParser->muteStdout());
+  for (unsigned int i = 0; i < ppErrorContainers.size(); i++)
+    delete ppErrorContainers[i];
 
+  std::vector<CompileSourceFile*> tmp_compilers;
+  for (unsigned int i = 0; i < size; i++) {
+    if (!ppStatus[i]) {
       tmp_compilers.push_back(m_compilers[i]);
+      continue;
     }
+    registerSplitFile_(m_compilers[i], isParent[i], jobs[i], tmp_compilers);
   }
   m_compilers = tmp_compilers;
-
-  return true;
+  if (fatalErrors) return false;
+  createFileList_();
+
+  // Promote report to master error container
+  for (unsigned int j = 0; j < m_compilers.size(); j++) {
+    m_errors->appendErrors(*m_compilers[j]->getErrorContainer());
+    if (m_compilers[j]->getErrorContainer()->hasFatalErrors())
+      fatalErrors = true;
+  }
+  for (unsigned int j = 0; j < m_compilersParentFiles.size(); j++) {
+    m_errors->appendErrors(*m_compilersParentFiles[j]->getErrorContainer());
+    if (m_compilersParentFiles[j]->getErrorContainer()->hasFatalErrors())
+      fatalErrors = true;
+  }
+  m_errors->printMessages(m_commandLineParser->muteStdout());
+  return !fatalErrors;
 }
 
 bool Compiler::pythoninit_() { return parseinit_(); }
@@ -524,10 +649,6 @@ bool Compiler::cleanup_() {
   for (unsigned int i = 0; i < size; i++) {
     delete m_compilationUnits[i];
   }
-  size = m_symbolTables.size();
-  for (unsigned int i = 0; i < size; i++) {
-    delete m_symbolTables[i];
-  }
   size = m_errorContainers.size();
   for (unsigned int i = 0; i < size; i++) {
     delete m_errorContainers[i];
@@ -535,6 +656,37 @@ bool Compiler::cleanup_() {
   return true;
 }
 
+// Files read by a preprocess or parse job: the source file and its cache files
+static std::vector<std::string> prefetchFiles(CompileSourceFile* comp,
+                                              CompileSourceFile::Action action) {
+  std::vector<std::string> fileNames;
+  CommandLineParser* clp = comp->getCommandLineParser();
+  SymbolTable* symbols = comp->getSymbolTable();
+  SymbolId fileId = comp->getFileId();
+  if (action == CompileSourceFile::Parse) fileId = comp->getPpOutputFileId();
+  if (fileId == 0) return fileNames;
+  std::string fileName = symbols->getSymbol(fileId);
+  fileNames.push_back(fileName);
+  if (!clp->cacheAllowed() || clp->getCacheDir() == 0 ||
+      comp->getLibrary() == NULL)
+    return fileNames;
+  bool isPrecompiled = false;
+  std::string cacheDirName = Cache::getCacheDirName(
+      clp, symbols, comp->getLibrary(), fileName, isPrecompiled);
+  std::string root = StringUtils::getRootFileName(fileName);
+  if (action == CompileSourceFile::Parse) {
+    fileNames.push_back(cacheDirName + root + ".slpa");
+  } else {
+    fileNames.push_back(cacheDirName + root + ".slpp");
+    if (!isPrecompiled) {
+      for (unsigned int v = 1; v < PPCache::MaxVariants; v++)
+        fileNames.push_back(cacheDirName + root + "." + std::to_string(v) +
+                            ".slpp");
+    }
+  }
+  return fileNames;
+}
+
 bool Compiler::compileFileSet_(CompileSourceFile::Action action,
                                bool allowMultithread,
                                std::vector<CompileSourceFile*>& container) {
@@ -543,11 +695,22 @@ bool Compiler::compileFileSet_(CompileSourceFile::Action action,
     maxThreadCount = 0;
   }
 
+  bool prefetch = (action == CompileSourceFile::Preprocess) ||
+                  (action == CompileSourceFile::Parse);
+  CachePrefetcher prefetcher(
+      prefetch ? m_commandLineParser->getPrefetchWindow() : 0);
+
   if (maxThreadCount == 0) {
     // Single thread
     unsigned int size = container.size();
+    if (prefetch) {
+      for (unsigned int i = 0; i < size; i++)
+        prefetcher.addJob(prefetchFiles(container[i], action));
+      prefetcher.start();
+    }
     for (unsigned int i = 0; i < size; i++) {
       container[i]->setPythonInterp(PythonAPI::getMainInterp());
+      prefetcher.jobStarted();
       bool status = compileOneFile_(container[i], action);
       m_errors->appendErrors(*container[i]->getErrorContainer());
       m_errors->printMessages(m_commandLineParser->muteStdout());
@@ -595,28 +758,12 @@ bool Compiler::compileFileSet_(CompileSourceFile::Action action,
   } else {
     // Custom Thread management
 
-    // Optimize the load balance, try to even out the work in each thread by the
-    // size of the files
-    std::vector<std::vector<CompileSourceFile*>> jobArray(maxThreadCount);
-
-    std::vector<unsigned long> jobSize(maxThreadCount);
-
-    for (unsigned short i = 0; i < maxThreadCount; i++) jobSize[i] = 0;
-
-    for (unsigned int i = 0; i < container.size(); i++) {
-      unsigned int size = container[i]->getJobSize(action);
-      unsigned int newJobIndex = 0;
-      uint64_t minJobQueue = ULLONG_MAX;
-      for (unsigned short ii = 0; ii < maxThreadCount; ii++) {
-        if (jobSize[ii] < minJobQueue) {
-          newJobIndex = ii;
-          minJobQueue = jobSize[ii];
-        }
-      }
-
-      jobSize[newJobIndex] += size;
-      jobArray[newJobIndex].push_back(container[i]);
-    }
+    // Biggest files first, the pool balances the load dynamically
+    std::vector<CompileSourceFile*> jobs(container);
+    std::stable_sort(jobs.begin(), jobs.end(),
+                     [action](CompileSourceFile* a, CompileSourceFile* b) {
+                       return a->getJobSize(action) > b->getJobSize(action);
+                     });
 
     if (getCommandLineParser()->profile()) {
       if (action == CompileSourceFile::Preprocess)
@@ -625,54 +772,48 @@ bool Compiler::compileFileSet_(CompileSourceFile::Action action,
         std::cout << "Parsing task\n";
       else
         std::cout << "Misc Task\n";
-      for (unsigned short i = 0; i < maxThreadCount; i++) {
-        std::cout << "Thread " << i << " : \n";
-        int sum = 0;
-        for (unsigned int j = 0; j < jobArray[i].size(); j++) {
-          std::string fileName;
-          if (jobArray[i][j]->getPreprocessor())
-            fileName = jobArray[i][j]->getPreprocessor()->getFileName(0);
-          if (jobArray[i][j]->getParser())
-            fileName = jobArray[i][j]->getParser()->getFileName(0);
-          sum += jobArray[i][j]->getJobSize(action);
-          std::cout << jobArray[i][j]->getJobSize(action) << " " << fileName
-                    << "\n";
-        }
-        std::cout << ", Total: " << sum << std::endl << std::flush;
+      int sum = 0;
+      for (unsigned int j = 0; j < jobs.size(); j++) {
+        std::string fileName;
+        if (jobs[j]->getPreprocessor())
+          fileName = jobs[j]->getPreprocessor()->getFileName(0);
+        if (jobs[j]->getParser())
+          fileName = jobs[j]->getParser()->getFileName(0);
+        sum += jobs[j]->getJobSize(action);
+        std::cout << jobs[j]->getJobSize(action) << " " << fileName << "\n";
       }
+      std::cout << ", Total: " << sum << std::endl << std::flush;
     }
 
-    // Create the threads with their respective workloads
-    std::vector<std::thread*> threads;
-    for (unsigned short i = 0; i < maxThreadCount; i++) {
-      std::thread* th = new std::thread([=] {
-        for (unsigned int j = 0; j < jobArray[i].size(); j++) {
-          if (getCommandLineParser()->pythonListener() ||
-              getCommandLineParser()->pythonEvalScriptPerFile()) {
-            PyThreadState* interpState = PythonAPI::initNewInterp();
-            jobArray[i][j]->setPythonInterp(interpState);
-          }
-
-          jobArray[i][j]->compile(action);
+    // The jobs are consumed about in the order they are queued
+    if (prefetch) {
+      for (unsigned int j = 0; j < jobs.size(); j++)
+        prefetcher.addJob(prefetchFiles(jobs[j], action));
+      prefetcher.start();
+    }
 
-          if (getCommandLineParser()->pythonListener() ||
-              getCommandLineParser()->pythonEvalScriptPerFile()) {
-            jobArray[i][j]->shutdownPythonInterp();
-          }
+    ThreadPool* pool = getThreadPool();
+    CachePrefetcher* prefetcherPtr = &prefetcher;
+    for (unsigned int j = 0; j < jobs.size(); j++) {
+      CompileSourceFile* job = jobs[j];
+      pool->addJob([=](unsigned int) {
+        if (getCommandLineParser()->pythonListener() ||
+            getCommandLineParser()->pythonEvalScriptPerFile()) {
+          PyThreadState* interpState = PythonAPI::initNewInterp();
+          job->setPythonInterp(interpState);
         }
-      });
-      threads.push_back(th);
-    }
 
-    // Sync the threads
-    for (unsigned int th = 0; th < threads.size(); th++) {
-      threads[th]->join();
-    }
+        prefetcherPtr->jobStarted();
+        job->compile(action);
 
-    // Delete the threads
-    for (unsigned int th = 0; th < threads.size(); th++) {
-      delete threads[th];
+        if (getCommandLineParser()->pythonListener() ||
+            getCommandLineParser()->pythonEvalScriptPerFile()) {
+          job->shutdownPythonInterp();
+        }
+      });
     }
+    pool->wait();
+    prefetcher.stop();
 
     // Promote report to master error container
     bool fatalErrors = false;
@@ -709,8 +850,22 @@ bool Compiler::compile() {
                        m_commandLineParser->fileunit(), m_compilers))
     return false;
 
-  // Single thread post Preprocess
-  if (!compileFileSet_(CompileSourceFile::PostPreprocess, false, m_compilers))
+  bool parse = m_commandLineParser->parse() ||
+               m_commandLineParser->pythonListener() ||
+               m_commandLineParser->pythonEvalScriptPerFile() ||
+               m_commandLineParser->pythonEvalScript();
+  // With -writeppfile all the files write their preprocessed output to the
+  // same file, post preprocessing then runs on one thread in file order
+  bool ppParallel = (m_commandLineParser->writePpOutputFileId() == 0);
+  // When parsing in this process on several threads, post preprocessing,
+  // splitting and parsing are pipelined per file
+  bool pipeline = parse && ppParallel &&
+                  (m_commandLineParser->getNbMaxTreads() > 0) &&
+                  (m_commandLineParser->getNbMaxProcesses() == 0);
+
+  // Post Preprocess, each file writes its own preprocessed output
+  if (!pipeline && !compileFileSet_(CompileSourceFile::PostPreprocess,
+                                    ppParallel, m_compilers))
     return false;
 
   if (m_commandLineParser->profile()) {
@@ -727,9 +882,10 @@ bool Compiler::compile() {
 
   // Parse
   bool parserInitialized = false;
-  if (m_commandLineParser->parse() || m_commandLineParser->pythonListener() ||
-      m_commandLineParser->pythonEvalScriptPerFile() ||
-      m_commandLineParser->pythonEvalScript()) {
+  if (pipeline) {
+    parserInitialized = true;
+    if (!parsePipeline_()) return false;
+  } else if (parse) {
     parseinit_();
     createFileList_();
     createMultiProcess_();
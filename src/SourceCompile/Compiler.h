@@ -42,6 +42,7 @@ limitations under the License.
 namespace SURELOG {
 
 class PreprocessFile;
+class ThreadPool;
 
 class Compiler {
  public:
@@ -65,6 +66,8 @@ class Compiler {
   LibrarySet* getLibrarySet() { return m_librarySet; }
   Design* getDesign() { return m_design; }
   bool isLibraryFile(SymbolId id);
+  /* Worker threads shared by the parallel phases, -mt <nb> threads */
+  ThreadPool* getThreadPool();
 
 #ifdef USETBB
   tbb::task_group& getTaskGroup() { return m_taskGroup; }
@@ -78,6 +81,12 @@ class Compiler {
   bool createMultiProcess_();
   bool parseinit_();
   bool pythoninit_();
+  bool splitFile_(CompileSourceFile* compiler,
+                  std::vector<CompileSourceFile*>& jobs);
+  void registerSplitFile_(CompileSourceFile* compiler, bool isParent,
+                          std::vector<CompileSourceFile*>& jobs,
+                          std::vector<CompileSourceFile*>& compilers);
+  bool parsePipeline_();
   bool compileFileSet_(CompileSourceFile::Action action, bool allowMultithread,
                        std::vector<CompileSourceFile*>& container);
   bool compileOneFile_(CompileSourceFile* compileSource,
@@ -93,12 +102,12 @@ class Compiler {
   std::vector<CompileSourceFile*> m_compilersChunkFiles;
   std::vector<CompileSourceFile*> m_compilersParentFiles;
   std::vector<CompilationUnit*> m_compilationUnits;
-  std::vector<SymbolTable*> m_symbolTables;
   std::vector<ErrorContainer*> m_errorContainers;
   LibrarySet* m_librarySet;
   ConfigSet* m_configSet;
   Design* m_design;
   std::set<SymbolId> m_libraryFiles;  // -v <file>
+  ThreadPool* m_threadPool;
 
 #ifdef USETBB
   tbb::task_group m_taskGroup;
@@ -21,6 +21,7 @@
  * Created on May 2, 2017, 8:14 PM
  */
 
+#include <algorithm>
 #include <queue>
 #include <set>
 #include "SourceCompile/SymbolTable.h"
@@ -43,6 +44,7 @@ void LoopCheck::clear() {
     delete itr.second;
   }
   m_nodes.clear();
+  m_order.clear();
 }
 
 bool LoopCheck::addEdge(SymbolId from, SymbolId to) {
@@ -54,16 +56,20 @@ bool LoopCheck::addEdge(SymbolId from, SymbolId to) {
   if (fromIt == m_nodes.end()) {
     nodeFrom = new Node(from);
     m_nodes.insert(std::make_pair(from, nodeFrom));
+    m_order.push_back(nodeFrom);
   } else {
     nodeFrom = (*fromIt).second;
   }
   if (toIt == m_nodes.end()) {
     nodeTo = new Node(to);
     m_nodes.insert(std::make_pair(to, nodeTo));
+    m_order.push_back(nodeTo);
   } else {
     nodeTo = (*toIt).second;
   }
-  nodeFrom->m_toList.insert(nodeTo);
+  if (std::find(nodeFrom->m_toList.begin(), nodeFrom->m_toList.end(),
+                nodeTo) == nodeFrom->m_toList.end())
+    nodeFrom->m_toList.push_back(nodeTo);
 
   for (auto itr : m_nodes) {
     itr.second->m_visited = false;
@@ -91,9 +97,9 @@ bool LoopCheck::addEdge(SymbolId from, SymbolId to) {
 
 std::vector<SymbolId> LoopCheck::reportLoop() {
   std::vector<SymbolId> loop;
-  for (auto itr : m_nodes) {
-    if (itr.second->m_visited) {
-      loop.push_back(itr.first);
+  for (Node* node : m_order) {
+    if (node->m_visited) {
+      loop.push_back(node->m_objId);
     }
   }
   return loop;
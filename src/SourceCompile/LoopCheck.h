@@ -44,11 +44,14 @@ class LoopCheck {
    public:
     Node(SymbolId objId) : m_objId(objId), m_visited(false) {}
     SymbolId m_objId;
-    std::set<Node*> m_toList;
+    std::vector<Node*> m_toList;  // In insertion order
     bool m_visited;
   };
 
   std::map<SymbolId, Node*> m_nodes;
+  // The nodes in insertion order, the symbol ids depend on the threads
+  // and do not order the reported loop
+  std::vector<Node*> m_order;
 };
 
 };  // namespace SURELOG
@@ -127,15 +127,15 @@ ErrorContainer* ParseFile::getErrorContainer() {
   return m_errors ? m_errors : m_compileSourceFile->getErrorContainer();
 }
 
-SymbolId ParseFile::registerSymbol(const std::string symbol) {
+SymbolId ParseFile::registerSymbol(const std::string& symbol) {
   return getCompileSourceFile()->getSymbolTable()->registerSymbol(symbol);
 }
 
-SymbolId ParseFile::getId(const std::string symbol) {
+SymbolId ParseFile::getId(const std::string& symbol) {
   return getCompileSourceFile()->getSymbolTable()->getId(symbol);
 }
 
-const std::string ParseFile::getSymbol(SymbolId id) {
+const std::string& ParseFile::getSymbol(SymbolId id) {
   return getCompileSourceFile()->getSymbolTable()->getSymbol(id);
 }
 
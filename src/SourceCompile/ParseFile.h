@@ -87,9 +87,9 @@ class ParseFile {
   }
 
   void addError(Error& error);
-  SymbolId registerSymbol(const std::string symbol);
-  SymbolId getId(const std::string symbol);
-  const std::string getSymbol(SymbolId id);
+  SymbolId registerSymbol(const std::string& symbol);
+  SymbolId getId(const std::string& symbol);
+  const std::string& getSymbol(SymbolId id);
   bool usingCachedVersion() { return m_usingCachedVersion; }
   FileContent* getFileContent() { return m_fileContent; }
   void setFileContent(FileContent* content) { m_fileContent = content; }
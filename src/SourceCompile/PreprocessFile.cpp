@@ -258,7 +258,7 @@ void PreprocessFile::addError(Error& error) {
     getCompileSourceFile()->getErrorContainer()->addError(error);
 }
 
-const std::string PreprocessFile::getSymbol(SymbolId id) {
+const std::string& PreprocessFile::getSymbol(SymbolId id) {
   return getCompileSourceFile()->getSymbolTable()->getSymbol(id);
 }
 
@@ -620,11 +620,11 @@ void PreprocessFile::forgetPreprocessor_(PreprocessFile* inc,
   }
 }
 
-SymbolId PreprocessFile::registerSymbol(const std::string symbol) {
+SymbolId PreprocessFile::registerSymbol(const std::string& symbol) {
   return getCompileSourceFile()->getSymbolTable()->registerSymbol(symbol);
 }
 
-SymbolId PreprocessFile::getId(const std::string symbol) {
+SymbolId PreprocessFile::getId(const std::string& symbol) {
   return getCompileSourceFile()->getSymbolTable()->getId(symbol);
 }
 
@@ -650,6 +650,7 @@ std::string PreprocessFile::evaluateMacroInstance(
   } else {
     result = pp->getPreProcessedFileContent();
   }
+  for (auto& name : pp->getTestedMacros()) recordTestedMacro(name);
   forgetPreprocessor_(m_includer ? m_includer : callingFile, pp);
   delete pp;
   return result;
@@ -984,6 +985,7 @@ std::string PreprocessFile::getMacro(
     }
     instructions.print();
   }
+  recordTestedMacro(name);
   std::string result;
   bool found = false;
   // Try CommandLine overrides
@@ -1116,6 +1118,14 @@ void PreprocessFile::collectIncludedFiles(std::set<PreprocessFile*>& included) {
   }
 }
 
+void PreprocessFile::recordTestedMacro(const std::string& name) {
+  PreprocessFile* tmp = this;
+  while (tmp) {
+    tmp->m_testedMacros.insert(name);
+    tmp = tmp->m_includer;
+  }
+}
+
 void PreprocessFile::saveCache() {
    if (getCompileSourceFile()->getCommandLineParser()->parseOnly())
     return;
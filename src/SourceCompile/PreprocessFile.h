@@ -287,9 +287,9 @@ class PreprocessFile {
   void addError(Error& error);
 
   /* Shorthands for symbol manipulations */
-  SymbolId registerSymbol(const std::string symbol);
-  SymbolId getId(const std::string symbol);
-  const std::string getSymbol(SymbolId id);
+  SymbolId registerSymbol(const std::string& symbol);
+  SymbolId getId(const std::string& symbol);
+  const std::string& getSymbol(SymbolId id);
 
   // For recursive macro definition detection
   PreprocessFile* getSourceFile();
@@ -307,6 +307,10 @@ class PreprocessFile {
   bool usingCachedVersion() { return m_usingCachedVersion; }
   std::string getProfileInfo() { return m_profileInfo; }
   std::vector<LineTranslationInfo>& getLineTranslationInfo() { return m_lineTranslationVec; }
+  /* Macros whose definition state was queried (`ifdef, `ifndef, `elsif,
+     `MACRO), recorded up the includer chain. They key the cache variants */
+  void recordTestedMacro(const std::string& name);
+  const std::set<std::string>& getTestedMacros() { return m_testedMacros; }
  private:
   std::pair<bool, std::string> evaluateMacro_(
       const std::string name, std::vector<std::string>& arguments,
@@ -335,6 +339,7 @@ class PreprocessFile {
   std::string m_profileInfo;
   FileContent* m_fileContent;
   VerilogVersion m_verilogVersion;
+  std::set<std::string> m_testedMacros;
 };
 
 };  // namespace SURELOG
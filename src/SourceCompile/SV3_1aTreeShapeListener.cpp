@@ -730,8 +730,30 @@ void SV3_1aTreeShapeListener::exitProgram_declaration(SV3_1aParser::Program_decl
   addVObject (ctx, VObjectType::slProgram_declaration); 
 }
  
+// A "pkg::" scope leaves no node, its package is recorded on the file
+// content for the package compile order (see CompileDesign::packageLevels_)
+static std::string scopePackageName(const std::string& text) {
+  size_t pos = text.find("::");
+  if (pos == std::string::npos || pos == 0) return "";
+  std::string name = text.substr(0, pos);
+  if (name == "$unit") return "";
+  return name;
+}
+
 void SV3_1aTreeShapeListener::exitPackage_scope(
-    SV3_1aParser::Package_scopeContext *ctx) {}
+    SV3_1aParser::Package_scopeContext *ctx) {
+  std::string name = scopePackageName(ctx->getText());
+  if (!name.empty() && m_fileContent)
+    m_fileContent->addPackageScope(registerSymbol(name));
+}
+
+void SV3_1aTreeShapeListener::exitPs_identifier(
+    SV3_1aParser::Ps_identifierContext *ctx) {
+  std::string name = scopePackageName(ctx->getText());
+  if (!name.empty() && m_fileContent)
+    m_fileContent->addPackageScope(registerSymbol(name));
+  addVObject(ctx, VObjectType::slPs_identifier);
+}
 
 void SV3_1aTreeShapeListener::enterUnconnected_drive_directive(
     SV3_1aParser::Unconnected_drive_directiveContext *ctx) {}
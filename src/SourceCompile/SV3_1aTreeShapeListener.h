@@ -1711,7 +1711,7 @@ namespace SURELOG {
    void enterPackage_scope(SV3_1aParser::Package_scopeContext * /*ctx*/) final { }
    void exitPackage_scope(SV3_1aParser::Package_scopeContext * /*ctx*/) final ;
    void enterPs_identifier(SV3_1aParser::Ps_identifierContext * /*ctx*/) final { }
-   void exitPs_identifier(SV3_1aParser::Ps_identifierContext * ctx) final { addVObject (ctx, VObjectType::slPs_identifier); }
+   void exitPs_identifier(SV3_1aParser::Ps_identifierContext * ctx) final ;
    void enterPs_or_hierarchical_identifier(SV3_1aParser::Ps_or_hierarchical_identifierContext * /*ctx*/) final { }
    void exitPs_or_hierarchical_identifier(SV3_1aParser::Ps_or_hierarchical_identifierContext * ctx) final { addVObject (ctx, VObjectType::slPs_or_hierarchical_identifier); }
    void enterPs_or_hierarchical_array_identifier(SV3_1aParser::Ps_or_hierarchical_array_identifierContext * /*ctx*/) final { }
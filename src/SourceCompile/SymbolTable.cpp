@@ -31,41 +31,130 @@ std::string SymbolTable::m_badSymbol("@@BAD_SYMBOL@@");
 std::string SymbolTable::m_emptyMacroMarker("@@EMPTY_MACRO@@");
 SymbolId SymbolTable::m_badId = 0;
 
-SymbolTable::SymbolTable() : m_idCounter(1) {
-  m_id2SymbolMap.push_back(m_badSymbol);
-  m_symbol2IdMap.insert(std::make_pair(m_badSymbol, 0));
+SymbolTable::SymbolTable() : m_idCounter(0) {
+  for (unsigned int i = 0; i < MaxChunks; i++) m_chunks[i] = NULL;
+  insert_(m_badSymbol);
 }
 
-SymbolTable::~SymbolTable() {}
-
-SymbolId SymbolTable::registerSymbol(const std::string symbol) {
-  std::unordered_map<std::string, SymbolId>::iterator itr =
-      m_symbol2IdMap.find(symbol);
-  if (itr == m_symbol2IdMap.end()) {
-    m_symbol2IdMap.insert(std::make_pair(symbol, m_idCounter));
-    m_id2SymbolMap.push_back(symbol);
-    m_idCounter++;
-    SymbolId tmp = m_idCounter - 1;
-    return (tmp);
-  } else {
-    SymbolId tmp = (*itr).second;
-    return tmp;
+SymbolTable::SymbolTable(const SymbolTable& orig) : m_idCounter(0) {
+  for (unsigned int i = 0; i < MaxChunks; i++) m_chunks[i] = NULL;
+  SymbolTable& from = const_cast<SymbolTable&>(orig);
+  SymbolId size = from.size();
+  for (SymbolId id = 0; id < size; id++) insert_(from.getSymbol(id));
+}
+
+SymbolTable::~SymbolTable() {
+  for (unsigned int i = 0; i < MaxChunks; i++) delete[] m_chunks[i].load();
+  for (unsigned int i = 0; i < NbShards; i++) {
+    delete m_shards[i].m_table.load();
+    for (Table* table : m_shards[i].m_retired) delete table;
+  }
+}
+
+SymbolTable::Slot* SymbolTable::getSlot_(SymbolId id, bool allocate) {
+  // Chunk k covers ids [FirstChunkSize * (2^k - 1), FirstChunkSize * (2^(k+1) - 1))
+  uint64_t index = id + FirstChunkSize;
+  unsigned int chunk = 63 - __builtin_clzll(index) - FirstChunkBits;
+  if (chunk >= MaxChunks) return NULL;
+  Slot* slots = m_chunks[chunk].load(std::memory_order_acquire);
+  if (slots == NULL) {
+    if (!allocate) return NULL;
+    Slot* newSlots = new Slot[((uint64_t)FirstChunkSize) << chunk];
+    if (m_chunks[chunk].compare_exchange_strong(slots, newSlots,
+                                                std::memory_order_acq_rel)) {
+      slots = newSlots;
+    } else {
+      // Another thread allocated the chunk first
+      delete[] newSlots;
+    }
   }
+  return &slots[index - (((uint64_t)FirstChunkSize) << chunk)];
 }
 
-SymbolId SymbolTable::getId(const std::string symbol) {
-  std::unordered_map<std::string, SymbolId>::iterator itr =
-      m_symbol2IdMap.find(symbol);
-  if (itr == m_symbol2IdMap.end()) {
-    return 0;
-  } else {
-    SymbolId tmp = (*itr).second;
-    return tmp;
+SymbolId SymbolTable::find_(const Table* table, size_t hash,
+                            const std::string& symbol) {
+  if (table == NULL) return 0;
+  for (uint64_t i = (hash / NbShards) & table->m_mask;;
+       i = (i + 1) & table->m_mask) {
+    SymbolId entry = table->m_ids[i].load(std::memory_order_acquire);
+    if (entry == 0) return 0;
+    // The slot is ready, it was written before the entry was released
+    if (getSlot_(entry - 1, false)->m_symbol == symbol) return entry;
   }
 }
 
-const std::string SymbolTable::getSymbol(SymbolId id) {
-  if (id >= m_id2SymbolMap.size())
-    return "@@BAD_SYMBOL@@";
-  return m_id2SymbolMap[id];
+void SymbolTable::index_(Table* table, size_t hash, SymbolId id) {
+  uint64_t i = (hash / NbShards) & table->m_mask;
+  while (table->m_ids[i].load(std::memory_order_relaxed) != 0)
+    i = (i + 1) & table->m_mask;
+  table->m_ids[i].store(id + 1, std::memory_order_release);
+}
+
+SymbolId SymbolTable::insert_(const std::string& symbol) {
+  size_t hash = std::hash<std::string>()(symbol);
+  Shard& shard = m_shards[hash % NbShards];
+  SymbolId entry =
+      find_(shard.m_table.load(std::memory_order_acquire), hash, symbol);
+  if (entry) return entry - 1;
+  shard.m_mutex.lock();
+  Table* table = shard.m_table.load(std::memory_order_relaxed);
+  entry = find_(table, hash, symbol);
+  if (entry) {
+    shard.m_mutex.unlock();
+    return entry - 1;
+  }
+  if (table == NULL || (shard.m_count + 1) * 2 > table->m_mask + 1) {
+    // Grow into a new table, readers still probing the old one finish there
+    Table* grown =
+        new Table(table ? (table->m_mask + 1) * 2 : (uint64_t)FirstTableSize);
+    if (table) {
+      for (uint64_t i = 0; i <= table->m_mask; i++) {
+        SymbolId old = table->m_ids[i].load(std::memory_order_relaxed);
+        if (old == 0) continue;
+        const std::string& oldSymbol = getSlot_(old - 1, false)->m_symbol;
+        index_(grown, std::hash<std::string>()(oldSymbol), old - 1);
+      }
+      shard.m_retired.push_back(table);
+    }
+    shard.m_table.store(grown, std::memory_order_release);
+    table = grown;
+  }
+  SymbolId tmp = m_idCounter.fetch_add(1);
+  // The slot is published before the id can be found or read back
+  Slot* slot = getSlot_(tmp, true);
+  slot->m_symbol = symbol;
+  slot->m_ready.store(true, std::memory_order_release);
+  index_(table, hash, tmp);
+  shard.m_count++;
+  shard.m_mutex.unlock();
+  return tmp;
+}
+
+SymbolId SymbolTable::registerSymbol(const std::string& symbol) {
+  return insert_(symbol);
+}
+
+SymbolId SymbolTable::getId(const std::string& symbol) {
+  size_t hash = std::hash<std::string>()(symbol);
+  Shard& shard = m_shards[hash % NbShards];
+  SymbolId entry =
+      find_(shard.m_table.load(std::memory_order_acquire), hash, symbol);
+  return entry ? entry - 1 : 0;
+}
+
+const std::string& SymbolTable::getSymbol(SymbolId id) {
+  if (id >= m_idCounter.load()) return m_badSymbol;
+  Slot* slot = getSlot_(id, false);
+  // An id handed out but not yet written reads as the bad symbol
+  if (slot == NULL || !slot->m_ready.load(std::memory_order_acquire))
+    return m_badSymbol;
+  return slot->m_symbol;
+}
+
+std::vector<std::string> SymbolTable::getSymbols() {
+  std::vector<std::string> symbols;
+  SymbolId size = m_idCounter.load();
+  symbols.reserve(size);
+  for (SymbolId id = 0; id < size; id++) symbols.push_back(getSymbol(id));
+  return symbols;
 }
@@ -26,7 +26,9 @@
 
 #include <stdint.h>
 
+#include <atomic>
 #include <map>
+#include <mutex>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -39,25 +41,81 @@ typedef uint32_t NodeId;
 
 static constexpr NodeId InvalidNodeId = 969696;
 
+/* Symbol interner shared by all the compilation threads.
+   Inserts lock one of NbShards shards selected by the symbol hash, ids are
+   handed out by an atomic counter and never change.
+   Symbols are stored in chunks that never move (chunk k holds
+   FirstChunkSize << k symbols), a slot is flagged ready once written.
+   Each shard indexes its ids in an open addressing table that is only
+   replaced, never modified in place past a published id, so getId and
+   getSymbol take no lock.
+   Under -mt the id of a symbol depends on the order the threads register
+   them: ids are only compared for equality, nothing ordered by id may reach
+   a message, a dump or a cache (the caches store their own symbol tables). */
 class SymbolTable {
  public:
   SymbolTable();
-  // SymbolTable(const SymbolTable& orig);
+  SymbolTable(const SymbolTable& orig);
 
-  SymbolId registerSymbol(const std::string symbol);
-  SymbolId getId(const std::string symbol);
-  const std::string getSymbol(SymbolId id);
-  const std::string getBadSymbol() { return m_badSymbol; }
+  SymbolId registerSymbol(const std::string& symbol);
+  SymbolId getId(const std::string& symbol);
+  /* The returned reference stays valid for the lifetime of the table */
+  const std::string& getSymbol(SymbolId id);
+  const std::string& getBadSymbol() { return m_badSymbol; }
   SymbolId getBadId() const { return m_badId; }
   virtual ~SymbolTable();
 
-  static const std::string getEmptyMacroMarker() { return m_emptyMacroMarker; }
-  std::vector<std::string>& getSymbols() { return m_id2SymbolMap; }
+  static const std::string& getEmptyMacroMarker() {
+    return m_emptyMacroMarker;
+  }
+  /* Number of ids handed out so far */
+  SymbolId size() const { return m_idCounter.load(); }
+  /* Copy of the symbols in id order, not to be used while inserting */
+  std::vector<std::string> getSymbols();
 
  private:
-  SymbolId m_idCounter;
-  std::vector<std::string> m_id2SymbolMap;
-  std::unordered_map<std::string, SymbolId> m_symbol2IdMap;
+  static const unsigned int NbShards = 64;
+  static const unsigned int FirstChunkBits = 8;
+  static const unsigned int FirstChunkSize = 1 << FirstChunkBits;
+  static const unsigned int MaxChunks = 40;
+  static const unsigned int FirstTableSize = 64;
+
+  class Slot {
+   public:
+    Slot() : m_ready(false) {}
+    std::string m_symbol;
+    std::atomic<bool> m_ready;  // Released once m_symbol is written
+  };
+
+  /* Holds id + 1 per entry, 0 marks a free entry */
+  class Table {
+   public:
+    Table(uint64_t size)
+        : m_mask(size - 1), m_ids(new std::atomic<SymbolId>[size]) {
+      for (uint64_t i = 0; i < size; i++) m_ids[i].store(0);
+    }
+    ~Table() { delete[] m_ids; }
+    uint64_t m_mask;
+    std::atomic<SymbolId>* m_ids;
+  };
+
+  class Shard {
+   public:
+    Shard() : m_table(NULL), m_count(0) {}
+    std::mutex m_mutex;  // Serializes the inserts
+    std::atomic<Table*> m_table;
+    uint64_t m_count;
+    std::vector<Table*> m_retired;  // Replaced, readers might still probe them
+  };
+
+  Slot* getSlot_(SymbolId id, bool allocate);
+  SymbolId find_(const Table* table, size_t hash, const std::string& symbol);
+  void index_(Table* table, size_t hash, SymbolId id);
+  SymbolId insert_(const std::string& symbol);
+
+  std::atomic<SymbolId> m_idCounter;
+  std::atomic<Slot*> m_chunks[MaxChunks];
+  Shard m_shards[NbShards];
   static std::string m_badSymbol;
   static SymbolId m_badId;
   static std::string m_emptyMacroMarker;
@@ -0,0 +1,107 @@
+/*
+ Copyright 2026 The Surelog contributors
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+/*
+ * File:   SymbolTable_test.cpp
+ *
+ * Created on October 19, 2026
+ */
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "SourceCompile/SymbolTable.h"
+#include "gtest/gtest.h"
+
+using SURELOG::SymbolId;
+using SURELOG::SymbolTable;
+
+namespace {
+
+const unsigned int NbThreads = 8;
+const unsigned int NbSymbols = 1 << 14;  // Odd strides visit them all
+
+std::string symbolName(unsigned int i) { return "sym_" + std::to_string(i); }
+
+}  // namespace
+
+TEST(SymbolTableTest, BadSymbolIsIdZero) {
+  SymbolTable symbols;
+  EXPECT_EQ(symbols.getBadId(), 0u);
+  EXPECT_EQ(symbols.getSymbol(0), symbols.getBadSymbol());
+  EXPECT_EQ(symbols.getId("unknown"), 0u);
+  EXPECT_EQ(symbols.getSymbol(symbols.size()), symbols.getBadSymbol());
+}
+
+TEST(SymbolTableTest, RegisterIsIdempotent) {
+  SymbolTable symbols;
+  SymbolId a = symbols.registerSymbol("a");
+  SymbolId b = symbols.registerSymbol("b");
+  EXPECT_NE(a, b);
+  EXPECT_EQ(symbols.registerSymbol("a"), a);
+  EXPECT_EQ(symbols.getId("b"), b);
+  EXPECT_EQ(symbols.getSymbol(a), "a");
+  EXPECT_EQ(symbols.size(), 3u);
+}
+
+TEST(SymbolTableTest, CopyKeepsIds) {
+  SymbolTable symbols;
+  for (unsigned int i = 0; i < 1000; i++) symbols.registerSymbol(symbolName(i));
+  SymbolTable copy(symbols);
+  EXPECT_EQ(copy.size(), symbols.size());
+  for (unsigned int i = 0; i < 1000; i++)
+    EXPECT_EQ(copy.getId(symbolName(i)), symbols.getId(symbolName(i)));
+}
+
+// All the threads intern overlapping symbols while reading back what they
+// and the others registered: every symbol gets exactly one id and every id
+// handed out reads back its symbol.
+TEST(SymbolTableTest, ConcurrentInterning) {
+  SymbolTable symbols;
+  std::vector<std::vector<SymbolId>> ids(NbThreads);
+  std::vector<unsigned int> mismatches(NbThreads, 0);
+  std::vector<std::thread> threads;
+  for (unsigned int t = 0; t < NbThreads; t++) {
+    threads.push_back(std::thread([&symbols, &ids, &mismatches, t]() {
+      ids[t].resize(NbSymbols);
+      for (unsigned int n = 0; n < NbSymbols; n++) {
+        // Each thread walks the symbols in its own order
+        unsigned int i = (n * (2 * t + 1) + t * 977) % NbSymbols;
+        SymbolId id = symbols.registerSymbol(symbolName(i));
+        ids[t][i] = id;
+        if (symbols.getSymbol(id) != symbolName(i)) mismatches[t]++;
+        SymbolId found = symbols.getId(symbolName(i));
+        if (found != id) mismatches[t]++;
+        // Ids handed out to other threads read either their symbol or,
+        // when not yet written, the bad symbol
+        const std::string& other = symbols.getSymbol(symbols.size() - 1);
+        if (other.empty()) mismatches[t]++;
+      }
+    }));
+  }
+  for (std::thread& thread : threads) thread.join();
+
+  for (unsigned int t = 0; t < NbThreads; t++) EXPECT_EQ(mismatches[t], 0u);
+  EXPECT_EQ(symbols.size(), (SymbolId)NbSymbols + 1);
+  for (unsigned int i = 0; i < NbSymbols; i++) {
+    for (unsigned int t = 1; t < NbThreads; t++)
+      ASSERT_EQ(ids[t][i], ids[0][i]) << symbolName(i);
+    EXPECT_EQ(symbols.getSymbol(ids[0][i]), symbolName(i));
+  }
+  std::vector<std::string> all = symbols.getSymbols();
+  EXPECT_EQ(all.size(), (size_t)NbSymbols + 1);
+}
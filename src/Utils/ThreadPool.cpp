@@ -0,0 +1,118 @@
+/*
+ Copyright 2026 The Surelog contributors
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+/*
+ * File:   ThreadPool.cpp
+ *
+ * Created on October 19, 2026
+ */
+#include "Utils/ThreadPool.h"
+
+using namespace SURELOG;
+
+ThreadPool::ThreadPool(unsigned int nbThreads)
+    : m_nextWorker(0), m_queued(0), m_pending(0), m_stop(false) {
+  for (unsigned int i = 0; i < nbThreads; i++) {
+    Worker* worker = new Worker();
+    worker->m_thread = NULL;
+    m_workers.push_back(worker);
+  }
+  for (unsigned int i = 0; i < nbThreads; i++) {
+    m_workers[i]->m_thread = new std::thread([this, i] { run_(i); });
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  std::unique_lock<std::mutex> lock(m_mutex);
+  m_stop = true;
+  lock.unlock();
+  m_jobAvailable.notify_all();
+  // Idle workers may still look into the other queues, join them all first
+  for (Worker* worker : m_workers) worker->m_thread->join();
+  for (Worker* worker : m_workers) {
+    delete worker->m_thread;
+    delete worker;
+  }
+}
+
+void ThreadPool::addJob(const Job& job) {
+  if (m_workers.empty()) {
+    job(0);
+    return;
+  }
+  // Counted before it is published, a worker may pop and finish it at once
+  std::unique_lock<std::mutex> lock(m_mutex);
+  m_pending++;
+  m_queued++;
+  lock.unlock();
+  Worker* worker = m_workers[m_nextWorker++ % m_workers.size()];
+  worker->m_mutex.lock();
+  worker->m_jobs.push_back(job);
+  worker->m_mutex.unlock();
+  m_jobAvailable.notify_one();
+}
+
+void ThreadPool::wait() {
+  std::unique_lock<std::mutex> lock(m_mutex);
+  m_jobsDone.wait(lock, [this] { return m_pending == 0; });
+}
+
+bool ThreadPool::popJob_(unsigned int workerIndex, Job& job) {
+  // Own queue first, oldest job first
+  Worker* worker = m_workers[workerIndex];
+  worker->m_mutex.lock();
+  if (!worker->m_jobs.empty()) {
+    job = worker->m_jobs.front();
+    worker->m_jobs.pop_front();
+    worker->m_mutex.unlock();
+    m_queued--;
+    return true;
+  }
+  worker->m_mutex.unlock();
+  // Steal from the back of the other queues
+  unsigned int size = m_workers.size();
+  for (unsigned int i = 1; i < size; i++) {
+    Worker* victim = m_workers[(workerIndex + i) % size];
+    victim->m_mutex.lock();
+    if (!victim->m_jobs.empty()) {
+      job = victim->m_jobs.back();
+      victim->m_jobs.pop_back();
+      victim->m_mutex.unlock();
+      m_queued--;
+      return true;
+    }
+    victim->m_mutex.unlock();
+  }
+  return false;
+}
+
+void ThreadPool::run_(unsigned int workerIndex) {
+  while (true) {
+    Job job;
+    if (popJob_(workerIndex, job)) {
+      job(workerIndex);
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_pending--;
+      bool done = (m_pending == 0);
+      lock.unlock();
+      if (done) m_jobsDone.notify_all();
+      continue;
+    }
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_jobAvailable.wait(lock, [this] { return m_stop || m_queued > 0; });
+    if (m_stop && m_queued == 0) return;
+  }
+}
@@ -0,0 +1,82 @@
+/*
+ Copyright 2026 The Surelog contributors
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+/*
+ * File:   ThreadPool.h
+ *
+ * Created on October 19, 2026
+ */
+
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace SURELOG {
+
+/* Persistent pool of worker threads shared by all the parallel phases.
+   Each worker has its own job queue, jobs are dealt to the queues in turn and
+   an idle worker steals from the others, so a mis-estimated job does not
+   leave the other workers waiting. A job receives the index of the worker
+   running it, to pick its per thread context (error container...). */
+class ThreadPool {
+ public:
+  typedef std::function<void(unsigned int workerIndex)> Job;
+
+  ThreadPool(unsigned int nbThreads);
+  virtual ~ThreadPool();
+
+  unsigned int getNbThreads() { return m_workers.size(); }
+
+  /* Jobs are picked up roughly in the order they are added, add the biggest
+     first */
+  void addJob(const Job& job);
+
+  /* Blocks until all the added jobs are done. Must not be called from a
+     job: the job counts as pending, the call would never return */
+  void wait();
+
+ private:
+  ThreadPool(const ThreadPool& orig);
+
+  struct Worker {
+    std::deque<Job> m_jobs;
+    std::mutex m_mutex;
+    std::thread* m_thread;
+  };
+
+  void run_(unsigned int workerIndex);
+  bool popJob_(unsigned int workerIndex, Job& job);
+
+  std::vector<Worker*> m_workers;
+  std::atomic<unsigned int> m_nextWorker;
+  std::atomic<unsigned int> m_queued;
+  unsigned int m_pending;  // Queued and running jobs
+  bool m_stop;
+  std::mutex m_mutex;
+  std::condition_variable m_jobAvailable;
+  std::condition_variable m_jobsDone;
+};
+
+};  // namespace SURELOG
+
+#endif /* THREADPOOL_H */
@@ -0,0 +1,65 @@
+/*
+ Copyright 2026 The Surelog contributors
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+/*
+ * File:   ThreadPool_test.cpp
+ *
+ * Created on October 19, 2026
+ */
+
+#include <atomic>
+#include <vector>
+
+#include "Utils/ThreadPool.h"
+#include "gtest/gtest.h"
+
+using SURELOG::ThreadPool;
+
+// wait() returns only once every job added before it ran, including jobs
+// the workers pick up while they are still being added
+TEST(ThreadPoolTest, WaitCoversAllJobs) {
+  ThreadPool pool(4);
+  for (unsigned int round = 0; round < 200; round++) {
+    std::atomic<unsigned int> done(0);
+    for (unsigned int i = 0; i < 50; i++)
+      pool.addJob([&done](unsigned int) { done++; });
+    pool.wait();
+    ASSERT_EQ(done.load(), 50u) << "round " << round;
+  }
+}
+
+TEST(ThreadPoolTest, JobsGetTheirWorkerIndex) {
+  ThreadPool pool(3);
+  std::vector<std::atomic<unsigned int>> perWorker(3);
+  for (auto& count : perWorker) count = 0;
+  for (unsigned int i = 0; i < 300; i++)
+    pool.addJob([&perWorker](unsigned int worker) { perWorker[worker]++; });
+  pool.wait();
+  unsigned int total = 0;
+  for (auto& count : perWorker) total += count;
+  EXPECT_EQ(total, 300u);
+}
+
+TEST(ThreadPoolTest, NoWorkerRunsInline) {
+  ThreadPool pool(0);
+  unsigned int done = 0;
+  pool.addJob([&done](unsigned int worker) {
+    EXPECT_EQ(worker, 0u);
+    done++;
+  });
+  pool.wait();
+  EXPECT_EQ(done, 1u);
+}
@@ -0,0 +1,35 @@
+#!/bin/bash
+# Defparams on the declaring instance, on a sibling, on a sub-instance and
+# on an ancestor elaborated before the declaring instance (elaborated
+# again) all apply. The instance tree is compared with a baseline, the
+# undefined modules have to be reported in depth first order (the order of
+# the recursive elaboration) although the levels are elaborated in turn.
+. "$(dirname "$0")/../common/test_lib.sh" "$1"
+
+# tree: the instance tree of -d inst, kind and path
+tree() {
+  sed -n 's/^\(\[[A-Z/]*\]\) .* \([^ ]*\)$/\1 \2/p' $1
+}
+
+# undefined: the undefined modules in the order they are reported
+undefined() {
+  grep "EL0500" $1 | grep -o "missing_[a-z]"
+}
+
+OPTIONS="top.v -parse -d inst -nocache"
+run_surelog serial.log $OPTIONS -mt 0
+run_surelog parallel.log $OPTIONS -mt 4
+for log in serial.log parallel.log; do
+  check "$log: the instance tree differs from the baseline" \
+    diff <(tree $log) tree.golden
+  check "$log: the undefined modules are not reported in depth first order" \
+    diff <(undefined $log) messages.golden
+  check_not "$log: an applied defparam is reported as unmatched" \
+    grep -q "EL0515" $log
+  check_not "$log: a defparam is reported twice on a parameter" \
+    grep -q "EL0517" $log
+done
+check_same messages serial.log parallel.log \
+  "The messages of the parallel elaboration differ from the serial one"
+
+summary
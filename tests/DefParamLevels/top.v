@@ -0,0 +1,44 @@
+module leaf();
+endmodule
+
+module c #(parameter R = 1) ();
+  for (genvar i = 0; i < R; i++) begin : gc
+    leaf u();
+  end
+  missing_c u_missing();
+endmodule
+
+module a #(parameter P = 1) ();
+  // Sets the parameter of this instance
+  defparam P = 4;
+  // Sets the parameter of a sibling of this instance
+  defparam top.u_b.Q = 3;
+  // Sets the parameter of a sub-instance
+  defparam u_c.R = 2;
+  for (genvar i = 0; i < P; i++) begin : ga
+    leaf u();
+  end
+  c u_c();
+endmodule
+
+module b #(parameter Q = 1) ();
+  for (genvar i = 0; i < Q; i++) begin : gb
+    leaf u();
+  end
+  missing_b u_missing();
+endmodule
+
+module d();
+  // Sets the parameter of an ancestor, elaborated before this instance
+  defparam top.N = 2;
+endmodule
+
+module top();
+  parameter N = 1;
+  a u_a();
+  b u_b();
+  for (genvar i = 0; i < N; i++) begin : gt
+    leaf u();
+  end
+  d u_d();
+endmodule
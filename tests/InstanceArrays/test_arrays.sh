@@ -0,0 +1,23 @@
+#!/bin/bash
+# Instance arrays are kept as ranges by the lazy elaboration, their elements
+# are created as the tree is walked: the lazily elaborated tree must be the
+# one of the full elaboration.
+. "$(dirname "$0")/../common/test_lib.sh" "$1"
+
+lazy_instances() {
+  grep "EL05[0-2][0-9]" $1
+}
+
+OPTIONS="top.v -parse -d inst -nocache"
+run_surelog full.log $OPTIONS
+run_surelog lazy.log $OPTIONS -lazyelab
+check "The full elaboration does not create the 1024 elements of mem" \
+  test $(grep -c '"work@top.mem[0-9]*"' full.log) -eq 1024
+check "The parameter override of wide is not applied" \
+  grep -q '"work@top.wide0.bits\[1\]"' full.log
+check "The defparam on tuned3 is not applied" \
+  grep -q '"work@top.tuned3.bits\[2\]"' full.log
+check_same lazy_instances full.log lazy.log \
+  "The lazy elaboration differs from the full one"
+
+summary
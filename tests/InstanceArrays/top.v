@@ -0,0 +1,24 @@
+module bitcell #(parameter W = 1) ();
+  for (genvar i = 0; i < W; i++) begin : bits
+  end
+endmodule
+
+module row #(parameter N = 4) ();
+  bitcell cells[N-1:0]();
+endmodule
+
+module top();
+  // Large array, kept as a range by the lazy elaboration
+  bitcell mem[1023:0]();
+  // Overridden parameters
+  bitcell #(.W(2)) wide[0:3]();
+  // Element with a defparam, elaborated apart
+  bitcell tuned[0:7]();
+  defparam tuned3.W = 3;
+  // Two dimensions
+  bitcell grid[0:1][0:2]();
+  // Arrays in generate loops and sub-instances
+  for (genvar r = 0; r < 2; r++) begin : rows
+    row #(.N(r + 2)) u();
+  end
+endmodule
@@ -0,0 +1,51 @@
+#!/bin/bash
+# Lazy elaboration: the paths given with -elabpath are found, from the top
+# level module name, and an unknown path is reported. The defparams of the
+# whole design apply to the instances elaborated on access: the parameters
+# and the UHDM are the ones of the full elaboration, and a subtree no
+# defparam needs is only elaborated when accessed.
+. "$(dirname "$0")/../common/test_lib.sh" "$1"
+
+# tree: the instance tree of -d inst, kind and path, in path order: the
+# elements of an array kept as a range follow the other children
+tree() {
+  sed -n 's/^\(\[[A-Z/]*\]\) .* \([^ ]*\)$/\1 \2/p' $1 | sort
+}
+
+# sorted_uhdm: the lines of the UHDM dump, in the same order
+sorted_uhdm() {
+  uhdm $1 | sort
+}
+
+OPTIONS="top.v -parse -nocache"
+run_surelog lazy.log $OPTIONS -lazyelab
+check "-lazyelab reports errors" test "$(summary_count lazy.log ERROR)" = "0"
+check_not "-lazyelab reports an undefined path" grep -q "EL0531" lazy.log
+check_not "-lazyelab elaborates a subtree that is not accessed" \
+  grep -q "missing_far" lazy.log
+
+for path in top top.u1 top.u1.g[3].u top.u_arr1 work@top.u_arr0; do
+  run_surelog path.log $OPTIONS -elabpath $path
+  check_not "-elabpath $path is not found" grep -q "EL0531" path.log
+done
+
+run_surelog paths.log $OPTIONS -elabpath top.u1 -elabpath top.u2
+check "-elabpath top.u2 is not reported as undefined" \
+  grep -q 'EL0531.*"top.u2"' paths.log
+check_not "-elabpath top.u1 is reported as undefined" \
+  grep -q 'EL0531.*"top.u1"' paths.log
+
+run_surelog far.log $OPTIONS -elabpath top.u_far
+check "-elabpath top.u_far does not elaborate its subtree" \
+  grep -q "missing_far" far.log
+
+run_surelog full.log $OPTIONS -d inst -d uhdm
+run_surelog lazy_dump.log $OPTIONS -d inst -d uhdm -lazyelab
+check "A defparam is not applied by the full elaboration" \
+  grep -q "work@top.u1.g\[3\].u$" full.log
+check_same tree full.log lazy_dump.log \
+  "The lazy instance tree differs from the full elaboration"
+check_same sorted_uhdm full.log lazy_dump.log \
+  "The lazy UHDM differs from the full elaboration"
+
+summary
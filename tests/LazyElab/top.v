@@ -0,0 +1,29 @@
+module leaf();
+endmodule
+
+module m #(parameter P = 2) ();
+  for (genvar i = 0; i < P; i++) begin : g
+    leaf u();
+  end
+endmodule
+
+module far();
+  missing_far u_missing();
+endmodule
+
+// Sets parameters of instances elaborated on access
+module setter();
+  defparam top.u1.P = 4;
+  defparam top.u_arr1.P = 1;
+endmodule
+
+module wrap();
+  setter u_set();
+endmodule
+
+module top();
+  m u1();
+  m #(.P(3)) u_arr[0:1]();
+  far u_far();
+  wrap u_wrap();
+endmodule
@@ -0,0 +1,43 @@
+interface bus_if;
+  logic [7:0] data;
+  logic valid;
+  logic ready;
+  modport src (output data, output valid, input ready);
+  modport dst (input data, input valid, output ready);
+endinterface
+
+module stage (bus_if.dst in, bus_if.src out);
+  logic [7:0] q;
+  assign out.data = q;
+  assign out.valid = in.valid;
+  assign in.ready = out.ready;
+  always_ff @(posedge in.valid) q <= in.data + 8'd1;
+endmodule
+
+module leaf (input wire a, input wire b, output wire y);
+  assign y = a ^ b;
+endmodule
+
+module lane #(parameter N = 4) (input wire [N-1:0] a, output wire [N-1:0] y);
+  wire [N-1:0] b;
+  assign b = ~a;
+  for (genvar i = 0; i < N; i++) begin : bits
+    leaf l(.a(a[i]), .b(b[i]), .y(y[i]));
+  end
+endmodule
+
+module dut (input wire [7:0] i, output wire [7:0] o, output wire rdy);
+  bus_if b0();
+  bus_if b1();
+  bus_if b2();
+  assign b0.data = i;
+  assign b0.valid = 1'b1;
+  assign b2.ready = 1'b1;
+  assign rdy = b0.ready;
+  stage s0(.in(b0), .out(b1));
+  stage s1(.in(b1), .out(b2));
+  wire [7:0] y0, y1;
+  lane #(.N(8)) l0(.a(b2.data), .y(y0));
+  lane #(.N(8)) l1(.a(y0), .y(y1));
+  leaf cells[7:0](.a(y1), .b(i), .y(o));
+endmodule
@@ -0,0 +1,17 @@
+#!/bin/bash
+# The netlists of the instances of a level are elaborated in parallel: the
+# UHDM dump must be the one of the single-threaded elaboration.
+. "$(dirname "$0")/../common/test_lib.sh" "$1"
+
+OPTIONS="dut.v -parse -d uhdm -nocache"
+run_surelog serial.log $OPTIONS -mt 0
+check "No UHDM dump" grep -q "cells" serial.log
+check "The port connections are not bound to their nets" \
+  grep -q "vpiActual" serial.log
+for run in 1 2 3; do
+  run_surelog parallel_$run.log $OPTIONS -mt 4
+  check_same uhdm serial.log parallel_$run.log \
+    "Parallel netlist elaboration $run differs from the serial one"
+done
+
+summary
@@ -0,0 +1,5 @@
+`ifdef WIDE
+`define NB_LEAVES 4
+`else
+`define NB_LEAVES 1
+`endif
@@ -0,0 +1,37 @@
+#!/bin/bash
+# Preprocessor cache variants keyed by the tested defines: alternating the
+# defines must restore the matching cache variant, the cached runs report
+# the same instances as the uncached ones, and once both variants exist no
+# run rewrites them.
+. "$(dirname "$0")/../common/test_lib.sh" "$1"
+
+# cache_files: the cache variants of top.v and of its include, with their
+# modification times
+cache_files() {
+  find slpp_all -name "top.v*.slpp" -o -name "cfg.vh*.slpp" | sort \
+    | xargs -r stat -c "%n %y"
+}
+
+run_surelog ref_wide.log top.v -parse -d inst -nocache -DWIDE
+run_surelog ref_narrow.log top.v -parse -d inst -nocache
+for pass in 1 2; do
+  for variant in wide narrow; do
+    defines=""
+    if [ $variant = wide ]; then defines="-DWIDE"; fi
+    run_surelog run_${variant}_$pass.log top.v -parse -d inst $defines
+    check_same instances ref_$variant.log run_${variant}_$pass.log \
+      "Cached run $pass with the $variant defines differs from the uncached run"
+  done
+  if [ $pass = 1 ]; then
+    cache_files > 1.cache
+    TEST_LOGS="$TEST_LOGS 1.cache"
+    check "top.v does not have its 2 cache variants" \
+      test $(grep -c "/top\.v\(\.1\)\?\.slpp" 1.cache) -eq 2
+    check "cfg.vh does not have its 2 cache variants" \
+      test $(grep -c "/cfg\.vh\(\.1\)\?\.slpp" 1.cache) -eq 2
+  fi
+done
+check "The second pass rewrote a cache variant instead of restoring it" \
+  diff 1.cache <(cache_files)
+
+summary
@@ -0,0 +1,21 @@
+`include "cfg.vh"
+
+module top();
+`ifdef WIDE
+  wide_mod u_wide();
+`else
+  narrow_mod u_narrow();
+`endif
+  leaf u_leaf();
+endmodule
+
+module wide_mod();
+  leaf u_leaf[`NB_LEAVES-1:0]();
+endmodule
+
+module narrow_mod();
+  leaf u_leaf();
+endmodule
+
+module leaf();
+endmodule
@@ -0,0 +1,17 @@
+package pa;
+  parameter int W = 3;
+endpackage
+
+package pb;
+  // Only a scoped reference links pb to pa
+  parameter int X = pa::W + 1;
+endpackage
+
+package pc;
+  typedef logic [pb::X-1:0] word_t;
+  parameter int Y = pb::X * 2;
+endpackage
+
+package pd;
+  parameter int Z = 5;
+endpackage
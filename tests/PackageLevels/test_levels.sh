@@ -0,0 +1,20 @@
+#!/bin/bash
+# Packages linked only by pkg:: scopes must not be compiled in the same
+# level: the parallel package compilation has to produce the same
+# parameter values, and so the same generated instances, as the serial one.
+. "$(dirname "$0")/../common/test_lib.sh" "$1"
+
+OPTIONS="pkgs.sv top.sv -parse -d inst -nocache"
+run_surelog serial.log $OPTIONS -mt 0
+# pc::Y is 8: pa::W + 1 doubled, pd::Z is 5
+check "Serial compilation does not generate the 8 instances of pc::Y" \
+  test $(grep -c '"work@top\.g\[[0-9]*\]\.u"' serial.log) -eq 8
+check "Serial compilation does not generate the 5 instances of pd::Z" \
+  test $(grep -c '"work@top\.h\[[0-9]*\]\.u"' serial.log) -eq 5
+for run in 1 2 3 4 5; do
+  run_surelog parallel_$run.log $OPTIONS -mt 4
+  check_same instances serial.log parallel_$run.log \
+    "Parallel package compilation $run differs from the serial one"
+done
+
+summary
@@ -0,0 +1,11 @@
+module leaf();
+endmodule
+
+module top();
+  for (genvar i = 0; i < pc::Y; i++) begin : g
+    leaf u();
+  end
+  for (genvar j = 0; j < pd::Z; j++) begin : h
+    leaf u();
+  end
+endmodule
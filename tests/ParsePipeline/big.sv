@@ -0,0 +1,63 @@
+module stage0(input logic clk, input cfg_pkg::word_t d, output cfg_pkg::word_t q);
+  cfg_pkg::word_t r;
+  always_ff @(posedge clk) begin
+    r <= d + 0;
+  end
+  assign q = r;
+endmodule
+
+module stage1(input logic clk, input cfg_pkg::word_t d, output cfg_pkg::word_t q);
+  cfg_pkg::word_t r;
+  always_ff @(posedge clk) begin
+    r <= d + 1;
+  end
+  assign q = r;
+endmodule
+
+module stage2(input logic clk, input cfg_pkg::word_t d, output cfg_pkg::word_t q);
+  cfg_pkg::word_t r;
+  always_ff @(posedge clk) begin
+    r <= d + 2;
+  end
+  assign q = r;
+endmodule
+
+module stage3(input logic clk, input cfg_pkg::word_t d, output cfg_pkg::word_t q);
+  cfg_pkg::word_t r;
+  always_ff @(posedge clk) begin
+    r <= d + 3;
+  end
+  assign q = r;
+endmodule
+
+module stage4(input logic clk, input cfg_pkg::word_t d, output cfg_pkg::word_t q);
+  cfg_pkg::word_t r;
+  always_ff @(posedge clk) begin
+    r <= d + 4;
+  end
+  assign q = r;
+endmodule
+
+module stage5(input logic clk, input cfg_pkg::word_t d, output cfg_pkg::word_t q);
+  cfg_pkg::word_t r;
+  always_ff @(posedge clk) begin
+    r <= d + 5;
+  end
+  assign q = r;
+endmodule
+
+module stage6(input logic clk, input cfg_pkg::word_t d, output cfg_pkg::word_t q);
+  cfg_pkg::word_t r;
+  always_ff @(posedge clk) begin
+    r <= d + 6;
+  end
+  assign q = r;
+endmodule
+
+module stage7(input logic clk, input cfg_pkg::word_t d, output cfg_pkg::word_t q);
+  cfg_pkg::word_t r;
+  always_ff @(posedge clk) begin
+    r <= d + 7;
+  end
+  assign q = r;
+endmodule
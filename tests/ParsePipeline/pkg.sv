@@ -0,0 +1,4 @@
+package cfg_pkg;
+  parameter int WIDTH = 8;
+  typedef logic [WIDTH-1:0] word_t;
+endpackage
@@ -0,0 +1,21 @@
+#!/bin/bash
+# The per file parse pipeline (-mt, in process) against the serial parse:
+# same messages in the same order, and the same instance tree, with files
+# split in chunks by -split.
+. "$(dirname "$0")/../common/test_lib.sh" "$1"
+
+OPTIONS="pkg.sv big.sv top.sv -parse -d inst -nocache -split 10"
+run_surelog serial.log $OPTIONS -mt 0
+check "The serial parse does not elaborate the 8 stages" \
+  test $(grep -c '"work@top\.u[0-7]"' serial.log) -eq 8
+check "The serial parse does not report the undefined module" \
+  grep -q "missing_mod" serial.log
+for run in 1 2 3; do
+  run_surelog pipeline_$run.log $OPTIONS -mt 4
+  check_same messages serial.log pipeline_$run.log \
+    "The messages of the pipelined parse $run differ from the serial parse"
+  check_same instances serial.log pipeline_$run.log \
+    "The instances of the pipelined parse $run differ from the serial parse"
+done
+
+summary
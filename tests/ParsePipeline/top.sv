@@ -0,0 +1,12 @@
+module top(input logic clk, input cfg_pkg::word_t d, output cfg_pkg::word_t q);
+  cfg_pkg::word_t s0, s1, s2, s3, s4, s5, s6;
+  stage0 u0(.clk(clk), .d(d),  .q(s0));
+  stage1 u1(.clk(clk), .d(s0), .q(s1));
+  stage2 u2(.clk(clk), .d(s1), .q(s2));
+  stage3 u3(.clk(clk), .d(s2), .q(s3));
+  stage4 u4(.clk(clk), .d(s3), .q(s4));
+  stage5 u5(.clk(clk), .d(s4), .q(s5));
+  stage6 u6(.clk(clk), .d(s5), .q(s6));
+  stage7 u7(.clk(clk), .d(s6), .q(q));
+  missing_mod u_missing();
+endmodule
@@ -0,0 +1,35 @@
+#!/bin/bash
+# Instances of a same module share their elaborated body only when their
+# parameters have the same values and types: each instance must get the
+# number of generated instances of its own parameters, in the parallel
+# elaboration as in the serial one, and the shared parameter values must
+# show in the UHDM of each instance.
+. "$(dirname "$0")/../common/test_lib.sh" "$1"
+
+# count <log> <scope prefix>: number of leaf instances generated in the scope
+count() {
+  grep "EL0523" $1 | grep -c "\"work@$2\[[0-9]*\]\.u\""
+}
+
+run_surelog serial.log top.v -parse -d inst -d uhdm -nocache -mt 0
+run_surelog bodies.log top.v -parse -d inst -d uhdm -nocache -mt 4
+# instance P Q
+for expected in "u0 2 3" "u1 3 4" "u2 2 3" "u3 2 3" "u4 1 2"; do
+  set -- $expected
+  check "top.$1 does not generate $2 instances" \
+    test $(count bodies.log top.$1.gm) -eq $2
+  check "top.$1.c does not generate $3 instances" \
+    test $(count bodies.log top.$1.c.gn) -eq $3
+done
+# instance W
+for expected in "t0 2" "t1 2" "t2 3"; do
+  set -- $expected
+  check "top.$1 does not generate $2 instances" \
+    test $(count bodies.log top.$1.gw) -eq $2
+done
+check_same instances serial.log bodies.log \
+  "The parallel elaboration differs from the serial one"
+check_same uhdm serial.log bodies.log \
+  "The parallel UHDM differs from the serial one"
+
+summary
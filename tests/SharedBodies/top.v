@@ -0,0 +1,34 @@
+module leaf();
+endmodule
+
+module n #(parameter Q = 1) ();
+  for (genvar i = 0; i < Q; i++) begin : gn
+    leaf u();
+  end
+endmodule
+
+module m #(parameter P = 2) ();
+  for (genvar i = 0; i < P; i++) begin : gm
+    leaf u();
+  end
+  n #(.Q(P + 1)) c();
+endmodule
+
+// The types do not show in the parameter values
+module t #(parameter type T = logic, parameter W = 2) ();
+  T x;
+  for (genvar i = 0; i < W; i++) begin : gw
+    leaf u();
+  end
+endmodule
+
+module top();
+  m u0();
+  m #(.P(3)) u1();
+  m u2();
+  m #(2) u3();
+  m #(.P(1)) u4();
+  t #(.T(logic [3:0])) t0();
+  t #(.T(logic [7:0])) t1();
+  t #(.T(logic [7:0]), .W(3)) t2();
+endmodule
@@ -0,0 +1,11 @@
+package p1;
+  parameter int A = 2;
+endpackage
+
+package p2;
+  parameter int B = p1::A + 3;
+endpackage
+
+package p3;
+  parameter int C = 4;
+endpackage
@@ -0,0 +1,21 @@
+#!/bin/bash
+# Symbol ids depend on the thread timing under -mt: nothing ordered by id
+# may reach the messages, the dumps or the caches. The caches written by a
+# parallel run are read back by a serial run, with other ids, and the
+# outputs are compared with an uncached serial run.
+. "$(dirname "$0")/../common/test_lib.sh" "$1"
+
+OPTIONS="pkg.sv top.sv -parse -d inst -d uhdm"
+run_surelog serial.log $OPTIONS -nocache -mt 0
+check "No recursive macro message" grep -q "PP0115" serial.log
+for run in 1 2 3; do
+  rm -rf slpp*
+  run_surelog write_$run.log $OPTIONS -mt 4
+  run_surelog read_$run.log $OPTIONS -mt 0
+  for log in write_$run.log read_$run.log; do
+    check_same messages serial.log $log "The messages of $log differ"
+    check_same uhdm serial.log $log "The UHDM dump of $log differs"
+  done
+done
+
+summary
@@ -0,0 +1,14 @@
+`define LOOP_A `LOOP_B
+`define LOOP_B `LOOP_C
+`define LOOP_C `LOOP_A
+
+module leaf #(parameter int P = 0) ();
+endmodule
+
+module top();
+  // Scopes named in an order unrelated to the symbol ids
+  leaf #(.P(p3::C)) u3();
+  leaf #(.P(p2::B)) u2();
+  leaf #(.P(p1::A)) u1();
+  parameter int L = `LOOP_A;
+endmodule
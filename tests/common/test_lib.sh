@@ -0,0 +1,85 @@
+# Shared by the scripted regression tests, the ./test_*.sh commands of the
+# .sl files. A test sources this file with the Surelog executable as
+# argument, runs Surelog with run_surelog, states its expectations with
+# check, check_not and check_same, and ends with summary. The failed
+# checks are counted as errors and the passed ones as notes: the .log of
+# the test holds the expected counts.
+
+SURELOG=$1
+NB_PASSED=0
+NB_FAILED=0
+TEST_LOGS=""
+rm -rf slpp*
+
+# run_surelog <log> <options>: runs Surelog, its output goes to <log>
+run_surelog() {
+  local log=$1
+  shift
+  TEST_LOGS="$TEST_LOGS $log"
+  $SURELOG "$@" > $log 2>&1
+}
+
+# Filters of a Surelog output for check_same
+messages() {
+  # Thread counts and timings legitimately differ
+  grep "^\[" $1 | grep -v -i "thread" | grep -v "[0-9]\.[0-9]*s"
+}
+
+instances() {
+  grep "EL0" $1
+}
+
+uhdm() {
+  sed -n '/^====== UHDM/,/^=====*$/p' $1
+}
+
+# summary_count <log> <severity>: count of a summary line of Surelog
+summary_count() {
+  grep "^\[ *$2\] :" $1 | sed 's/.*: *//'
+}
+
+pass_() {
+  NB_PASSED=$((NB_PASSED + 1))
+}
+
+fail_() {
+  NB_FAILED=$((NB_FAILED + 1))
+  echo "FAILED: $1"
+}
+
+# check <description> <command>: the command has to succeed
+check() {
+  local description=$1
+  shift
+  if "$@" > /dev/null 2>&1; then pass_; else fail_ "$description"; fi
+}
+
+# check_not <description> <command>: the command has to fail
+check_not() {
+  local description=$1
+  shift
+  if "$@" > /dev/null 2>&1; then fail_ "$description"; else pass_; fi
+}
+
+# check_same <filter> <reference log> <log> <description>: the filtered
+# outputs have to be identical. The first differences go to stderr, they
+# can hold summary lines of Surelog that the regression would count
+check_same() {
+  local differences
+  differences=$(diff <($1 $2) <($1 $3))
+  if [ -z "$differences" ] && [ -n "$($1 $2)" ]; then
+    pass_
+  else
+    fail_ "$4"
+    echo "$differences" | head -20 >&2
+  fi
+}
+
+summary() {
+  rm -rf slpp* $TEST_LOGS
+  echo "[  FATAL] : 0"
+  echo "[ SYNTAX] : 0"
+  echo "[  ERROR] : $NB_FAILED"
+  echo "[WARNING] : 0"
+  echo "[   NOTE] : $NB_PASSED"
+}